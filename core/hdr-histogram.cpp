@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2015,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hdr-histogram.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <limits>
+
+namespace ndn {
+namespace tools {
+
+HdrHistogram::HdrHistogram(uint64_t highestTrackableValue, int nSignificantDigits)
+  : m_highestTrackableValue(highestTrackableValue)
+{
+  if (highestTrackableValue < 2) {
+    throw std::invalid_argument("highestTrackableValue must be at least 2");
+  }
+  if (nSignificantDigits < 1 || nSignificantDigits > 5) {
+    throw std::invalid_argument("nSignificantDigits must be between 1 and 5");
+  }
+
+  // the sub-buckets of each bucket must resolve 10^nSignificantDigits distinct values
+  uint64_t largestSingleUnitResolution = 2 * static_cast<uint64_t>(std::pow(10, nSignificantDigits));
+  int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(largestSingleUnitResolution)));
+  m_subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+  uint64_t subBucketCount = uint64_t(1) << subBucketCountMagnitude;
+  m_subBucketHalfCount = subBucketCount / 2;
+  m_subBucketMask = subBucketCount - 1;
+
+  // each further bucket doubles the range of trackable values
+  uint64_t smallestUntrackableValue = subBucketCount;
+  size_t nBuckets = 1;
+  while (smallestUntrackableValue <= highestTrackableValue) {
+    if (smallestUntrackableValue > std::numeric_limits<uint64_t>::max() / 2) {
+      ++nBuckets;
+      break;
+    }
+    smallestUntrackableValue <<= 1;
+    ++nBuckets;
+  }
+
+  m_counts.resize((nBuckets + 1) * m_subBucketHalfCount);
+  reset();
+}
+
+void
+HdrHistogram::reset()
+{
+  std::fill(m_counts.begin(), m_counts.end(), 0);
+  m_totalCount = 0;
+  m_sum = 0;
+  m_min = std::numeric_limits<uint64_t>::max();
+  m_max = 0;
+}
+
+uint64_t
+HdrHistogram::getValueAtPercentile(double percentile) const
+{
+  if (m_totalCount == 0)
+    return 0;
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t countAtPercentile = static_cast<uint64_t>(percentile / 100 * m_totalCount + 0.5);
+  countAtPercentile = std::max<uint64_t>(countAtPercentile, 1);
+
+  uint64_t cumulativeCount = 0;
+  for (size_t i = 0; i < m_counts.size(); ++i) {
+    cumulativeCount += m_counts[i];
+    if (cumulativeCount >= countAtPercentile) {
+      // never report more than what was actually recorded
+      return std::min(getHighestEquivalentValue(i), m_max);
+    }
+  }
+
+  return m_max;
+}
+
+uint64_t
+HdrHistogram::getHighestEquivalentValue(size_t index) const
+{
+  int bucketIndex = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+  uint64_t subBucketIndex = (index & (m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+  if (bucketIndex < 0) {
+    subBucketIndex -= m_subBucketHalfCount;
+    bucketIndex = 0;
+  }
+
+  uint64_t lowestEquivalentValue = subBucketIndex << bucketIndex;
+  return lowestEquivalentValue + (uint64_t(1) << bucketIndex) - 1;
+}
+
+} // namespace tools
+} // namespace ndn
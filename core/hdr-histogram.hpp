@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2015,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_CORE_HDR_HISTOGRAM_HPP
+#define NDN_TOOLS_CORE_HDR_HISTOGRAM_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace tools {
+
+/** \brief high dynamic range histogram of non-negative integer values
+ *
+ *  The values are counted in buckets whose width grows with the magnitude of the values, so
+ *  that every value is represented with the requested number of significant decimal digits.
+ *  Recording a value takes constant time, and the memory is allocated once by the constructor:
+ *  about 27 KB for values up to 2^32 with 2 significant digits.
+ *
+ *  Values greater than the highest trackable value are counted as the highest trackable value.
+ */
+class HdrHistogram
+{
+public:
+  /** \param highestTrackableValue the highest value to track, at least 2
+   *  \param nSignificantDigits the precision of the recorded values, between 1 and 5
+   */
+  explicit
+  HdrHistogram(uint64_t highestTrackableValue, int nSignificantDigits = 2);
+
+  void
+  record(uint64_t value)
+  {
+    if (value > m_highestTrackableValue)
+      value = m_highestTrackableValue;
+
+    ++m_counts[getCountsIndex(value)];
+    ++m_totalCount;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+  }
+
+  /** \brief forget all the recorded values
+   */
+  void
+  reset();
+
+  uint64_t
+  getTotalCount() const
+  {
+    return m_totalCount;
+  }
+
+  /** \return the smallest recorded value, or 0 if the histogram is empty
+   */
+  uint64_t
+  getMin() const
+  {
+    return m_totalCount > 0 ? m_min : 0;
+  }
+
+  /** \return the largest recorded value, or 0 if the histogram is empty
+   */
+  uint64_t
+  getMax() const
+  {
+    return m_max;
+  }
+
+  /** \return the mean of the recorded values, or 0 if the histogram is empty
+   */
+  double
+  getMean() const
+  {
+    return m_totalCount > 0 ? static_cast<double>(m_sum) / m_totalCount : 0;
+  }
+
+  /** \return the highest value equivalent to the value below which \p percentile percent of the
+   *          recorded values fall, or 0 if the histogram is empty
+   *  \param percentile between 0 and 100
+   */
+  uint64_t
+  getValueAtPercentile(double percentile) const;
+
+  /** \return the number of counters, which determines the memory footprint
+   */
+  size_t
+  getNCounters() const
+  {
+    return m_counts.size();
+  }
+
+private:
+  size_t
+  getCountsIndex(uint64_t value) const
+  {
+    // the bucket is the power of 2 range of the value, the sub-bucket its position in the range
+    int bucketIndex = 64 - countLeadingZeros(value | m_subBucketMask) - (m_subBucketHalfCountMagnitude + 1);
+    uint64_t subBucketIndex = value >> bucketIndex;
+    return (static_cast<size_t>(bucketIndex + 1) << m_subBucketHalfCountMagnitude) +
+           (subBucketIndex - m_subBucketHalfCount);
+  }
+
+  /** \return the highest value counted by the counter at \p index
+   */
+  uint64_t
+  getHighestEquivalentValue(size_t index) const;
+
+  static int
+  countLeadingZeros(uint64_t value)
+  {
+    return __builtin_clzll(value);
+  }
+
+private:
+  uint64_t m_highestTrackableValue;
+  int m_subBucketHalfCountMagnitude;
+  uint64_t m_subBucketHalfCount;
+  uint64_t m_subBucketMask;
+  std::vector<uint64_t> m_counts;
+  uint64_t m_totalCount;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+} // namespace tools
+} // namespace ndn
+
+#endif // NDN_TOOLS_CORE_HDR_HISTOGRAM_HPP
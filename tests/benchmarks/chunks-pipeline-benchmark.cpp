@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/discover-version-fixed.hpp"
+#include "tools/chunks/catchunks/pipeline-interests.hpp"
+#include "tools/chunks/putchunks/producer.hpp"
+
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/iostreams/device/null.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include <sys/resource.h>
+
+// every heap allocation of the process is counted, including the ones of the producer and of
+// the loopback link
+static std::atomic<uint64_t> g_nAllocations(0);
+
+void*
+operator new(std::size_t size)
+{
+  g_nAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+namespace ndn {
+namespace chunks {
+namespace benchmark {
+
+/**
+ * @brief one direction of the loopback link between the consumer and the producer faces
+ *
+ * The packets are delivered after the propagation delay plus the time to serialize them and
+ * the packets ahead of them at the bandwidth of the link, or dropped with the loss rate. They
+ * are never delivered from within the send of the other face.
+ */
+class LinkDirection : noncopyable
+{
+public:
+  /**
+   * @param bandwidth in bits per second, 0 = unlimited
+   */
+  LinkDirection(boost::asio::io_service& io, Scheduler& scheduler, util::DummyClientFace& to,
+                const time::nanoseconds& delay, double lossRate, double bandwidth,
+                std::mt19937& randomGen)
+    : m_io(io)
+    , m_scheduler(scheduler)
+    , m_to(to)
+    , m_delay(delay)
+    , m_loss(lossRate)
+    , m_bandwidth(bandwidth)
+    , m_randomGen(randomGen)
+    , m_busyUntil(time::steady_clock::now())
+    , m_nDropped(0)
+  {
+  }
+
+  template<typename Packet>
+  void
+  transmit(const Packet& packet)
+  {
+    if (m_loss(m_randomGen)) {
+      ++m_nDropped;
+      return;
+    }
+
+    time::nanoseconds wait = m_delay;
+    if (m_bandwidth > 0) {
+      auto now = time::steady_clock::now();
+      auto serialization = static_cast<int64_t>(packet.wireEncode().size() * 8 * 1e9 / m_bandwidth);
+      m_busyUntil = std::max(m_busyUntil, now) + time::nanoseconds(serialization);
+      wait += m_busyUntil - now;
+    }
+
+    util::DummyClientFace& to = m_to;
+    if (wait == time::nanoseconds::zero())
+      m_io.post([&to, packet] { to.receive(packet); });
+    else
+      m_scheduler.scheduleEvent(wait, [&to, packet] { to.receive(packet); });
+  }
+
+  uint64_t
+  getNDropped() const
+  {
+    return m_nDropped;
+  }
+
+private:
+  boost::asio::io_service& m_io;
+  Scheduler& m_scheduler;
+  util::DummyClientFace& m_to;
+  time::nanoseconds m_delay;
+  std::bernoulli_distribution m_loss;
+  double m_bandwidth;
+  std::mt19937& m_randomGen;
+  time::steady_clock::TimePoint m_busyUntil;
+  uint64_t m_nDropped;
+};
+
+static double
+getCpuTime()
+{
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static void
+printPercentiles(const std::string& title, const tools::HdrHistogram& histogram)
+{
+  std::cout << std::setw(16) << std::left << title << std::right
+            << "p50/p90/p99/p99.9/max = "
+            << histogram.getValueAtPercentile(50) / 1000.0 << "/"
+            << histogram.getValueAtPercentile(90) / 1000.0 << "/"
+            << histogram.getValueAtPercentile(99) / 1000.0 << "/"
+            << histogram.getValueAtPercentile(99.9) / 1000.0 << "/"
+            << histogram.getMax() / 1000.0 << " ms"
+            << " (" << histogram.getTotalCount() << " samples)" << std::endl;
+}
+
+static int
+main(int argc, char** argv)
+{
+  PipelineInterests::Options options;
+  options.startPipelineSize = 1;
+  options.maxPipelineSize = 256;
+  size_t contentSize = 20000000;
+  size_t segmentSize = 4400;
+  double delayMs = 0;
+  double lossRate = 0;
+  double bandwidthMbps = 0;
+  unsigned int seed = 1;
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",      "print this help message and exit")
+    ("size",        po::value<size_t>(&contentSize)->default_value(contentSize),
+                    "bytes of content to transfer")
+    ("segmentSize", po::value<size_t>(&segmentSize)->default_value(segmentSize),
+                    "maximum content size of a segment, in bytes")
+    ("delay",       po::value<double>(&delayMs)->default_value(delayMs),
+                    "one-way delay of the link, in milliseconds")
+    ("loss",        po::value<double>(&lossRate)->default_value(lossRate),
+                    "probability that a packet is dropped, in each direction")
+    ("bandwidth",   po::value<double>(&bandwidthMbps)->default_value(bandwidthMbps),
+                    "bandwidth of the link, in Mbit/s (0 = unlimited)")
+    ("seed",        po::value<unsigned int>(&seed)->default_value(seed),
+                    "seed of the random losses")
+    ("lifetime",    po::value<uint64_t>()->default_value(options.interestLifetime.count()),
+                    "lifetime of expressed Interests, in milliseconds (0 = from the RTO)")
+    ("pipelineStart", po::value<size_t>(&options.startPipelineSize)
+                        ->default_value(options.startPipelineSize),
+                      "initial size of the Interest pipeline")
+    ("pipelineMax", po::value<size_t>(&options.maxPipelineSize)
+                      ->default_value(options.maxPipelineSize),
+                    "maximum size of the Interest pipeline")
+    ("segmentTable", po::bool_switch(&options.useSegmentTable),
+                     "track the segments in a flat state table instead of one fetcher per pipe")
+    ("congestionControl", po::value<std::string>(&options.congestionControl)
+                            ->default_value(options.congestionControl),
+                          "congestion control of the Interest window: 'aimd', 'cubic' or 'bbr'")
+    ("pacing",      po::bool_switch(&options.usePacing),
+                    "space the Interests at the estimated bottleneck rate")
+    ("lossDetection", po::bool_switch(&options.useLossDetection),
+                      "detect the lost segments before the Interest lifetime expires "
+                      "(requires --segmentTable)")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "Transfers content from an in-process producer to PipelineInterests and Consumer "
+              << "over a loopback link, and reports the cost per segment.\n"
+              << visibleDesc;
+    return 0;
+  }
+
+  options.interestLifetime = time::milliseconds(vm["lifetime"].as<uint64_t>());
+
+  if (contentSize == 0 || segmentSize == 0) {
+    std::cerr << "ERROR: the content and segment sizes must be at least 1" << std::endl;
+    return 2;
+  }
+  if (lossRate < 0 || lossRate >= 1) {
+    std::cerr << "ERROR: loss must be between 0 and 1" << std::endl;
+    return 2;
+  }
+  if (options.startPipelineSize < 1 || options.maxPipelineSize < options.startPipelineSize) {
+    std::cerr << "ERROR: max pipeline size must be at least pipelineStart, which must be at least 1"
+              << std::endl;
+    return 2;
+  }
+  if (options.useLossDetection && !options.useSegmentTable) {
+    std::cerr << "ERROR: loss detection requires the segment table" << std::endl;
+    return 2;
+  }
+
+  try {
+    boost::asio::io_service io;
+    Scheduler scheduler(io);
+    KeyChain keyChain;
+    util::DummyClientFace producerFace(io, keyChain, {false, true});
+    util::DummyClientFace consumerFace(io, keyChain, {false, false});
+
+    std::mt19937 randomGen(seed);
+    auto delay = time::nanoseconds(static_cast<int64_t>(delayMs * 1000000));
+    LinkDirection uplink(io, scheduler, producerFace, delay, lossRate, bandwidthMbps * 1e6,
+                         randomGen);
+    LinkDirection downlink(io, scheduler, consumerFace, delay, lossRate, bandwidthMbps * 1e6,
+                           randomGen);
+    consumerFace.onSendInterest.connect([&uplink] (const Interest& interest) {
+      uplink.transmit(interest);
+    });
+    producerFace.onSendData.connect([&downlink] (const Data& data) {
+      downlink.transmit(data);
+    });
+
+    // the segments are signed before the transfer starts
+    Name prefix = Name("/ndn/chunks/benchmark").appendVersion(1);
+    std::istringstream content(std::string(contentSize, 'a'));
+    Producer producer(prefix, producerFace, keyChain, security::signingWithSha256(),
+                      time::seconds(10), segmentSize, false, false, content);
+    io.poll();
+    io.reset();
+
+    ValidatorNull validator;
+    boost::iostreams::stream<boost::iostreams::null_sink> output((boost::iostreams::null_sink()));
+    Consumer consumer(consumerFace, validator, false, output);
+    DiscoverVersionFixed discover(prefix, consumerFace, options);
+    PipelineInterests pipeline(consumerFace, options);
+
+    bool isComplete = false;
+    std::string failure;
+    consumer.setCompletionCallback([&] {
+      isComplete = true;
+      io.stop();
+    });
+    consumer.setFailureCallback([&] (const std::string& reason) {
+      failure = reason;
+      io.stop();
+    });
+
+    uint64_t nAllocationsBefore = g_nAllocations.load();
+    double cpuTimeBefore = getCpuTime();
+    auto startTime = time::steady_clock::now();
+
+    consumer.start(discover, pipeline);
+    io.run();
+
+    double elapsed = time::duration_cast<time::microseconds>(time::steady_clock::now() -
+                                                             startTime).count() / 1e6;
+    double cpuTime = getCpuTime() - cpuTimeBefore;
+    uint64_t nAllocations = g_nAllocations.load() - nAllocationsBefore;
+
+    if (!isComplete) {
+      std::cerr << "ERROR: " << (failure.empty() ? "the transfer did not complete" : failure)
+                << std::endl;
+      return 1;
+    }
+
+    uint64_t nSegments = (contentSize + segmentSize - 1) / segmentSize;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Segments        " << nSegments << " of " << segmentSize << " bytes, "
+              << uplink.getNDropped() << " Interests and " << downlink.getNDropped()
+              << " Data dropped\n"
+              << "Time            " << elapsed << " s\n"
+              << "Throughput      " << nSegments / elapsed << " segments/s, "
+              << contentSize * 8 / elapsed / 1e6 << " Mbit/s\n"
+              << "CPU time        " << cpuTime << " s, "
+              << cpuTime * 1e6 / nSegments << " us/segment\n"
+              << "Allocations     " << nAllocations << ", "
+              << static_cast<double>(nAllocations) / nSegments << " per segment\n";
+    printPercentiles("RTT", pipeline.rttHistogram);
+    printPercentiles("Retrieval time", pipeline.retrievalTimeHistogram);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace benchmark
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::benchmark::main(argc, argv);
+}
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/async-writer.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/**
+ * @brief stream buffer whose writes block until the test opens it
+ */
+class GatedStreamBuf : public std::streambuf
+{
+public:
+  void
+  open()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isOpen = true;
+    m_cv.notify_all();
+  }
+
+  std::string
+  getOutput()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_output;
+  }
+
+protected:
+  std::streamsize
+  xsputn(const char* s, std::streamsize n) NDN_CXX_DECL_OVERRIDE
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_isOpen; });
+    m_output.append(s, n);
+    return n;
+  }
+
+  int_type
+  overflow(int_type c) NDN_CXX_DECL_OVERRIDE
+  {
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::string m_output;
+  bool m_isOpen = false;
+};
+
+class AsyncWriterFixture
+{
+public:
+  AsyncWriterFixture()
+    : output(&outputBuf)
+    , nSpaceNotifications(0)
+  {
+  }
+
+  static Block
+  makeContent(const std::string& str)
+  {
+    return makeBinaryBlock(tlv::Content, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+  }
+
+  /**
+   * @brief process the events until @p isDone returns true, or a timeout
+   */
+  bool
+  waitUntil(const function<bool()>& isDone)
+  {
+    for (int i = 0; i < 5000 && !isDone(); ++i) {
+      io.poll();
+      io.reset();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return isDone();
+  }
+
+protected:
+  boost::asio::io_service io;
+  GatedStreamBuf outputBuf;
+  std::ostream output;
+  size_t nSpaceNotifications;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestAsyncWriter, AsyncWriterFixture)
+
+BOOST_AUTO_TEST_CASE(WriteInOrder)
+{
+  outputBuf.open();
+  AsyncWriter writer(io, output, 4, nullptr, nullptr);
+
+  for (int i = 0; i < 10; ++i) {
+    // the ring is smaller than the segments, wait for the writer to make room
+    BOOST_REQUIRE(waitUntil([&writer] { return writer.getNFree() > 0; }));
+    BOOST_REQUIRE(writer.push(makeContent(to_string(i))));
+  }
+  writer.close();
+
+  BOOST_CHECK_EQUAL(outputBuf.getOutput(), "0123456789");
+}
+
+BOOST_AUTO_TEST_CASE(FullRing)
+{
+  bool hasFailed = false;
+  AsyncWriter writer(io, output, 4, [this] { ++nSpaceNotifications; },
+                     [&hasFailed] (const std::string&) { hasFailed = true; });
+  BOOST_CHECK_EQUAL(writer.getCapacity(), 4);
+
+  // the writer is blocked on the first segment, which keeps its slot until it is written
+  for (int i = 0; i < 4; ++i)
+    BOOST_REQUIRE(writer.push(makeContent(to_string(i))));
+  BOOST_CHECK_EQUAL(writer.getNFree(), 0);
+  BOOST_CHECK(!writer.push(makeContent("4")));
+
+  writer.requestSpace();
+  io.poll();
+  io.reset();
+  BOOST_CHECK_EQUAL(nSpaceNotifications, 0);
+
+  outputBuf.open();
+  BOOST_REQUIRE(waitUntil([this] { return nSpaceNotifications > 0; }));
+  BOOST_CHECK_EQUAL(nSpaceNotifications, 1);
+  BOOST_CHECK_GE(writer.getNFree(), 2);
+
+  BOOST_REQUIRE(writer.push(makeContent("4")));
+  writer.close();
+
+  BOOST_CHECK_EQUAL(outputBuf.getOutput(), "01234");
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestAsyncWriter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/batch-fetcher.hpp"
+#include "tools/chunks/catchunks/discover-version-fixed.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <iterator>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class BatchFetcherFixture : public UnitTestTimeFixture
+{
+public:
+  BatchFetcherFixture()
+    : face(io)
+    , tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "BatchFetcherTest")
+    , nSegments(3)
+  {
+    boost::filesystem::create_directories(tmpPath);
+
+    options.isVerbose = false;
+    options.interestLifetime = time::seconds(1);
+    options.maxRetriesOnTimeoutOrNack = 3;
+    options.startPipelineSize = 2;
+    options.maxPipelineSize = 2;
+  }
+
+  ~BatchFetcherFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  unique_ptr<DiscoverVersion>
+  makeDiscover(const Name& prefix)
+  {
+    return make_unique<DiscoverVersionFixed>(prefix, face, options);
+  }
+
+protected:
+  shared_ptr<Data>
+  makeSegment(const Name& interestName)
+  {
+    auto data = makeData(interestName);
+    std::string content = interestName.getPrefix(-2).toUri() + to_string(interestName[-1].toSegment());
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    data->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+    return signData(data);
+  }
+
+  std::string
+  readFile(const std::string& path)
+  {
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  ValidatorNull validator;
+  PipelineInterestsOptions options;
+  boost::filesystem::path tmpPath;
+  uint64_t nSegments;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestBatchFetcher, BatchFetcherFixture)
+
+BOOST_AUTO_TEST_CASE(ParseManifest)
+{
+  std::istringstream is("# objects to mirror\n"
+                        "/ndn/a/%FD%01\n"
+                        "\n"
+                        "  /ndn/b/%FD%02/%00%00   b.out\n"
+                        "/ndn/c /tmp/c.out\n");
+  auto objects = BatchFetcher::parseManifest(is, "dir");
+  BOOST_REQUIRE_EQUAL(objects.size(), 3);
+  BOOST_CHECK_EQUAL(objects[0].name, Name("/ndn/a/%FD%01"));
+  BOOST_CHECK_EQUAL(objects[0].outputFile, "dir/a");
+  BOOST_CHECK_EQUAL(objects[1].name, Name("/ndn/b/%FD%02/%00%00"));
+  BOOST_CHECK_EQUAL(objects[1].outputFile, "dir/b.out");
+  BOOST_CHECK_EQUAL(objects[2].outputFile, "/tmp/c.out");
+
+  std::istringstream tooManyFields("/ndn/a a.out extra\n");
+  BOOST_CHECK_THROW(BatchFetcher::parseManifest(tooManyFields, "."), BatchFetcher::Error);
+
+  std::istringstream onlyVersion("/%FD%01\n");
+  BOOST_CHECK_THROW(BatchFetcher::parseManifest(onlyVersion, "."), BatchFetcher::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SharedWindow)
+{
+  std::vector<BatchFetcher::Object> objects;
+  for (const char* object : {"a", "b", "c"})
+    objects.push_back({Name("/ndn").append(object).appendVersion(1), (tmpPath / object).string()});
+
+  BatchFetcher fetcher(face, validator, options,
+                       bind(&BatchFetcherFixture::makeDiscover, this, _1), 2, true);
+  fetcher.start(objects);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the objects share a window of 2 Interests
+  size_t nAnswered = 0;
+  while (nAnswered < face.sentInterests.size()) {
+    BOOST_CHECK_LE(face.sentInterests.size() - nAnswered, options.maxPipelineSize);
+    BOOST_CHECK_LE(fetcher.getSharedWindow().getNInFlight(), options.maxPipelineSize);
+
+    face.receive(*makeSegment(face.sentInterests[nAnswered++].getName()));
+    advanceClocks(io, time::nanoseconds(1), 1);
+  }
+
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), objects.size() * nSegments);
+  BOOST_CHECK_EQUAL(fetcher.getNCompleted(), objects.size());
+  BOOST_CHECK_EQUAL(fetcher.getNFailed(), 0);
+  BOOST_CHECK_EQUAL(fetcher.getSharedWindow().getNInFlight(), 0);
+
+  for (const auto& object : objects) {
+    std::string expected;
+    for (uint64_t segmentNo = 0; segmentNo < nSegments; ++segmentNo)
+      expected += object.name.getPrefix(-1).toUri() + to_string(segmentNo);
+    BOOST_CHECK_EQUAL(readFile(object.outputFile), expected);
+  }
+  BOOST_CHECK_EQUAL(fetcher.getNBytes(), objects.size() * readFile(objects[0].outputFile).size());
+}
+
+BOOST_AUTO_TEST_CASE(FailedObject)
+{
+  options.maxRetriesOnTimeoutOrNack = 0;
+  std::vector<BatchFetcher::Object> objects;
+  for (const char* object : {"a", "b"})
+    objects.push_back({Name("/ndn").append(object).appendVersion(1), (tmpPath / object).string()});
+
+  BatchFetcher fetcher(face, validator, options,
+                       bind(&BatchFetcherFixture::makeDiscover, this, _1), 2, true);
+  fetcher.start(objects);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // only the segments of /ndn/b are answered, the Interests of /ndn/a time out
+  size_t nAnswered = 0;
+  for (int i = 0; i < 100 && fetcher.getNCompleted() + fetcher.getNFailed() < objects.size(); ++i) {
+    for (; nAnswered < face.sentInterests.size(); ++nAnswered) {
+      const Name& name = face.sentInterests[nAnswered].getName();
+      if (objects[1].name.isPrefixOf(name))
+        face.receive(*makeSegment(name));
+    }
+    advanceClocks(io, time::milliseconds(100), 1);
+  }
+
+  BOOST_CHECK_EQUAL(fetcher.getNCompleted(), 1);
+  BOOST_CHECK_EQUAL(fetcher.getNFailed(), 1);
+  BOOST_CHECK(!boost::filesystem::exists(objects[0].outputFile));
+  BOOST_CHECK(boost::filesystem::exists(objects[1].outputFile));
+  BOOST_CHECK_EQUAL(fetcher.getSharedWindow().getNInFlight(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RunReturns)
+{
+  std::vector<BatchFetcher::Object> objects;
+  for (const char* object : {"a", "b", "c"})
+    objects.push_back({Name("/ndn").append(object).appendVersion(1), (tmpPath / object).string()});
+
+  face.onSendInterest.connect([this] (const Interest& interest) {
+      io.post([=] { face.receive(*makeSegment(interest.getName())); });
+    });
+
+  // a pending handler, like the SIGINT handler of ndncatchunks, must not keep run() from returning
+  bool isTimerExpired = false;
+  boost::asio::deadline_timer timer(io, boost::posix_time::seconds(10));
+  timer.async_wait([&isTimerExpired] (const boost::system::error_code& error) {
+      isTimerExpired = !error;
+    });
+
+  BatchFetcher fetcher(face, validator, options,
+                       bind(&BatchFetcherFixture::makeDiscover, this, _1), 2, true);
+  fetcher.run(objects);
+
+  BOOST_CHECK(!isTimerExpired);
+  BOOST_CHECK_EQUAL(fetcher.getNCompleted(), objects.size());
+  BOOST_CHECK_EQUAL(fetcher.getNFailed(), 0);
+  timer.cancel();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestBatchFetcher
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
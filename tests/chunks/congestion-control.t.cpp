@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/congestion-control-aimd.hpp"
+#include "tools/chunks/catchunks/congestion-control-bbr.hpp"
+#include "tools/chunks/catchunks/congestion-control-cubic.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class CongestionControlFixture : public UnitTestTimeFixture
+{
+public:
+  CongestionControlFixture()
+  {
+    opt.slowStartThreshold = 20;
+    opt.windowCutMultiplier = 0.75;
+  }
+
+protected:
+  PipelineInterestsOptions opt;
+  RttEstimator rttEstimator;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestCongestionControl, CongestionControlFixture)
+
+BOOST_AUTO_TEST_CASE(Create)
+{
+  BOOST_CHECK(dynamic_cast<CongestionControlAimd*>(
+                CongestionControl::create("aimd", opt, rttEstimator).get()) != nullptr);
+  BOOST_CHECK(dynamic_cast<CongestionControlCubic*>(
+                CongestionControl::create("cubic", opt, rttEstimator).get()) != nullptr);
+  BOOST_CHECK(dynamic_cast<CongestionControlBbr*>(
+                CongestionControl::create("bbr", opt, rttEstimator).get()) != nullptr);
+  BOOST_CHECK(CongestionControl::create("reno", opt, rttEstimator) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Aimd)
+{
+  CongestionControlAimd aimd(opt, rttEstimator);
+
+  // slow start
+  BOOST_CHECK_EQUAL(aimd.onData(10, 10), 11);
+  BOOST_CHECK_EQUAL(aimd.onData(20, 10), 21);
+
+  // congestion avoidance, one segment per round
+  BOOST_CHECK_CLOSE(aimd.onData(40, 40), 40.025, 0.001);
+
+  // the window of the round is cut
+  BOOST_CHECK_CLOSE(aimd.onLoss(45, 40), 30, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(Cubic)
+{
+  opt.slowStartThreshold = 0;
+  CongestionControlCubic cubic(opt, rttEstimator);
+
+  // slow start until the first loss
+  BOOST_CHECK_EQUAL(cubic.onData(10, 10), 11);
+  BOOST_CHECK_EQUAL(cubic.onData(99, 99), 100);
+
+  float windowSize = cubic.onLoss(100, 100);
+  BOOST_CHECK_CLOSE(windowSize, 70, 0.001);
+
+  // the window is back to the window before the loss after K = cbrt(100 * 0.3 / 0.4) seconds
+  for (int i = 0; i < 2000; ++i) {
+    steadyClock->advance(time::milliseconds(1));
+    windowSize = cubic.onData(windowSize, windowSize);
+  }
+  BOOST_CHECK_GT(windowSize, 90);
+  BOOST_CHECK_LT(windowSize, 98);
+
+  for (int i = 0; i < 2200; ++i) {
+    steadyClock->advance(time::milliseconds(1));
+    windowSize = cubic.onData(windowSize, windowSize);
+  }
+  BOOST_CHECK_GT(windowSize, 98);
+  BOOST_CHECK_LT(windowSize, 101);
+
+  // then it probes beyond it
+  for (int i = 0; i < 2000; ++i) {
+    steadyClock->advance(time::milliseconds(1));
+    windowSize = cubic.onData(windowSize, windowSize);
+  }
+  BOOST_CHECK_GT(windowSize, 102);
+
+  // congestion avoidance after the loss
+  float newWindowSize = cubic.onLoss(windowSize, windowSize);
+  BOOST_CHECK_CLOSE(newWindowSize, windowSize * CongestionControlCubic::BETA, 0.001);
+  BOOST_CHECK_LT(cubic.onData(newWindowSize, newWindowSize), newWindowSize + 1);
+}
+
+BOOST_AUTO_TEST_CASE(Bbr)
+{
+  {
+    // the BDP is unknown, the window grows as in slow start
+    CongestionControlBbr bbr(opt, rttEstimator);
+    BOOST_CHECK_EQUAL(bbr.getBdp(), 0);
+    BOOST_CHECK_EQUAL(bbr.onData(10, 10), 11);
+    BOOST_CHECK_CLOSE(bbr.onLoss(10, 10), 7.5, 0.001);
+  }
+
+  CongestionControlBbr bbr(opt, rttEstimator);
+  BOOST_CHECK(bbr.getState() == CongestionControlBbr::State::Startup);
+
+  // min RTT = 100 ms
+  auto now = time::steady_clock::now();
+  rttEstimator.addRttMeasurement(now - time::milliseconds(100), now - time::milliseconds(100), 1);
+  BOOST_REQUIRE_EQUAL(rttEstimator.getRttMin(), 100);
+
+  // 100 segments per round of 100 ms, the delivery rate does not grow
+  float windowSize = 100;
+  for (int round = 0; round < 4; ++round) {
+    BOOST_CHECK(bbr.getState() == CongestionControlBbr::State::Startup);
+    for (int i = 0; i < 100; ++i) {
+      steadyClock->advance(time::milliseconds(1));
+      windowSize = bbr.onData(windowSize, windowSize);
+    }
+    bbr.onRoundEnd(windowSize);
+  }
+
+  BOOST_CHECK(bbr.getState() == CongestionControlBbr::State::Drain);
+  BOOST_CHECK_CLOSE(bbr.getMaxDeliveryRate(), 1, 0.001);
+  BOOST_CHECK_CLOSE(bbr.getBdp(), 100, 0.001);
+
+  // the window grows up to 2.89 BDP in Startup
+  BOOST_CHECK_CLOSE(windowSize, 289, 0.001);
+
+  // the queue is drained by keeping one BDP in flight
+  BOOST_CHECK_CLOSE(bbr.onData(289, 289), 100, 0.001);
+
+  steadyClock->advance(time::milliseconds(100));
+  bbr.onRoundEnd(100);
+  BOOST_CHECK(bbr.getState() == CongestionControlBbr::State::ProbeBw);
+
+  // probe with 1.25 BDP
+  BOOST_CHECK_CLOSE(bbr.onData(100, 100), 101, 0.001);
+  BOOST_CHECK_CLOSE(bbr.onData(200, 200), 125, 0.001);
+
+  // the loss does not cut the window below the BDP
+  BOOST_CHECK_CLOSE(bbr.onLoss(200, 200), 150, 0.001);
+  BOOST_CHECK_CLOSE(bbr.onLoss(110, 110), 100, 0.001);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCongestionControl
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -24,13 +24,20 @@
  */
 
 #include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/discover-version-fixed.hpp"
+#include "tools/chunks/catchunks/discover-version-iterative.hpp"
+#include "tools/chunks/catchunks/discovery-cache.hpp"
+#include "tools/chunks/putchunks/streaming-producer.hpp"
 
 #include "tests/test-common.hpp"
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <ndn-cxx/security/validator-null.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/test/output_test_stream.hpp>
 
+#include <thread>
+
 namespace ndn {
 namespace chunks {
 namespace tests {
@@ -134,6 +141,238 @@ BOOST_AUTO_TEST_CASE(OutputDataUnordered)
   BOOST_CHECK(output.is_equal(testStrings[2]));
 }
 
+class DiscoveryFixture : public UnitTestTimeFixture
+{
+public:
+  DiscoveryFixture()
+    : face(io)
+    , name("/ndn/chunks/test")
+    , output("")
+  {
+    options.isVerbose = false;
+    options.interestLifetime = time::seconds(1);
+    options.maxRetriesOnTimeoutOrNack = 3;
+    options.startPipelineSize = 2;
+    options.maxPipelineSize = 2;
+  }
+
+protected:
+  shared_ptr<Data>
+  makeSegment(uint64_t version, uint64_t segmentNo)
+  {
+    auto data = makeData(Name(name).appendVersion(version).appendSegment(segmentNo));
+    std::string content = getContent(version, segmentNo);
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    data->setFinalBlockId(name::Component::fromSegment(2));
+    return signData(data);
+  }
+
+  static std::string
+  getContent(uint64_t version, uint64_t segmentNo)
+  {
+    return to_string(version) + "/" + to_string(segmentNo) + " ";
+  }
+
+  size_t
+  countInterests(uint64_t version, uint64_t segmentNo) const
+  {
+    Name segmentName = Name(name).appendVersion(version).appendSegment(segmentNo);
+    return std::count_if(face.sentInterests.begin(), face.sentInterests.end(),
+                         [&segmentName] (const Interest& interest) {
+                           return interest.getName() == segmentName;
+                         });
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  Name name;
+  PipelineInterestsOptions options;
+  ValidatorNull validator;
+  output_test_stream output;
+};
+
+BOOST_FIXTURE_TEST_CASE(SpeculativeWindowConfirmed, DiscoveryFixture)
+{
+  DiscoverVersionIterative discover(name, face, DiscoverVersionIterative::Options(options));
+  PipelineInterests pipeline(face, options);
+  Consumer cons(face, validator, false, output);
+  cons.setSpeculativeWindow(3);
+  cons.start(discover, pipeline);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  face.receive(*makeSegment(1, 0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the rest of the first window is requested before the version is confirmed
+  BOOST_CHECK_EQUAL(countInterests(1, 1), 1);
+  BOOST_CHECK_EQUAL(countInterests(1, 2), 1);
+
+  face.receive(*makeSegment(1, 2));
+  face.receive(*makeSegment(1, 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK(output.is_equal(""));
+
+  // the discovery confirms the version after the retransmission of its last Interest
+  advanceClocks(io, time::milliseconds(100), 25);
+
+  BOOST_CHECK(output.is_equal(getContent(1, 0) + getContent(1, 1) + getContent(1, 2)));
+  BOOST_CHECK_EQUAL(countInterests(1, 1), 1);
+  BOOST_CHECK_EQUAL(countInterests(1, 2), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(SpeculativeWindowSuperseded, DiscoveryFixture)
+{
+  DiscoverVersionIterative discover(name, face, DiscoverVersionIterative::Options(options));
+  PipelineInterests pipeline(face, options);
+  Consumer cons(face, validator, false, output);
+  cons.setSpeculativeWindow(3);
+  cons.start(discover, pipeline);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  face.receive(*makeSegment(1, 0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  face.receive(*makeSegment(1, 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // a larger version is found, the segments of the previous one are discarded
+  face.receive(*makeSegment(2, 0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(countInterests(2, 1), 1);
+  BOOST_CHECK_EQUAL(countInterests(2, 2), 1);
+
+  face.receive(*makeSegment(2, 1));
+  advanceClocks(io, time::milliseconds(100), 25);
+
+  // only the segment that has not been received is fetched by the pipeline
+  BOOST_CHECK_EQUAL(countInterests(2, 1), 1);
+  BOOST_CHECK_EQUAL(countInterests(2, 2), 2);
+
+  face.receive(*makeSegment(2, 2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK(output.is_equal(getContent(2, 0) + getContent(2, 1) + getContent(2, 2)));
+}
+
+BOOST_FIXTURE_TEST_CASE(StreamedContent, DiscoveryFixture)
+{
+  util::DummyClientFace producerFace(io, {true, true});
+  face.onSendInterest.connect([this, &producerFace] (const Interest& interest) {
+      io.post([interest, &producerFace] { producerFace.receive(interest); });
+    });
+  producerFace.onSendData.connect([this] (const Data& data) {
+      io.post([this, data] { face.receive(data); });
+    });
+
+  std::string content;
+  for (int i = 0; i < 20; ++i)
+    content += "line " + to_string(i) + "\n";
+  std::istringstream input(content);
+
+  Name versionedName = Name(name).appendVersion(1);
+  StreamingProducer producer(versionedName, producerFace, [] { return make_unique<KeyChain>(); },
+                             security::SigningInfo(), time::seconds(10), 40, false, false, input);
+
+  // the segments are signed and published by the reading thread
+  for (int i = 0; i < 5000 && !producer.m_isEof; ++i) {
+    io.poll();
+    io.reset();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_REQUIRE(producer.m_isEof);
+  BOOST_REQUIRE_GT(producer.m_store.size(), 2);
+  BOOST_CHECK(producer.m_store.front()->getFinalBlockId().empty());
+  BOOST_CHECK(!producer.m_store.back()->getFinalBlockId().empty());
+
+  DiscoverVersionFixed discover(versionedName, face, options);
+  PipelineInterests pipeline(face, options);
+  Consumer cons(face, validator, false, output);
+  bool isComplete = false;
+  cons.setCompletionCallback([&isComplete] { isComplete = true; });
+  cons.start(discover, pipeline);
+  advanceClocks(io, time::milliseconds(1), 100);
+
+  BOOST_CHECK(isComplete);
+  BOOST_CHECK(output.is_equal(content));
+}
+
+class DiscoveryCacheFixture : public DiscoveryFixture
+{
+public:
+  DiscoveryCacheFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "ConsumerDiscoveryCacheTest")
+  {
+    boost::filesystem::create_directories(tmpPath);
+    cache = make_unique<DiscoveryCache>((tmpPath / "cache").string(), time::seconds(60));
+  }
+
+  ~DiscoveryCacheFixture()
+  {
+    cache.reset();
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  unique_ptr<DiscoveryCache> cache;
+};
+
+BOOST_FIXTURE_TEST_CASE(DiscoveryCacheHit, DiscoveryCacheFixture)
+{
+  DiscoveryCache::Entry entry;
+  entry.version = 1;
+  entry.lastSegmentNo = 2;
+  entry.rttMean = 50;
+  entry.rttVar = 10;
+  entry.windowSize = 2;
+  cache->insert(name, entry);
+
+  DiscoverVersionIterative discover(name, face, DiscoverVersionIterative::Options(options));
+  PipelineInterests pipeline(face, options);
+  Consumer cons(face, validator, false, output);
+  cons.setDiscoveryCache(*cache);
+  cons.start(discover, pipeline);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the segments are requested right away, without discovery
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK_EQUAL(countInterests(1, 0), 1);
+  BOOST_CHECK_EQUAL(countInterests(1, 1), 1);
+  BOOST_CHECK_CLOSE(pipeline.rttEstimator.getRttMean(), 50, 0.001);
+
+  face.receive(*makeSegment(1, 0));
+  face.receive(*makeSegment(1, 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(countInterests(1, 2), 1);
+
+  face.receive(*makeSegment(1, 2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK(output.is_equal(getContent(1, 0) + getContent(1, 1) + getContent(1, 2)));
+}
+
+BOOST_FIXTURE_TEST_CASE(DiscoveryCacheMiss, DiscoveryCacheFixture)
+{
+  DiscoverVersionIterative discover(name, face, DiscoverVersionIterative::Options(options));
+  PipelineInterests pipeline(face, options);
+  Consumer cons(face, validator, false, output);
+  cons.setDiscoveryCache(*cache);
+  cons.start(discover, pipeline);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  face.receive(*makeSegment(1, 0));
+  advanceClocks(io, time::milliseconds(100), 25);
+
+  face.receive(*makeSegment(1, 1));
+  face.receive(*makeSegment(1, 2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK(output.is_equal(getContent(1, 0) + getContent(1, 1) + getContent(1, 2)));
+
+  // the discovered version is stored once the content has been retrieved
+  DiscoveryCache::Entry entry;
+  BOOST_REQUIRE_EQUAL(cache->find(name, entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 1);
+  BOOST_CHECK_EQUAL(entry.lastSegmentNo, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestConsumer
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/delivery-rate-estimator.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestDeliveryRateEstimator, UnitTestTimeFixture)
+
+BOOST_AUTO_TEST_CASE(DeliveryRate)
+{
+  DeliveryRateEstimator estimator(time::milliseconds(100), 3);
+  BOOST_CHECK_EQUAL(estimator.getDeliveryRate(), 0);
+  BOOST_CHECK_EQUAL(estimator.getMaxDeliveryRate(), 0);
+  BOOST_CHECK_EQUAL(estimator.getGoodput(), 0);
+
+  // 1 segment of 1000 bytes every 2 ms
+  estimator.addDelivery(1000);
+  for (int i = 0; i < 50; ++i) {
+    steadyClock->advance(time::milliseconds(2));
+    estimator.addDelivery(1000);
+  }
+  BOOST_CHECK_CLOSE(estimator.getDeliveryRate(), 0.5, 0.001);
+  BOOST_CHECK_EQUAL(estimator.getNDelivered(), 51);
+  BOOST_CHECK_EQUAL(estimator.getNDeliveredBytes(), 51000);
+  BOOST_CHECK_CLOSE(estimator.getGoodput(), 510000, 0.001);
+
+  // 1 segment every 1 ms
+  for (int i = 0; i < 100; ++i) {
+    steadyClock->advance(time::milliseconds(1));
+    estimator.addDelivery(1000);
+  }
+  BOOST_CHECK_CLOSE(estimator.getDeliveryRate(), 1, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getMaxDeliveryRate(), 1, 0.001);
+
+  // 1 segment every 4 ms, the maximum is kept for 3 samples
+  for (int i = 0; i < 25; ++i) {
+    steadyClock->advance(time::milliseconds(4));
+    estimator.addDelivery(1000);
+  }
+  BOOST_CHECK_CLOSE(estimator.getDeliveryRate(), 0.25, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getMaxDeliveryRate(), 1, 0.001);
+
+  for (int i = 0; i < 50; ++i) {
+    steadyClock->advance(time::milliseconds(4));
+    estimator.addDelivery(1000);
+  }
+  BOOST_CHECK_CLOSE(estimator.getMaxDeliveryRate(), 0.25, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(SampleInterval)
+{
+  DeliveryRateEstimator estimator(time::milliseconds(100));
+  estimator.setSampleInterval(time::milliseconds(10));
+
+  estimator.addDelivery(1000);
+  for (int i = 0; i < 10; ++i) {
+    steadyClock->advance(time::milliseconds(1));
+    estimator.addDelivery(1000);
+  }
+  BOOST_CHECK_CLOSE(estimator.getDeliveryRate(), 1, 0.001);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDeliveryRateEstimator
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
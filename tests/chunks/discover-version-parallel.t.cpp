@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "tools/chunks/catchunks/discover-version-parallel.hpp"
+
+#include "discover-version-fixture.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class DiscoverVersionParallelFixture : public DiscoverVersionFixture,
+                                       protected DiscoverVersionParallelOptions
+{
+public:
+  typedef DiscoverVersionParallelOptions Options;
+
+public:
+  explicit
+  DiscoverVersionParallelFixture(const Options& opt = makeOptionsParallel())
+    : chunks::Options(opt)
+    , DiscoverVersionFixture(opt)
+    , Options(opt)
+  {
+    setDiscover(make_unique<DiscoverVersionParallel>(Name(name), face, opt));
+  }
+
+protected:
+  static Options
+  makeOptionsParallel()
+  {
+    Options options;
+    options.isVerbose = false;
+    options.interestLifetime = time::seconds(1);
+    options.maxRetriesOnTimeoutOrNack = 3;
+    options.nRanges = 4;
+    options.newestRangeAge = time::seconds(10);
+    return options;
+  }
+
+  static uint64_t
+  now()
+  {
+    return time::toUnixTimestamp(time::system_clock::now()).count();
+  }
+
+  void
+  nackRange(size_t rangeNo)
+  {
+    lp::Nack nack(face.sentInterests.at(rangeNo));
+    nack.setReason(lp::NackReason::NO_ROUTE);
+    face.receive(nack);
+  }
+};
+
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestDiscoverVersionParallel)
+
+BOOST_FIXTURE_TEST_CASE(RangesPartitionVersions, DiscoverVersionParallelFixture)
+{
+  uint64_t start = now();
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  uint64_t age = newestRangeAge.count();
+  for (size_t rangeNo = 0; rangeNo < nRanges; ++rangeNo) {
+    const Interest& interest = face.sentInterests[rangeNo];
+    BOOST_CHECK_EQUAL(interest.getChildSelector(), 1);
+    BOOST_CHECK_EQUAL(interest.getMustBeFresh(), mustBeFresh);
+    BOOST_CHECK_EQUAL(interest.getName().equals(name), true);
+
+    Exclude expectedExclude;
+    if (rangeNo + 1 < nRanges)
+      expectedExclude.excludeBefore(name::Component::fromVersion(start - age - 1));
+    if (rangeNo > 0)
+      expectedExclude.excludeAfter(name::Component::fromVersion(start - age / 10));
+    BOOST_CHECK_EQUAL(interest.getExclude(), expectedExclude);
+
+    age *= 10;
+  }
+
+  // every version is requested by exactly one range
+  for (uint64_t version : {start + 1000, start - 1, start - 20000, start - 200000, uint64_t(1)}) {
+    auto data = makeDataWithVersion(version);
+    size_t nMatches = 0;
+    for (const auto& interest : face.sentInterests) {
+      if (interest.matchesData(*data))
+        ++nMatches;
+    }
+    BOOST_CHECK_EQUAL(nMatches, 1);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(NewestRangeAnswers, DiscoverVersionParallelFixture)
+{
+  uint64_t version = now() - 1000;
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  // the older ranges cannot hold a larger version, no need to wait for them
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+
+  advanceClocks(io, interestLifetime, maxRetriesOnTimeoutOrNack + 1);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), nRanges);
+}
+
+BOOST_FIXTURE_TEST_CASE(OlderRangeAnswers, DiscoverVersionParallelFixture)
+{
+  uint64_t version = now() - 500000;
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  advanceClocks(io, time::milliseconds(10), 1);
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the newer ranges might still answer, they are waited for until they fail
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+  advanceClocks(io, interestLifetime, maxRetriesOnTimeoutOrNack);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+
+  advanceClocks(io, interestLifetime, 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+}
+
+BOOST_FIXTURE_TEST_CASE(NewestRangeAnswersLate, DiscoverVersionParallelFixture)
+{
+  uint64_t olderVersion = now() - 500000;
+  uint64_t version = now() - 1000;
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  // an older version is answered quickly, e.g. by a nearby cache
+  advanceClocks(io, time::milliseconds(1), 1);
+  face.receive(*makeDataWithVersion(olderVersion));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the producer of the newest version is far away
+  advanceClocks(io, time::milliseconds(10), 50);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+}
+
+BOOST_FIXTURE_TEST_CASE(NewerRangesNacked, DiscoverVersionParallelFixture)
+{
+  uint64_t version = now() - 50000;
+  uint64_t olderVersion = now() - 5000000;
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  face.receive(*makeDataWithVersion(olderVersion));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+
+  nackRange(0);
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // all the ranges have answered or have been Nacked
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+}
+
+BOOST_FIXTURE_TEST_CASE(StrayComponent, DiscoverVersionParallelFixture)
+{
+  uint64_t version = now() - 1000;
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  auto stray = make_shared<Data>(Name(name).append("not-a-version").appendSegment(0));
+  face.receive(*signData(stray));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges + 1);
+  auto lastInterest = face.sentInterests.back();
+  BOOST_CHECK_EQUAL(lastInterest.matchesData(*stray), false);
+
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+}
+
+BOOST_FIXTURE_TEST_CASE(NoVersionsAvailable, DiscoverVersionParallelFixture)
+{
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), nRanges);
+
+  for (int retries = 0; retries < maxRetriesOnTimeoutOrNack; ++retries) {
+    advanceClocks(io, interestLifetime, 1);
+    BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+    BOOST_CHECK_EQUAL(face.sentInterests.size(), nRanges * (retries + 2));
+  }
+
+  advanceClocks(io, interestLifetime, 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDiscoverVersionParallel
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
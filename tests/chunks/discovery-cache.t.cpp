@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/discovery-cache.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class DiscoveryCacheFixture : public UnitTestTimeFixture
+{
+public:
+  DiscoveryCacheFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "DiscoveryCacheTest")
+    , filePath((tmpPath / "cache").string())
+    , ttl(time::seconds(60))
+  {
+    boost::filesystem::create_directories(tmpPath);
+  }
+
+  ~DiscoveryCacheFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  static DiscoveryCache::Entry
+  makeEntry(uint64_t version)
+  {
+    DiscoveryCache::Entry entry;
+    entry.version = version;
+    entry.lastSegmentNo = 41;
+    entry.rttMean = 25.5;
+    entry.rttVar = 4;
+    entry.windowSize = 64;
+    return entry;
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  std::string filePath;
+  time::milliseconds ttl;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestDiscoveryCache, DiscoveryCacheFixture)
+
+BOOST_AUTO_TEST_CASE(InsertFind)
+{
+  DiscoveryCache cache(filePath, ttl, 16);
+  BOOST_CHECK_EQUAL(cache.getCapacity(), 16);
+
+  DiscoveryCache::Entry entry;
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), false);
+
+  cache.insert("/ndn/a", makeEntry(1449241767037));
+  BOOST_REQUIRE_EQUAL(cache.find("/ndn/a", entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 1449241767037);
+  BOOST_CHECK_EQUAL(entry.lastSegmentNo, 41);
+  BOOST_CHECK_EQUAL(entry.rttMean, 25.5);
+  BOOST_CHECK_EQUAL(entry.rttVar, 4);
+  BOOST_CHECK_EQUAL(entry.windowSize, 64);
+
+  BOOST_CHECK_EQUAL(cache.find("/ndn", entry), false);
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a/b", entry), false);
+
+  // the entry of a prefix is replaced
+  cache.insert("/ndn/a", makeEntry(1449241767038));
+  BOOST_REQUIRE_EQUAL(cache.find("/ndn/a", entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 1449241767038);
+}
+
+BOOST_AUTO_TEST_CASE(Expiration)
+{
+  DiscoveryCache cache(filePath, ttl, 16);
+  cache.insert("/ndn/a", makeEntry(1));
+
+  DiscoveryCache::Entry entry;
+  systemClock->advance(ttl - time::milliseconds(1));
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), true);
+
+  systemClock->advance(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), false);
+
+  cache.insert("/ndn/a", makeEntry(2));
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), true);
+
+  cache.erase("/ndn/a");
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), false);
+}
+
+BOOST_AUTO_TEST_CASE(SharedFile)
+{
+  DiscoveryCache cache(filePath, ttl, 16);
+  cache.insert("/ndn/a", makeEntry(1));
+
+  // the capacity of an existing file is kept
+  DiscoveryCache other(filePath, ttl, 1024);
+  BOOST_CHECK_EQUAL(other.getCapacity(), 16);
+
+  DiscoveryCache::Entry entry;
+  BOOST_REQUIRE_EQUAL(other.find("/ndn/a", entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 1);
+
+  other.insert("/ndn/b", makeEntry(2));
+  BOOST_REQUIRE_EQUAL(cache.find("/ndn/b", entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction)
+{
+  // every prefix competes for the same slot
+  DiscoveryCache cache(filePath, ttl, 1);
+  cache.insert("/ndn/a", makeEntry(1));
+  systemClock->advance(time::seconds(1));
+  cache.insert("/ndn/b", makeEntry(2));
+
+  DiscoveryCache::Entry entry;
+  BOOST_CHECK_EQUAL(cache.find("/ndn/a", entry), false);
+  BOOST_REQUIRE_EQUAL(cache.find("/ndn/b", entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 2);
+}
+
+BOOST_AUTO_TEST_CASE(FullTable)
+{
+  DiscoveryCache cache(filePath, ttl, 64);
+  for (int i = 0; i < 256; ++i) {
+    cache.insert(Name("/ndn").appendNumber(i), makeEntry(i));
+    systemClock->advance(time::milliseconds(1));
+  }
+
+  // the most recent entries are kept
+  DiscoveryCache::Entry entry;
+  BOOST_REQUIRE_EQUAL(cache.find(Name("/ndn").appendNumber(255), entry), true);
+  BOOST_CHECK_EQUAL(entry.version, 255);
+
+  size_t nFound = 0;
+  for (int i = 0; i < 256; ++i) {
+    if (cache.find(Name("/ndn").appendNumber(i), entry)) {
+      BOOST_CHECK_EQUAL(entry.version, i);
+      ++nFound;
+    }
+  }
+  BOOST_CHECK_LE(nFound, 64);
+}
+
+BOOST_AUTO_TEST_CASE(LongPrefix)
+{
+  DiscoveryCache cache(filePath, ttl, 16);
+  Name prefix("/ndn");
+  prefix.append(std::string(DiscoveryCache::MAX_PREFIX_SIZE, 'a'));
+
+  cache.insert(prefix, makeEntry(1));
+  DiscoveryCache::Entry entry;
+  BOOST_CHECK_EQUAL(cache.find(prefix, entry), false);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFile)
+{
+  {
+    std::ofstream os(filePath);
+    os << "not a discovery cache";
+  }
+  BOOST_CHECK_THROW(DiscoveryCache(filePath, ttl), DiscoveryCache::Error);
+  BOOST_CHECK_THROW(DiscoveryCache((tmpPath / "missing" / "cache").string(), ttl),
+                    DiscoveryCache::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDiscoveryCache
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
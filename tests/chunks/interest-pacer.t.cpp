@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/interest-pacer.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class InterestPacerFixture : public UnitTestTimeFixture
+{
+public:
+  InterestPacerFixture()
+    : scheduler(io)
+    , pacer(scheduler, 2)
+    , nSent(0)
+  {
+  }
+
+  void
+  send()
+  {
+    ++nSent;
+  }
+
+protected:
+  boost::asio::io_service io;
+  Scheduler scheduler;
+  InterestPacer pacer;
+  size_t nSent;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestInterestPacer, InterestPacerFixture)
+
+BOOST_AUTO_TEST_CASE(Unpaced)
+{
+  for (int i = 0; i < 10; ++i)
+    pacer.schedule(bind(&InterestPacerFixture::send, this));
+
+  BOOST_CHECK_EQUAL(nSent, 10);
+  BOOST_CHECK_EQUAL(pacer.getNQueued(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Paced)
+{
+  // one Interest every 10 ms
+  pacer.setRate(0.1);
+
+  for (int i = 0; i < 10; ++i)
+    pacer.schedule(bind(&InterestPacerFixture::send, this));
+
+  // the burst is sent immediately
+  BOOST_CHECK_EQUAL(nSent, 2);
+  BOOST_CHECK_EQUAL(pacer.getNQueued(), 8);
+
+  advanceClocks(io, time::milliseconds(1), 10);
+  BOOST_CHECK_EQUAL(nSent, 3);
+
+  advanceClocks(io, time::milliseconds(1), 40);
+  BOOST_CHECK_EQUAL(nSent, 7);
+
+  // a rate of 0 sends the queued Interests
+  pacer.setRate(0);
+  BOOST_CHECK_EQUAL(nSent, 10);
+  BOOST_CHECK_EQUAL(pacer.getNQueued(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RateChange)
+{
+  pacer.setRate(0.01);
+  for (int i = 0; i < 5; ++i)
+    pacer.schedule(bind(&InterestPacerFixture::send, this));
+  BOOST_CHECK_EQUAL(nSent, 2);
+
+  advanceClocks(io, time::milliseconds(10), 5);
+  BOOST_CHECK_EQUAL(nSent, 2);
+
+  // the release event is rescheduled with the new rate
+  pacer.setRate(1);
+  advanceClocks(io, time::milliseconds(1), 3);
+  BOOST_CHECK_EQUAL(nSent, 5);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  pacer.setRate(0.1);
+  for (int i = 0; i < 5; ++i)
+    pacer.schedule(bind(&InterestPacerFixture::send, this));
+
+  pacer.cancel();
+  BOOST_CHECK_EQUAL(pacer.getNQueued(), 0);
+
+  advanceClocks(io, time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(nSent, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestInterestPacer
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
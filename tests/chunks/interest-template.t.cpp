@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/interest-template.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestInterestTemplate)
+
+BOOST_AUTO_TEST_CASE(SegmentNumbers)
+{
+  Name prefix("/ndn/chunks/test");
+  prefix.appendVersion(1);
+  InterestTemplate interestTemplate(prefix, true);
+
+  // every length of the segment number, and both ends of each length
+  std::vector<uint64_t> segments{0, 1, 255, 256, 65535, 65536, 4294967295, 4294967296,
+                                 std::numeric_limits<uint64_t>::max()};
+  for (uint64_t segmentNo : segments) {
+    Interest interest = interestTemplate.makeInterest(segmentNo, time::milliseconds(1500), 42);
+
+    BOOST_CHECK_EQUAL(interest.getName(), Name(prefix).appendSegment(segmentNo));
+    BOOST_CHECK_EQUAL(interest.getName()[-1].toSegment(), segmentNo);
+    BOOST_CHECK_EQUAL(interest.getNonce(), 42);
+    BOOST_CHECK_EQUAL(interest.getInterestLifetime().count(), 1500);
+    BOOST_CHECK_EQUAL(interest.getMustBeFresh(), true);
+    BOOST_CHECK_EQUAL(interest.getMaxSuffixComponents(), 1);
+
+    // the Interest is sent with the patched encoding
+    BOOST_CHECK(interest.hasWire());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ReusedEncoding)
+{
+  InterestTemplate interestTemplate("/ndn/chunks/test", false);
+
+  Interest first = interestTemplate.makeInterest(7, time::milliseconds(300), 1);
+  Interest second = interestTemplate.makeInterest(8, time::milliseconds(70000), 2);
+
+  // the Interests made from the same encoding do not share it
+  BOOST_CHECK_EQUAL(first.getName()[-1].toSegment(), 7);
+  BOOST_CHECK_EQUAL(first.getNonce(), 1);
+  BOOST_CHECK_EQUAL(first.getInterestLifetime().count(), 300);
+  BOOST_CHECK_EQUAL(first.getMustBeFresh(), false);
+  BOOST_CHECK_EQUAL(second.getName()[-1].toSegment(), 8);
+  BOOST_CHECK_EQUAL(second.getNonce(), 2);
+  BOOST_CHECK_EQUAL(second.getInterestLifetime().count(), 70000);
+  BOOST_CHECK_EQUAL(first.wireEncode().size(), second.wireEncode().size());
+
+  // random Nonce
+  Interest third = interestTemplate.makeInterest(8, time::milliseconds(300));
+  Interest fourth = interestTemplate.makeInterest(8, time::milliseconds(300));
+  BOOST_CHECK_NE(third.getNonce(), fourth.getNonce());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestInterestTemplate
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
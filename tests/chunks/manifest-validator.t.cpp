@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/manifest-validator.hpp"
+#include "tools/chunks/common/digest-signing.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ManifestValidatorFixture : public UnitTestTimeFixture
+{
+public:
+  ManifestValidatorFixture()
+    : face(io)
+    , versionedPrefix(Name("/ndn/chunks/test").appendVersion(1))
+    , nValidated(0)
+    , nFailed(0)
+  {
+    Options options;
+    options.interestLifetime = time::seconds(1);
+    options.maxRetriesOnTimeoutOrNack = 1;
+    validator = make_unique<ManifestValidator>(face, make_unique<ValidatorNull>(), options);
+
+    for (uint64_t segmentNo = 0; segmentNo < 100; ++segmentNo) {
+      auto data = make_shared<Data>(Name(versionedPrefix).appendSegment(segmentNo));
+      std::string content = "segment " + std::to_string(segmentNo);
+      data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+      segments.push_back(data);
+    }
+    auto leaves = signWithSha256(segments);
+
+    // 10 digests in each manifest segment
+    manifest = MerkleManifest::makeSegments(versionedPrefix, leaves, 320, time::seconds(1));
+    signData(manifest.front());
+    signWithSha256(std::vector<shared_ptr<Data>>(manifest.begin() + 1, manifest.end()));
+  }
+
+protected:
+  void
+  validate(const shared_ptr<Data>& data)
+  {
+    validator->validate(*data,
+                        [this] (const shared_ptr<const Data>&) { ++nValidated; },
+                        [this] (const shared_ptr<const Data>&, const std::string&) { ++nFailed; });
+  }
+
+  /**
+   * @brief answer the pending Interests for the manifest
+   */
+  void
+  answerManifestInterests()
+  {
+    while (!face.sentInterests.empty()) {
+      auto interests = face.sentInterests;
+      face.sentInterests.clear();
+      for (const auto& interest : interests) {
+        uint64_t segmentNo = interest.getName()[-1].toSegment();
+        BOOST_REQUIRE_LT(segmentNo, manifest.size());
+        face.receive(*manifest[segmentNo]);
+      }
+      advanceClocks(io, time::milliseconds(1));
+    }
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  Name versionedPrefix;
+  unique_ptr<ManifestValidator> validator;
+  std::vector<shared_ptr<Data>> segments;
+  std::vector<shared_ptr<Data>> manifest;
+  size_t nValidated;
+  size_t nFailed;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestManifestValidator, ManifestValidatorFixture)
+
+BOOST_AUTO_TEST_CASE(Validate)
+{
+  BOOST_REQUIRE_EQUAL(manifest.size(), 11);
+
+  // the segments submitted before the manifest is verified wait for it
+  for (size_t i = 0; i < 50; ++i)
+    validate(segments[i]);
+  advanceClocks(io, time::milliseconds(1));
+  BOOST_CHECK_EQUAL(nValidated, 0);
+
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentInterests[0].getName(),
+                    Name(MerkleManifest::getPrefix(versionedPrefix)).appendSegment(0));
+
+  answerManifestInterests();
+  BOOST_CHECK_EQUAL(nValidated, 50);
+  BOOST_CHECK_EQUAL(nFailed, 0);
+
+  // the manifest is fetched only once
+  for (size_t i = 50; i < 100; ++i)
+    validate(segments[i]);
+  BOOST_CHECK_EQUAL(nValidated, 100);
+  BOOST_CHECK_EQUAL(nFailed, 0);
+  BOOST_CHECK(face.sentInterests.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TamperedSegment)
+{
+  answerManifestInterests();
+  validate(segments[0]);
+  answerManifestInterests();
+  BOOST_CHECK_EQUAL(nValidated, 1);
+
+  // a correct DigestSha256 that does not match the manifest
+  auto tampered = make_shared<Data>(*segments[1]);
+  tampered->setContent(reinterpret_cast<const uint8_t*>("tampered"), 8);
+  signWithSha256({tampered});
+  validate(tampered);
+  BOOST_CHECK_EQUAL(nFailed, 1);
+
+  // no digest for this segment
+  auto extra = make_shared<Data>(Name(versionedPrefix).appendSegment(100));
+  signWithSha256({extra});
+  validate(extra);
+  BOOST_CHECK_EQUAL(nFailed, 2);
+  BOOST_CHECK_EQUAL(nValidated, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TamperedManifest)
+{
+  // the digests do not match the root anymore
+  manifest[5]->setContent(manifest[4]->getContent().value(), manifest[4]->getContent().value_size());
+  signWithSha256({manifest[5]});
+
+  validate(segments[0]);
+  validate(segments[1]);
+  answerManifestInterests();
+  BOOST_CHECK_EQUAL(nValidated, 0);
+  BOOST_CHECK_EQUAL(nFailed, 2);
+
+  // the failure is remembered
+  validate(segments[2]);
+  BOOST_CHECK_EQUAL(nFailed, 3);
+  BOOST_CHECK(face.sentInterests.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ManifestTimeout)
+{
+  validate(segments[0]);
+  advanceClocks(io, time::milliseconds(1));
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 1);
+
+  // the Interest is retransmitted once
+  advanceClocks(io, time::milliseconds(100), 25);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK_EQUAL(nValidated, 0);
+  BOOST_CHECK_EQUAL(nFailed, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestManifestValidator
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
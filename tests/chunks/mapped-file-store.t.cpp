@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/mapped-file-store.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class MappedFileStoreFixture
+{
+public:
+  MappedFileStoreFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "MappedFileStoreTest")
+    , filePath((tmpPath / "input").string())
+    , prefix(Name("/ndn/chunks/test").appendVersion(1))
+    , maxSegmentSize(40)
+  {
+    boost::filesystem::create_directories(tmpPath);
+  }
+
+  ~MappedFileStoreFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  void
+  writeInput(const std::string& content)
+  {
+    std::ofstream os(filePath, std::ios::binary);
+    os << content;
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  std::string filePath;
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix;
+  size_t maxSegmentSize;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestMappedFileStore, MappedFileStoreFixture)
+
+BOOST_AUTO_TEST_CASE(Segments)
+{
+  std::string content(maxSegmentSize * 3 + 7, 'a');
+  for (size_t i = 0; i < content.size(); ++i)
+    content[i] += i % 26;
+  writeInput(content);
+
+  MappedFileStore store(filePath, prefix, keyChain, signingInfo, time::seconds(10),
+                        maxSegmentSize, 10);
+  BOOST_REQUIRE_EQUAL(store.getNSegments(), 4);
+  // the segments are signed only when they are requested
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 0);
+
+  std::string retrieved;
+  for (uint64_t i = 0; i < store.getNSegments(); ++i) {
+    auto data = store.getSegment(i);
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL(data->getName(), Name(prefix).appendSegment(i));
+    BOOST_CHECK_EQUAL(data->getFinalBlockId().toSegment(), 3);
+    BOOST_CHECK(data->getFreshnessPeriod() == time::seconds(10));
+    BOOST_CHECK_EQUAL(data->getSignature().getKeyLocator().getName(),
+                      keyChain.getDefaultCertificateName().getPrefix(-1));
+    retrieved.append(reinterpret_cast<const char*>(data->getContent().value()),
+                     data->getContent().value_size());
+  }
+  BOOST_CHECK_EQUAL(retrieved, content);
+
+  BOOST_CHECK(store.getSegment(4) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyFile)
+{
+  writeInput("");
+
+  MappedFileStore store(filePath, prefix, keyChain, signingInfo, time::seconds(10),
+                        maxSegmentSize, 10);
+  BOOST_REQUIRE_EQUAL(store.getNSegments(), 1);
+
+  auto data = store.getSegment(0);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getContent().value_size(), 0);
+  BOOST_CHECK_EQUAL(data->getFinalBlockId().toSegment(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LruCache)
+{
+  writeInput(std::string(maxSegmentSize * 3, 'a'));
+
+  MappedFileStore store(filePath, prefix, keyChain, signingInfo, time::seconds(10),
+                        maxSegmentSize, 2);
+
+  auto data = store.getSegment(0);
+  BOOST_CHECK_EQUAL(store.getSegment(0), data);
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 1);
+
+  store.getSegment(1);
+  // segment 0 is more recently used than segment 1
+  store.getSegment(0);
+  store.getSegment(2);
+  BOOST_CHECK_EQUAL(store.getNCachedSegments(), 2);
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 3);
+
+  BOOST_CHECK_EQUAL(store.getSegment(0), data);
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 3);
+
+  // segment 1 has been evicted
+  store.getSegment(1);
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(ModifiedInPlace)
+{
+  writeInput(std::string(100, 'a'));
+  MappedFileStore store(filePath, prefix, keyChain, signingInfo, time::seconds(10),
+                        maxSegmentSize, 10);
+  BOOST_REQUIRE(store.getSegment(0) != nullptr);
+  BOOST_CHECK(!store.isModified());
+
+  // the file is truncated, its last segments are no longer mapped
+  writeInput(std::string(10, 'b'));
+  BOOST_CHECK(store.isModified());
+  BOOST_CHECK(store.getSegment(2) == nullptr);
+
+  // the segments signed before the modification are still served
+  auto data = store.getSegment(0);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getContent().value()[0], 'a');
+  BOOST_CHECK_EQUAL(store.getNSignedSegments(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(MissingFile)
+{
+  BOOST_CHECK_THROW(MappedFileStore(filePath, prefix, keyChain, signingInfo, time::seconds(10),
+                                    maxSegmentSize, 10),
+                    MappedFileStore::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMappedFileStore
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
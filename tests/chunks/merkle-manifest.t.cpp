@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/common/merkle-manifest.hpp"
+#include "tools/chunks/common/digest-signing.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+static Sha256Digest
+makeLeaf(uint8_t value)
+{
+  Sha256Digest leaf;
+  leaf.fill(value);
+  return leaf;
+}
+
+static Sha256Digest
+hashPair(const Sha256Digest& left, const Sha256Digest& right)
+{
+  util::Sha256 sha;
+  sha.update(left.data(), left.size());
+  sha.update(right.data(), right.size());
+  auto digest = sha.computeDigest();
+
+  Sha256Digest result;
+  std::copy(digest->begin(), digest->end(), result.begin());
+  return result;
+}
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestMerkleManifest)
+
+BOOST_AUTO_TEST_CASE(ComputeRoot)
+{
+  auto a = makeLeaf(1), b = makeLeaf(2), c = makeLeaf(3), d = makeLeaf(4), e = makeLeaf(5);
+
+  BOOST_CHECK(MerkleManifest::computeRoot({a}) == a);
+  BOOST_CHECK(MerkleManifest::computeRoot({a, b}) == hashPair(a, b));
+
+  // the node without sibling is moved up
+  BOOST_CHECK(MerkleManifest::computeRoot({a, b, c}) == hashPair(hashPair(a, b), c));
+  BOOST_CHECK(MerkleManifest::computeRoot({a, b, c, d}) ==
+              hashPair(hashPair(a, b), hashPair(c, d)));
+  BOOST_CHECK(MerkleManifest::computeRoot({a, b, c, d, e}) ==
+              hashPair(hashPair(hashPair(a, b), hashPair(c, d)), e));
+}
+
+BOOST_AUTO_TEST_CASE(MakeSegments)
+{
+  Name versionedPrefix = Name("/ndn/chunks/test").appendVersion(1);
+  std::vector<Sha256Digest> leaves;
+  for (uint8_t i = 0; i < 5; ++i)
+    leaves.push_back(makeLeaf(i));
+
+  // two leaves in each segment
+  auto segments = MerkleManifest::makeSegments(versionedPrefix, leaves, 70, time::seconds(1));
+  BOOST_REQUIRE_EQUAL(segments.size(), 4);
+
+  Name prefix = MerkleManifest::getPrefix(versionedPrefix);
+  BOOST_CHECK_EQUAL(prefix, Name(versionedPrefix).append("_manifest"));
+
+  auto root = MerkleManifest::computeRoot(leaves);
+  BOOST_CHECK_EQUAL_COLLECTIONS(segments[0]->getContent().value_begin(),
+                                segments[0]->getContent().value_end(), root.begin(), root.end());
+
+  std::vector<uint8_t> content;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    BOOST_CHECK_EQUAL(segments[i]->getName(), Name(prefix).appendSegment(i));
+    BOOST_CHECK_EQUAL(segments[i]->getFinalBlockId().toSegment(), 3);
+    if (i > 0)
+      content.insert(content.end(), segments[i]->getContent().value_begin(),
+                     segments[i]->getContent().value_end());
+  }
+
+  std::vector<uint8_t> expected;
+  for (const auto& leaf : leaves)
+    expected.insert(expected.end(), leaf.begin(), leaf.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(content.begin(), content.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(SignWithSha256)
+{
+  std::vector<shared_ptr<Data>> packets;
+  for (size_t i = 0; i < 10; ++i) {
+    packets.push_back(makeData(Name("/ndn/chunks/test").appendSegment(i)));
+    packets.back()->setContent(std::vector<uint8_t>(i * 100, 'a').data(), i * 100);
+  }
+
+  auto digests = signWithSha256(packets);
+  BOOST_REQUIRE_EQUAL(digests.size(), packets.size());
+
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const auto& signature = packets[i]->getSignature();
+    BOOST_CHECK_EQUAL(signature.getType(), tlv::DigestSha256);
+    BOOST_CHECK(Validator::verifySignature(*packets[i], DigestSha256(signature)));
+    BOOST_CHECK_EQUAL_COLLECTIONS(signature.getValue().value_begin(),
+                                  signature.getValue().value_end(),
+                                  digests[i].begin(), digests[i].end());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMerkleManifest
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/common/multi-buffer-sha256.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestMultiBufferSha256)
+
+BOOST_AUTO_TEST_CASE(KnownDigest)
+{
+  std::string abc("abc");
+  auto digests = computeSha256Digests({{reinterpret_cast<const uint8_t*>(abc.data()), abc.size()}});
+
+  const uint8_t expected[] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+  };
+  BOOST_REQUIRE_EQUAL(digests.size(), 1);
+  BOOST_CHECK_EQUAL_COLLECTIONS(digests[0].begin(), digests[0].end(),
+                                expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(DifferentSizes)
+{
+  // sizes around the block boundaries and the padding boundaries, in groups of mixed sizes
+  std::vector<size_t> sizes{0, 1, 55, 56, 57, 63, 64, 65, 119, 120, 128, 1000, 4400, 8800, 3};
+  std::vector<std::vector<uint8_t>> contents;
+  std::vector<std::pair<const uint8_t*, size_t>> buffers;
+  for (size_t size : sizes) {
+    contents.emplace_back(size);
+    for (size_t i = 0; i < size; ++i)
+      contents.back()[i] = static_cast<uint8_t>(i * 7 + size);
+  }
+  for (const auto& content : contents)
+    buffers.emplace_back(content.data(), content.size());
+
+  auto digests = computeSha256Digests(buffers);
+  BOOST_REQUIRE_EQUAL(digests.size(), sizes.size());
+
+  for (size_t i = 0; i < contents.size(); ++i) {
+    auto expected = util::Sha256::computeDigest(contents[i].data(), contents[i].size());
+    BOOST_CHECK_EQUAL_COLLECTIONS(digests[i].begin(), digests[i].end(),
+                                  expected->begin(), expected->end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  BOOST_CHECK(computeSha256Digests({}).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMultiBufferSha256
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/object-server.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ObjectServerFixture
+{
+public:
+  ObjectServerFixture()
+    : face(io, {true, true})
+    , prefix("/ndn/chunks/server")
+    , tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "ObjectServerTest")
+  {
+    boost::filesystem::create_directories(tmpPath);
+  }
+
+  ~ObjectServerFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  /**
+   * @return the path of a file with @p content, at @p relativePath under the test directory
+   */
+  std::string
+  writeFile(const std::string& relativePath, const std::string& content)
+  {
+    auto path = tmpPath / relativePath;
+    boost::filesystem::create_directories(path.parent_path());
+    std::ofstream os(path.string(), std::ios::binary);
+    os << content;
+    return path.string();
+  }
+
+  /**
+   * @return the Data sent in reply to an Interest for @p name, or nullptr if none
+   */
+  shared_ptr<Data>
+  express(const Name& name)
+  {
+    size_t nSentData = face.sentData.size();
+    face.receive(*makeInterest(name));
+    face.processEvents();
+    if (face.sentData.size() == nSentData)
+      return nullptr;
+    return make_shared<Data>(face.sentData.back());
+  }
+
+  static std::string
+  getContent(const Data& data)
+  {
+    return std::string(reinterpret_cast<const char*>(data.getContent().value()),
+                       data.getContent().value_size());
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix;
+  boost::filesystem::path tmpPath;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestObjectServer, ObjectServerFixture)
+
+BOOST_AUTO_TEST_CASE(AddRemove)
+{
+  ObjectServer server(prefix, face, keyChain, signingInfo, time::seconds(10), 40, 16, 2);
+  auto path = writeFile("file", "content");
+
+  BOOST_CHECK(server.addObject("/a", 1, path));
+  BOOST_CHECK(!server.addObject("/a", 1, path));
+  BOOST_CHECK(server.addObject("/a", 2, path));
+  BOOST_CHECK(server.addObject("/a/b", 1, path));
+  BOOST_CHECK_EQUAL(server.getNObjects(), 2);
+  BOOST_CHECK_EQUAL(server.getNVersions(), 3);
+
+  // the oldest version is removed beyond the maximum
+  BOOST_CHECK(server.addObject("/a", 3, path));
+  BOOST_CHECK_EQUAL(server.getNVersions(), 3);
+
+  BOOST_CHECK_THROW(server.addObject("/c", 1, (tmpPath / "missing").string()),
+                    MappedFileStore::Error);
+  BOOST_CHECK_EQUAL(server.getNObjects(), 2);
+
+  BOOST_CHECK(!server.removeObject("/a/c"));
+  BOOST_CHECK(!server.removeObject("/c"));
+  BOOST_CHECK(server.removeObject("/a"));
+  BOOST_CHECK(!server.removeObject("/a"));
+  BOOST_CHECK_EQUAL(server.getNObjects(), 1);
+  BOOST_CHECK_EQUAL(server.getNVersions(), 1);
+
+  // the objects below a removed object are still published
+  BOOST_CHECK(server.removeObject("/a/b"));
+  BOOST_CHECK_EQUAL(server.getNObjects(), 0);
+  BOOST_CHECK_EQUAL(server.getNVersions(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch)
+{
+  ObjectServer server(prefix, face, keyChain, signingInfo, time::seconds(10), 40, 16, 2);
+  server.addObject("/a", 1, writeFile("a1", "a version 1"));
+  server.addObject("/a", 2, writeFile("a2", std::string(50, 'a')));
+  server.addObject("/a/b", 1, writeFile("b1", "b version 1"));
+  server.addObject("/c/d", 5, writeFile("d5", "d version 5"));
+  io.poll();
+
+  // segment retrieval
+  auto data = express(Name(prefix).append("a").appendVersion(1).appendSegment(0));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "a version 1");
+  BOOST_CHECK_EQUAL(data->getFinalBlockId().toSegment(), 0);
+
+  data = express(Name(prefix).append("a").appendVersion(2).appendSegment(1));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), std::string(10, 'a'));
+
+  // an object below another object
+  data = express(Name(prefix).append("a").append("b").appendVersion(1).appendSegment(0));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "b version 1");
+
+  // discovery of the latest version
+  data = express(Name(prefix).append("a"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name(prefix).append("a").appendVersion(2).appendSegment(0));
+
+  data = express(Name(prefix).append("c").append("d"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name(prefix).append("c").append("d").appendVersion(5)
+                                                 .appendSegment(0));
+
+  // first segment of a version
+  data = express(Name(prefix).append("a").appendVersion(1));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name(prefix).append("a").appendVersion(1).appendSegment(0));
+
+  // no such object, version or segment
+  BOOST_CHECK(express(Name(prefix).append("x")) == nullptr);
+  BOOST_CHECK(express(Name(prefix).append("c")) == nullptr);
+  BOOST_CHECK(express(prefix) == nullptr);
+  BOOST_CHECK(express(Name(prefix).append("a").appendVersion(3).appendSegment(0)) == nullptr);
+  BOOST_CHECK(express(Name(prefix).append("a").appendVersion(1).appendSegment(1)) == nullptr);
+  BOOST_CHECK(express(Name(prefix).append("a").appendVersion(1).appendSegment(0)
+                                  .append("x")) == nullptr);
+  BOOST_CHECK(express(Name(prefix).append("c").append("d").append("x")) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(AddDirectory)
+{
+  writeFile("dir/file1", "content 1");
+  writeFile("dir/sub/file2", "content 2");
+  writeFile("dir/sub/sub/file3", "");
+
+  ObjectServer server(prefix, face, keyChain, signingInfo, time::seconds(10), 40, 16, 1);
+  BOOST_CHECK_EQUAL(server.addDirectory((tmpPath / "dir").string() + "/"), 3);
+  BOOST_CHECK_EQUAL(server.getNObjects(), 3);
+  io.poll();
+
+  auto data = express(Name(prefix).append("sub").append("file2"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "content 2");
+  BOOST_CHECK(data->getName()[-2].isVersion());
+
+  data = express(Name(prefix).append("sub").append("sub").append("file3"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "");
+
+  // the files have not been modified
+  BOOST_CHECK_EQUAL(server.addDirectory((tmpPath / "dir").string()), 0);
+  BOOST_CHECK_EQUAL(server.getNVersions(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(RescanDirectory)
+{
+  namespace fs = boost::filesystem;
+
+  writeFile("dir/deleted", "deleted");
+  writeFile("dir/modified", "modified");
+  writeFile("dir/replaced", "replaced");
+
+  ObjectServer server(prefix, face, keyChain, signingInfo, time::seconds(10), 40, 16, 2);
+  BOOST_CHECK_EQUAL(server.addDirectory((tmpPath / "dir").string()), 3);
+  io.poll();
+  auto oldReplaced = express(Name(prefix).append("replaced"));
+  BOOST_REQUIRE(oldReplaced != nullptr);
+
+  // the new versions are one minute newer
+  std::time_t newTime = fs::last_write_time(tmpPath / "dir" / "modified") + 60;
+
+  fs::remove(tmpPath / "dir" / "deleted");
+
+  writeFile("dir/modified", "modified again");
+  fs::last_write_time(tmpPath / "dir" / "modified", newTime);
+
+  writeFile("replaced.new", "replaced again");
+  fs::last_write_time(tmpPath / "replaced.new", newTime);
+  fs::rename(tmpPath / "replaced.new", tmpPath / "dir" / "replaced");
+
+  BOOST_CHECK_EQUAL(server.addDirectory((tmpPath / "dir").string()), 2);
+  BOOST_CHECK_EQUAL(server.getNObjects(), 2);
+  // the previous version of the file modified in place is removed
+  BOOST_CHECK_EQUAL(server.getNVersions(), 3);
+
+  BOOST_CHECK(express(Name(prefix).append("deleted")) == nullptr);
+
+  auto data = express(Name(prefix).append("modified"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "modified again");
+
+  data = express(Name(prefix).append("replaced"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "replaced again");
+
+  // the previous version of the replaced file is still mapped to its original content
+  data = express(Name(prefix).append("replaced").append(oldReplaced->getName()[-2])
+                   .appendSegment(0));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(getContent(*data), "replaced");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestObjectServer
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
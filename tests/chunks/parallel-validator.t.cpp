@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/parallel-validator.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <chrono>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/**
+ * @brief accepts the Data packets with an even segment number
+ */
+class EvenSegmentValidator : public Validator
+{
+protected:
+  void
+  checkPolicy(const Interest& interest,
+              int nSteps,
+              const OnInterestValidated& onValidated,
+              const OnInterestValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE
+  {
+    onValidationFailed(interest.shared_from_this(), "unexpected Interest");
+  }
+
+  void
+  checkPolicy(const Data& data,
+              int nSteps,
+              const OnDataValidated& onValidated,
+              const OnDataValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE
+  {
+    if (data.getName()[-1].toSegment() % 2 == 0)
+      onValidated(data.shared_from_this());
+    else
+      onValidationFailed(data.shared_from_this(), "odd segment");
+  }
+};
+
+class ParallelValidatorFixture
+{
+public:
+  ParallelValidatorFixture()
+    : validator(io, 4, [] { return make_unique<EvenSegmentValidator>(); })
+  {
+  }
+
+  /**
+   * @brief run the io_service until @p nResults validation callbacks have been invoked
+   */
+  void
+  waitResults(size_t nResults)
+  {
+    for (int i = 0; i < 1000 && validated.size() + failed.size() < nResults; ++i) {
+      io.poll();
+      io.reset();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+protected:
+  boost::asio::io_service io;
+  ParallelValidator validator;
+  std::set<uint64_t> validated;
+  std::set<uint64_t> failed;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestParallelValidator, ParallelValidatorFixture)
+
+BOOST_AUTO_TEST_CASE(ValidateData)
+{
+  BOOST_CHECK_EQUAL(validator.getNThreads(), 4);
+
+  const uint64_t nSegments = 100;
+  for (uint64_t i = 0; i < nSegments; ++i) {
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+    validator.validate(*data,
+                       [this] (const shared_ptr<const Data>& data) {
+                         validated.insert(data->getName()[-1].toSegment());
+                       },
+                       [this] (const shared_ptr<const Data>& data, const std::string& reason) {
+                         BOOST_CHECK_EQUAL(reason, "odd segment");
+                         failed.insert(data->getName()[-1].toSegment());
+                       });
+  }
+
+  // the callbacks are only invoked on the thread of the io_service
+  BOOST_CHECK(validated.empty());
+  BOOST_CHECK(failed.empty());
+
+  waitResults(nSegments);
+  BOOST_REQUIRE_EQUAL(validated.size(), nSegments / 2);
+  BOOST_REQUIRE_EQUAL(failed.size(), nSegments / 2);
+  for (uint64_t i = 0; i < nSegments; ++i)
+    BOOST_CHECK_EQUAL(validated.count(i), i % 2 == 0 ? 1 : 0);
+}
+
+BOOST_AUTO_TEST_CASE(RejectInterest)
+{
+  bool hasFailed = false;
+  validator.validate(*makeInterest("/ndn/chunks/test"),
+                     [] (const shared_ptr<const Interest>&) { BOOST_FAIL("unexpected validation"); },
+                     [&hasFailed] (const shared_ptr<const Interest>&, const std::string&) {
+                       hasFailed = true;
+                     });
+  BOOST_CHECK(hasFailed);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestParallelValidator
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -41,9 +41,16 @@ public:
   typedef PipelineInterestsOptions Options;
 
 public:
-  PipelineInterestsFixture()
+  explicit
+  PipelineInterestsFixture(bool useSegmentTable = false)
+    : PipelineInterestsFixture(makeOptions(useSegmentTable))
+  {
+  }
+
+  explicit
+  PipelineInterestsFixture(const Options& options)
     : face(io)
-    , opt(makeOptions())
+    , opt(options)
     , name("/ndn/chunks/test")
     , pipeline(face, opt)
     , nDataSegments(0)
@@ -70,30 +77,42 @@ protected:
                                     bind(&PipelineInterestsFixture::onFailure, this, _1));
   }
 
-private:
   void
-  onData(const Interest& interest, const Data& data)
+  runWithSegments(const std::vector<uint64_t>& segments)
   {
-    nReceivedSegments++;
-  }
-
-  void
-  onFailure(const std::string& reason)
-  {
-    hasFailed = true;
+    pipeline.runWithSegments(Name(name).appendVersion(0), nDataSegments - 1, segments,
+                             bind(&PipelineInterestsFixture::onData, this, _1, _2),
+                             bind(&PipelineInterestsFixture::onFailure, this, _1));
   }
 
   static Options
-  makeOptions()
+  makeOptions(bool useSegmentTable)
   {
     Options options;
     options.isVerbose = false;
     options.interestLifetime = time::seconds(1);
     options.maxRetriesOnTimeoutOrNack = 3;
     options.maxPipelineSize = 5;
+    if (useSegmentTable) {
+      options.startPipelineSize = options.maxPipelineSize;
+      options.useSegmentTable = true;
+    }
     return options;
   }
 
+private:
+  void
+  onData(const Interest& interest, const Data& data)
+  {
+    nReceivedSegments++;
+  }
+
+  void
+  onFailure(const std::string& reason)
+  {
+    hasFailed = true;
+  }
+
 protected:
   boost::asio::io_service io;
   util::DummyClientFace face;
@@ -370,6 +389,385 @@ BOOST_FIXTURE_TEST_CASE(CongestionAllSegments, PipelineInterestsFixture)
   BOOST_CHECK_EQUAL(hasFailed, true);
 }
 
+class PipelineInterestsTableFixture : public PipelineInterestsFixture
+{
+public:
+  PipelineInterestsTableFixture()
+    : PipelineInterestsFixture(true)
+  {
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(TableFullPipeline, PipelineInterestsTableFixture)
+{
+  nDataSegments = 13;
+  BOOST_ASSERT(nDataSegments > opt.maxPipelineSize);
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  for (uint64_t i = 0; i < nDataSegments - 1; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(io, time::nanoseconds(1), 1);
+    BOOST_CHECK_EQUAL(nReceivedSegments, i + 1);
+
+    if (i < nDataSegments - opt.maxPipelineSize - 1) {
+      BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize + i + 1);
+      // the segment that has just been received frees a slot for the next one
+      auto sentInterest = face.sentInterests.back();
+      BOOST_CHECK_EQUAL(sentInterest.getMaxSuffixComponents(), 1);
+      BOOST_CHECK_EQUAL(sentInterest.getMustBeFresh(), opt.mustBeFresh);
+      BOOST_CHECK_EQUAL(Name(name).isPrefixOf(sentInterest.getName()), true);
+      BOOST_CHECK_EQUAL(sentInterest.getName()[-1].toSegment(), opt.maxPipelineSize + i);
+    }
+    else {
+      // all the interests have been sent for all the segments
+      BOOST_CHECK_EQUAL(face.sentInterests.size(), nDataSegments - 1);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(TableTimeHistograms, PipelineInterestsTableFixture)
+{
+  nDataSegments = 3;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+
+  advanceClocks(io, time::milliseconds(10), 1);
+  face.receive(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // segment 1 is retransmitted, so its round trip time is ambiguous
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  face.receive(*makeDataWithSegment(1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 2);
+
+  BOOST_CHECK_EQUAL(pipeline.rttHistogram.getTotalCount(), 1);
+  BOOST_CHECK_EQUAL(pipeline.rttHistogram.getMax(), 10000);
+  BOOST_CHECK_EQUAL(pipeline.retrievalTimeHistogram.getTotalCount(), 2);
+  BOOST_CHECK_GT(pipeline.retrievalTimeHistogram.getMax(), 1000000);
+}
+
+BOOST_FIXTURE_TEST_CASE(TableTimeoutAllSegments, PipelineInterestsTableFixture)
+{
+  nDataSegments = 13;
+  BOOST_ASSERT(nDataSegments > opt.maxPipelineSize);
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  for (int i = 0; i < opt.maxRetriesOnTimeoutOrNack; ++i) {
+    advanceClocks(io, opt.interestLifetime, 1);
+    BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize * (i + 2));
+    BOOST_CHECK_EQUAL(nReceivedSegments, 0);
+
+    // A single retry for every segment in the window
+    for (size_t j = 0; j < opt.maxPipelineSize; ++j) {
+      auto interest = face.sentInterests[(opt.maxPipelineSize * (i + 1)) + j];
+      BOOST_CHECK_EQUAL(static_cast<size_t>(interest.getName()[-1].toSegment()), j);
+    }
+  }
+
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_CHECK_EQUAL(hasFailed, true);
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(TableCongestionAllSegments, PipelineInterestsTableFixture)
+{
+  nDataSegments = 13;
+  BOOST_ASSERT(nDataSegments > opt.maxPipelineSize);
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  for (int i = 0; i < opt.maxRetriesOnTimeoutOrNack; ++i) {
+    for (size_t j = 0; j < opt.maxPipelineSize; j++) {
+      auto nack = make_shared<lp::Nack>(face.sentInterests[(opt.maxPipelineSize * i) + j]);
+      nack->setReason(lp::NackReason::CONGESTION);
+      face.receive(*nack);
+    }
+    advanceClocks(io, time::nanoseconds(1), 1);
+    BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize * (i + 1));
+
+    // the backoff time doubles at every consecutive congestion Nack
+    advanceClocks(io, time::milliseconds(1 << i), 1);
+    BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize * (i + 2));
+  }
+
+  for (size_t j = 0; j < opt.maxPipelineSize; j++) {
+    auto nack = make_shared<lp::Nack>(face.sentInterests[(opt.maxPipelineSize * opt.maxRetriesOnTimeoutOrNack) + j]);
+    nack->setReason(lp::NackReason::CONGESTION);
+    face.receive(*nack);
+  }
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  BOOST_CHECK_EQUAL(hasFailed, true);
+}
+
+BOOST_FIXTURE_TEST_CASE(TableMissingSegments, PipelineInterestsTableFixture)
+{
+  nDataSegments = 13;
+  std::vector<uint64_t> missingSegments{1, 4, 6, 7, 8, 10, 12};
+  BOOST_ASSERT(missingSegments.size() > opt.maxPipelineSize);
+
+  runWithSegments(missingSegments);
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  for (size_t i = 0; i < missingSegments.size(); ++i) {
+    // only the missing segments are requested, in the given order
+    BOOST_REQUIRE_GT(face.sentInterests.size(), i);
+    BOOST_CHECK_EQUAL(face.sentInterests[i].getName()[-1].toSegment(), missingSegments[i]);
+
+    face.receive(*makeDataWithSegment(missingSegments[i]));
+    advanceClocks(io, time::nanoseconds(1), 1);
+    BOOST_CHECK_EQUAL(nReceivedSegments, i + 1);
+  }
+
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), missingSegments.size());
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(TableReceiveWindow, PipelineInterestsTableFixture)
+{
+  nDataSegments = 13;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // no new Interest while 2 or more segments are in flight
+  pipeline.setReceiveWindow(2);
+  for (uint64_t i = 0; i < opt.maxPipelineSize - 2; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(io, time::nanoseconds(1), 1);
+  }
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), 2);
+
+  // raising the limit fills the congestion window again
+  pipeline.setReceiveWindow(opt.maxPipelineSize);
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), opt.maxPipelineSize * 2 - 2);
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+class PipelineInterestsLossDetectionFixture : public PipelineInterestsFixture
+{
+public:
+  PipelineInterestsLossDetectionFixture()
+    : PipelineInterestsFixture(makeLossDetectionOptions())
+  {
+  }
+
+private:
+  static Options
+  makeLossDetectionOptions()
+  {
+    Options options = makeOptions(true);
+    options.useLossDetection = true;
+    options.reorderThreshold = 3;
+    return options;
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(GapLossDetection, PipelineInterestsLossDetectionFixture)
+{
+  nDataSegments = 13;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // segment 0 is lost, the next ones are received
+  for (uint64_t i = 1; i < opt.reorderThreshold; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(io, time::nanoseconds(1), 1);
+    BOOST_CHECK_EQUAL(face.sentInterests.back().getName()[-1].toSegment(), opt.maxPipelineSize + i - 1);
+  }
+
+  // the third later segment triggers the retransmission, long before the Interest lifetime
+  size_t nSentInterests = face.sentInterests.size();
+  face.receive(*makeDataWithSegment(opt.reorderThreshold));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  bool isRetransmitted = false;
+  for (size_t i = nSentInterests; i < face.sentInterests.size(); ++i)
+    isRetransmitted = isRetransmitted || face.sentInterests[i].getName()[-1].toSegment() == 0;
+  BOOST_CHECK(isRetransmitted);
+
+  face.receive(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(nReceivedSegments, opt.reorderThreshold + 1);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(RetxTimer, PipelineInterestsLossDetectionFixture)
+{
+  nDataSegments = 13;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // measure an RTT of 20 ms
+  advanceClocks(io, time::milliseconds(20), 1);
+  face.receive(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_NE(pipeline.rttEstimator.getRTO(), -1);
+  BOOST_REQUIRE_LT(pipeline.rttEstimator.getRTO(), 500);
+
+  // the segment sent after the RTT measurement is retransmitted on RTO, well before the
+  // lifetime of its Interest and of the Interests sent before the measurement
+  size_t nSentInterests = face.sentInterests.size();
+  BOOST_REQUIRE_EQUAL(face.sentInterests.back().getName()[-1].toSegment(), opt.maxPipelineSize);
+  BOOST_CHECK(face.sentInterests.back().getInterestLifetime() >= time::milliseconds(500));
+
+  advanceClocks(io, time::milliseconds(1), 300);
+  BOOST_REQUIRE_GT(face.sentInterests.size(), nSentInterests);
+  BOOST_CHECK_EQUAL(face.sentInterests[nSentInterests].getName()[-1].toSegment(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(RetxTimerSubMillisecondRtt, PipelineInterestsLossDetectionFixture)
+{
+  nDataSegments = 13;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // the RTT is truncated to 0 ms, and so is the RTO
+  face.receive(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_NE(pipeline.rttEstimator.getRTO(), -1);
+
+  // the retransmission timer is not shorter than the minimum
+  size_t nSentInterests = face.sentInterests.size();
+  BOOST_REQUIRE_EQUAL(face.sentInterests.back().getName()[-1].toSegment(), opt.maxPipelineSize);
+  advanceClocks(io, time::milliseconds(1),
+                PipelineInterests::MIN_RETX_TIMEOUT.count() - 10);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), nSentInterests);
+
+  advanceClocks(io, time::milliseconds(1), 100);
+  BOOST_REQUIRE_GT(face.sentInterests.size(), nSentInterests);
+  BOOST_CHECK_EQUAL(face.sentInterests[nSentInterests].getName()[-1].toSegment(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+class PipelineInterestsMultipathFixture : public PipelineInterestsFixture
+{
+public:
+  PipelineInterestsMultipathFixture()
+    : PipelineInterestsFixture(true)
+    , mirrorFace(io)
+    , mirrorName("/mirror/chunks/test")
+  {
+    pipeline.addPath(mirrorFace, mirrorName);
+  }
+
+  ~PipelineInterestsMultipathFixture()
+  {
+    // the path over mirrorFace is stopped before the face is destroyed
+    pipeline.cancel();
+  }
+
+protected:
+  /**
+   * @brief answer the Interests sent on face, including the ones sent in the meantime
+   */
+  void
+  answerAll()
+  {
+    for (size_t i = 0; i < face.sentInterests.size(); ++i) {
+      face.receive(*makeDataWithSegment(face.sentInterests[i].getName()[-1].toSegment()));
+      advanceClocks(io, time::nanoseconds(1), 1);
+    }
+  }
+
+  void
+  nackFirst(util::DummyClientFace& nackFace)
+  {
+    auto nack = make_shared<lp::Nack>(nackFace.sentInterests.front());
+    nack->setReason(lp::NackReason::NO_ROUTE);
+    nackFace.receive(*nack);
+    advanceClocks(io, time::nanoseconds(1), 1);
+  }
+
+protected:
+  util::DummyClientFace mirrorFace;
+  Name mirrorName;
+};
+
+BOOST_FIXTURE_TEST_CASE(MultipathFasterPath, PipelineInterestsMultipathFixture)
+{
+  nDataSegments = 21;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+  BOOST_REQUIRE_EQUAL(mirrorFace.sentInterests.size(), opt.maxPipelineSize);
+  BOOST_CHECK(Name(mirrorName).appendVersion(0).isPrefixOf(mirrorFace.sentInterests[0].getName()));
+
+  // the mirror never answers: the first path fetches the remaining segments, then requests again
+  // the ones in flight on the mirror
+  answerAll();
+
+  BOOST_CHECK_EQUAL(nReceivedSegments, nDataSegments - 1);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), nDataSegments - 1);
+  BOOST_CHECK_EQUAL(mirrorFace.sentInterests.size(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(face.getNPendingInterests(), 0);
+  BOOST_CHECK_EQUAL(mirrorFace.getNPendingInterests(), 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(MultipathPathFailure, PipelineInterestsMultipathFixture)
+{
+  nDataSegments = 21;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(mirrorFace.sentInterests.size(), opt.maxPipelineSize);
+
+  // the mirror gives up its segments to the first path
+  nackFirst(mirrorFace);
+  BOOST_CHECK_EQUAL(mirrorFace.getNPendingInterests(), 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+
+  answerAll();
+
+  BOOST_CHECK_EQUAL(nReceivedSegments, nDataSegments - 1);
+  BOOST_CHECK_EQUAL(mirrorFace.sentInterests.size(), opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(MultipathAllPathsFail, PipelineInterestsMultipathFixture)
+{
+  nDataSegments = 21;
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  nackFirst(mirrorFace);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+
+  nackFirst(face);
+  BOOST_CHECK_EQUAL(hasFailed, true);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestPipelineInterests
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
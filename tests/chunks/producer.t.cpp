@@ -28,8 +28,12 @@
 #include "tests/test-common.hpp"
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/filesystem.hpp>
 
 #include <cmath>
+#include <fstream>
 
 namespace ndn {
 namespace chunks {
@@ -74,6 +78,152 @@ BOOST_AUTO_TEST_CASE(InputData)
   }
 }
 
+BOOST_AUTO_TEST_CASE(ParallelSigning)
+{
+  util::DummyClientFace face;
+  KeyChain keyChain;
+  auto signingInfo = security::signingWithSha256();
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  std::string testString(1000, 'a');
+
+  std::istringstream serialStr(testString);
+  Producer serialProd(prefix, face, keyChain, signingInfo, time::seconds(4), 40, false, false,
+                      serialStr);
+
+  for (size_t nThreads : {2, 3, 25, 40}) {
+    size_t nKeyChains = 0;
+    Producer::SigningOptions signingOptions;
+    signingOptions.nThreads = nThreads;
+    signingOptions.makeKeyChain = [&nKeyChains] {
+      ++nKeyChains;
+      return make_unique<KeyChain>();
+    };
+
+    std::istringstream str(testString);
+    Producer prod(prefix, face, keyChain, signingInfo, time::seconds(4), 40, signingOptions,
+                  false, false, str);
+
+    // at most one thread per segment
+    BOOST_CHECK_EQUAL(nKeyChains, std::min<size_t>(nThreads, 25));
+
+    BOOST_REQUIRE_EQUAL(prod.m_store.size(), 25);
+    for (size_t i = 0; i < prod.m_store.size(); ++i) {
+      // the digest signature is deterministic, every segment must be signed as in the serial case
+      BOOST_CHECK(*prod.m_store[i] == *serialProd.m_store[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Manifest)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  std::istringstream testString(std::string(1000, 'a'));
+
+  Producer::SigningOptions signingOptions;
+  signingOptions.wantManifest = true;
+  Producer producer(prefix, face, keyChain, signingInfo, time::seconds(10), 100, signingOptions,
+                    false, false, testString);
+  io.poll();
+
+  // 10 segments and 3 leaves in each manifest segment
+  BOOST_REQUIRE_EQUAL(producer.m_store.size(), 10);
+  BOOST_REQUIRE_EQUAL(producer.m_manifest.size(), 5);
+
+  std::vector<Sha256Digest> leaves;
+  for (const auto& data : producer.m_store) {
+    BOOST_CHECK_EQUAL(data->getSignature().getType(), tlv::DigestSha256);
+    BOOST_CHECK(Validator::verifySignature(*data, DigestSha256(data->getSignature())));
+
+    leaves.emplace_back();
+    const Block& value = data->getSignature().getValue();
+    std::copy(value.value_begin(), value.value_end(), leaves.back().begin());
+  }
+
+  // only the manifest segment with the root is signed with the key
+  Name manifestPrefix = MerkleManifest::getPrefix(prefix);
+  face.receive(*makeInterest(Name(manifestPrefix).appendSegment(0)));
+  face.processEvents();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData[0].getSignature().getKeyLocator().getName(),
+                    keyChain.getDefaultCertificateName().getPrefix(-1));
+  auto root = MerkleManifest::computeRoot(leaves);
+  BOOST_CHECK_EQUAL_COLLECTIONS(face.sentData[0].getContent().value_begin(),
+                                face.sentData[0].getContent().value_end(),
+                                root.begin(), root.end());
+
+  face.receive(*makeInterest(Name(manifestPrefix).appendSegment(4)));
+  face.processEvents();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK_EQUAL(face.sentData[1].getSignature().getType(), tlv::DigestSha256);
+  BOOST_CHECK_EQUAL_COLLECTIONS(face.sentData[1].getContent().value_begin(),
+                                face.sentData[1].getContent().value_end(),
+                                leaves[9].begin(), leaves[9].end());
+
+  // no such manifest segment
+  face.receive(*makeInterest(Name(manifestPrefix).appendSegment(5)));
+  face.processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(WireStore)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  std::istringstream testString(std::string(100, 'a'));
+
+  Producer producer(prefix, face, keyChain, signingInfo, time::seconds(10), 40, false, false,
+                    testString);
+  io.poll();
+
+  BOOST_REQUIRE_EQUAL(producer.m_wireStore.size(), 3);
+  for (size_t i = 0; i < producer.m_store.size(); ++i) {
+    // the wire is shared with the Data, not copied
+    BOOST_CHECK(producer.m_wireStore[i].wire() == producer.m_store[i]->wireEncode().wire());
+  }
+
+  for (size_t i = 0; i < 3; ++i) {
+    face.receive(*makeInterest(Name(prefix).appendSegment(i)));
+    face.processEvents();
+
+    BOOST_REQUIRE_EQUAL(face.sentData.size(), i + 1);
+    BOOST_CHECK(face.sentData.back() == *producer.m_store[i]);
+  }
+
+  // repeated request
+  face.receive(*makeInterest(Name(prefix).appendSegment(1)));
+  face.processEvents();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 4);
+  BOOST_CHECK(face.sentData.back() == *producer.m_store[1]);
+}
+
+BOOST_AUTO_TEST_CASE(WireStoreOversizedSegment)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  std::istringstream testString(std::string(MAX_NDN_PACKET_SIZE, 'a'));
+
+  // the wire is sent without Face::put, which checks the size of the Data
+  Producer producer(prefix, face, keyChain, signingInfo, time::seconds(10), MAX_NDN_PACKET_SIZE,
+                    false, false, testString);
+  io.poll();
+  BOOST_REQUIRE_GT(producer.m_wireStore.at(0).size(), MAX_NDN_PACKET_SIZE);
+
+  BOOST_CHECK_THROW(face.receive(*makeInterest(Name(prefix).appendSegment(0)));
+                    face.processEvents(),
+                    Face::Error);
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(RequestSegmentUnspecifiedVersion)
 {
   boost::asio::io_service io;
@@ -225,6 +375,74 @@ BOOST_AUTO_TEST_CASE(RequestNotExistingSegment)
   BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(RequestSegmentMappedFile)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix("/ndn/chunks/test");
+  time::milliseconds freshnessPeriod(time::seconds(10));
+  size_t maxSegmentSize(40);
+  std::string testString(
+          "Lorem ipsum dolor sit amet, consectetuer adipiscing elit. Aenean commodo ligula eget "
+          "dolor. Aenean massa. Cum sociis natoque penatibus et magnis dis parturient montes, "
+          "nascetur ridiculus mus. Donec quam felis, ultricies nec, pellentesque eu, pretium quis, "
+          "sem. Nulla consequat massa Donec pede justo,");
+
+  boost::filesystem::path tmpPath = boost::filesystem::path(TMP_TESTS_PATH) / "ProducerTest";
+  boost::filesystem::create_directories(tmpPath);
+  std::string inputFile = (tmpPath / "input").string();
+  {
+    std::ofstream os(inputFile, std::ios::binary);
+    os << testString;
+  }
+
+  Producer producer(prefix, face, keyChain, signingInfo, freshnessPeriod, maxSegmentSize,
+                    inputFile, 2, false, false);
+  io.poll();
+
+  size_t nSegments = std::ceil(static_cast<double>(testString.size()) / maxSegmentSize);
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 0);
+  BOOST_REQUIRE(producer.m_mappedStore != nullptr);
+  BOOST_CHECK_EQUAL(producer.m_mappedStore->getNSegments(), nSegments);
+
+  // version request
+  face.receive(*makeInterest(prefix));
+  face.processEvents();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  auto lastData = face.sentData.back();
+  BOOST_REQUIRE_EQUAL(lastData.getName().size(), prefix.size() + 2);
+  BOOST_CHECK_EQUAL(lastData.getName()[-1].toSegment(), 0);
+  BOOST_REQUIRE(!lastData.getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(lastData.getFinalBlockId().toSegment(), nSegments - 1);
+
+  // every segment request
+  Name nameWithVersion(prefix);
+  nameWithVersion.append(lastData.getName()[-2]);
+  std::string retrieved;
+  for (size_t i = 0; i < nSegments; ++i) {
+    face.receive(*makeInterest(Name(nameWithVersion).appendSegment(i)));
+    face.processEvents();
+
+    BOOST_REQUIRE_EQUAL(face.sentData.size(), i + 2);
+    lastData = face.sentData.back();
+    BOOST_CHECK_EQUAL(lastData.getName()[-1].toSegment(), i);
+    retrieved.append(reinterpret_cast<const char*>(lastData.getContent().value()),
+                     lastData.getContent().value_size());
+  }
+  BOOST_CHECK_EQUAL(retrieved, testString);
+  BOOST_CHECK_LE(producer.m_mappedStore->getNCachedSegments(), 2);
+
+  // not existing segment
+  face.receive(*makeInterest(Name(nameWithVersion).appendSegment(nSegments)));
+  face.processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), nSegments + 1);
+
+  boost::filesystem::remove_all(tmpPath);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestProducer
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
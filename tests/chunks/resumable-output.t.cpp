@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/resumable-output.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <iterator>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ResumableOutputFixture
+{
+public:
+  ResumableOutputFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "ResumableOutputTest")
+    , filePath((tmpPath / "output").string())
+    , name(Name("/ndn/chunks/test").appendVersion(1))
+    , nSegments(5)
+    , segmentSize(10)
+  {
+    boost::filesystem::create_directories(tmpPath);
+
+    for (size_t i = 0; i < nSegments; ++i) {
+      // the last segment is shorter
+      size_t size = i + 1 < nSegments ? segmentSize : segmentSize / 2;
+      std::string content(size, static_cast<char>('a' + i));
+      expected += content;
+
+      auto data = makeData(Name(name).appendSegment(i));
+      data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+      data->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+      segments.push_back(signData(data));
+    }
+  }
+
+  ~ResumableOutputFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  std::string
+  readOutput()
+  {
+    std::ifstream is(filePath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  std::string filePath;
+  Name name;
+  size_t nSegments;
+  size_t segmentSize;
+  std::string expected;
+  std::vector<shared_ptr<Data>> segments;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestResumableOutput, ResumableOutputFixture)
+
+BOOST_AUTO_TEST_CASE(Resume)
+{
+  {
+    ResumableOutput output(filePath);
+    BOOST_CHECK_EQUAL(output.resume(name), false);
+    output.start(name, nSegments - 1);
+    BOOST_CHECK(boost::filesystem::exists(filePath + ".bitmap"));
+
+    output.addSegment(segments[0]);
+    output.addSegment(segments[2]);
+    output.addSegment(segments[4]);
+    output.sync();
+    output.addSegment(segments[3]);
+
+    // the segments are recorded in the sidecar only when they are synced
+    ResumableOutput other(filePath);
+    BOOST_REQUIRE(other.resume(name));
+    BOOST_CHECK_EQUAL(other.getLastSegmentNo(), nSegments - 1);
+    std::vector<uint64_t> missing{1, 3};
+    BOOST_CHECK(other.getMissingSegments() == missing);
+  }
+
+  ResumableOutput output(filePath);
+  BOOST_CHECK_EQUAL(output.resume(Name("/ndn/chunks/other").appendVersion(1)), false);
+  BOOST_REQUIRE(output.resume(name));
+  std::vector<uint64_t> missing{1};
+  BOOST_CHECK(output.getMissingSegments() == missing);
+  BOOST_CHECK_EQUAL(output.isComplete(), false);
+
+  // segments that have already been written are ignored
+  output.addSegment(segments[2]);
+  output.addSegment(segments[1]);
+  BOOST_CHECK_EQUAL(output.isComplete(), true);
+
+  output.sync();
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+  BOOST_CHECK(!boost::filesystem::exists(filePath + ".bitmap"));
+}
+
+BOOST_AUTO_TEST_CASE(StartOver)
+{
+  ResumableOutput first(filePath);
+  first.start(Name("/ndn/chunks/other").appendVersion(1), 9);
+  first.sync();
+
+  // the sidecar describes another transfer
+  ResumableOutput output(filePath);
+  output.start(name, nSegments - 1);
+  BOOST_CHECK_EQUAL(output.getMissingSegments().size(), nSegments);
+
+  for (size_t i = nSegments; i > 0; --i)
+    output.addSegment(segments[i - 1]);
+  BOOST_CHECK_EQUAL(output.isComplete(), true);
+
+  output.sync();
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(LastSegmentFirst)
+{
+  ResumableOutput output(filePath);
+  output.start(name, nSegments - 1);
+
+  // the offset of the last segment is not known yet
+  output.addSegment(segments[nSegments - 1]);
+  BOOST_CHECK_EQUAL(output.hasSegment(nSegments - 1), true);
+  output.sync();
+  BOOST_CHECK_EQUAL(readOutput().size(), 0);
+
+  for (size_t i = 0; i < nSegments - 1; ++i)
+    output.addSegment(segments[i]);
+  BOOST_CHECK_EQUAL(output.isComplete(), true);
+
+  output.sync();
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(WrongSegmentSize)
+{
+  ResumableOutput output(filePath);
+  output.start(name, nSegments - 1);
+  output.addSegment(segments[0]);
+
+  auto data = makeData(Name(name).appendSegment(1));
+  data->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+  BOOST_CHECK_THROW(output.addSegment(signData(data)), ResumableOutput::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestResumableOutput
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
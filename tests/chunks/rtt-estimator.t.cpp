@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/rtt-estimator.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class RttEstimatorFixture : public UnitTestTimeFixture
+{
+protected:
+  float
+  addSample(RttEstimator& estimator, int rttMs)
+  {
+    auto now = time::steady_clock::now();
+    return estimator.addRttMeasurement(now - time::milliseconds(rttMs),
+                                       now - time::milliseconds(rttMs), 1);
+  }
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestRttEstimator, RttEstimatorFixture)
+
+BOOST_AUTO_TEST_CASE(Ewma)
+{
+  RttEstimator estimator;
+  BOOST_CHECK_EQUAL(estimator.getRTO(), -1);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), -1);
+
+  BOOST_CHECK_EQUAL(addSample(estimator, 100), 100);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 100, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRttVar(), 50, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRTO(), 300, 0.001);
+
+  addSample(estimator, 200);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 112.5, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRttVar(), 62.5, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRTO(), 362.5, 0.001);
+
+  estimator.incrementRtoMultiplier();
+  BOOST_CHECK_CLOSE(estimator.getRTO(), 725, 0.001);
+
+  estimator.reset();
+  BOOST_CHECK_EQUAL(estimator.getRTO(), -1);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), -1);
+}
+
+BOOST_AUTO_TEST_CASE(WindowedMin)
+{
+  RttEstimator estimator(3);
+  BOOST_CHECK_EQUAL(estimator.getWindowSize(), 3);
+
+  addSample(estimator, 50);
+  addSample(estimator, 100);
+  addSample(estimator, 120);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), 50);
+
+  // the sample of 50 ms leaves the window
+  addSample(estimator, 130);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), 100);
+
+  addSample(estimator, 80);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), 80);
+
+  for (int i = 0; i < 3; ++i) {
+    addSample(estimator, 90 + i);
+  }
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), 90);
+}
+
+BOOST_AUTO_TEST_CASE(RetransmittedSegment)
+{
+  RttEstimator estimator;
+  addSample(estimator, 100);
+
+  // the last transmission gives a plausible sample
+  auto now = time::steady_clock::now();
+  BOOST_CHECK_EQUAL(estimator.addRttMeasurement(now - time::milliseconds(1100),
+                                                now - time::milliseconds(150), 2), 150);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 106.25, 0.001);
+
+  // the Data answers the first transmission
+  BOOST_CHECK_EQUAL(estimator.addRttMeasurement(now - time::milliseconds(300),
+                                                now - time::milliseconds(20), 2), 300);
+
+  // samples of retransmitted segments do not change the minimum RTT
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(Karn)
+{
+  RttEstimator estimator(RttEstimator::DEFAULT_WINDOW_SIZE, true);
+  addSample(estimator, 100);
+
+  auto now = time::steady_clock::now();
+  BOOST_CHECK_EQUAL(estimator.addRttMeasurement(now - time::milliseconds(1100),
+                                                now - time::milliseconds(150), 2), -1);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 100, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRttVar(), 50, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(Seed)
+{
+  RttEstimator estimator;
+  estimator.seed(-1, -1);
+  BOOST_CHECK_EQUAL(estimator.getRTO(), -1);
+
+  estimator.seed(80, 10);
+  BOOST_CHECK_CLOSE(estimator.getRTO(), 120, 0.001);
+  BOOST_CHECK_EQUAL(estimator.getRttMin(), -1);
+
+  // the first sample is smoothed with the seed
+  addSample(estimator, 160);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 90, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRttVar(), 27.5, 0.001);
+
+  estimator.seed(500, 100);
+  BOOST_CHECK_CLOSE(estimator.getRttMean(), 90, 0.001);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestRttEstimator
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
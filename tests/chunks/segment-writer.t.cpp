@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/segment-writer.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class SegmentWriterFixture
+{
+public:
+  SegmentWriterFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "SegmentWriterTest")
+    , nSegments(10)
+    , segmentSize(100)
+  {
+    boost::filesystem::create_directories(tmpPath);
+    filePath = tmpPath / "output";
+    fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    BOOST_REQUIRE(fd >= 0);
+
+    for (size_t i = 0; i < nSegments; ++i) {
+      // the last segment is shorter
+      size_t size = i + 1 < nSegments ? segmentSize : segmentSize / 2;
+      std::string content(size, static_cast<char>('a' + i));
+      expected += content;
+
+      auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+      data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+      data->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+      segments.push_back(data);
+    }
+  }
+
+  ~SegmentWriterFixture()
+  {
+    if (fd >= 0)
+      ::close(fd);
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  std::string
+  readOutput()
+  {
+    std::ifstream is(filePath.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  boost::filesystem::path filePath;
+  int fd;
+  size_t nSegments;
+  size_t segmentSize;
+  std::string expected;
+  std::vector<shared_ptr<Data>> segments;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestSegmentWriter, SegmentWriterFixture)
+
+BOOST_AUTO_TEST_CASE(InOrder)
+{
+  SegmentWriter writer(fd);
+  BOOST_CHECK(writer.isRegularFile());
+
+  for (size_t i = 0; i < nSegments; ++i) {
+    writer.addSegment(segments[i]);
+    BOOST_CHECK_EQUAL(writer.getNextSegmentNo(), i + 1);
+  }
+
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), expected.size());
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfOrder)
+{
+  SegmentWriter writer(fd);
+
+  // Segment order: 9 5 3 4 0 2 1 8 7 6
+  std::vector<size_t> order {9, 5, 3, 4, 0, 2, 1, 8, 7, 6};
+  for (size_t i : order)
+    writer.addSegment(segments[i]);
+
+  BOOST_CHECK_EQUAL(writer.getNextSegmentNo(), nSegments);
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), expected.size());
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(DuplicateSegments)
+{
+  SegmentWriter writer(fd);
+
+  writer.addSegment(segments[1]);
+  writer.addSegment(segments[0]);
+  writer.addSegment(segments[1]);
+  writer.addSegment(segments[0]);
+  for (size_t i = 2; i < nSegments; ++i) {
+    writer.addSegment(segments[i]);
+    writer.addSegment(segments[i]);
+  }
+
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), expected.size());
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(RingGrowth)
+{
+  SegmentWriter writer(fd, 2);
+  BOOST_CHECK_EQUAL(writer.m_ring.size(), 2);
+
+  for (size_t i = nSegments - 1; i > 0; --i)
+    writer.addSegment(segments[i]);
+  BOOST_CHECK_GE(writer.m_ring.size(), nSegments);
+  BOOST_CHECK_EQUAL(writer.getNextSegmentNo(), 0);
+
+  writer.addSegment(segments[0]);
+  BOOST_CHECK_EQUAL(writer.getNextSegmentNo(), nSegments);
+  BOOST_CHECK_EQUAL(readOutput(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(Pipe)
+{
+  int pipeFds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(pipeFds), 0);
+
+  SegmentWriter writer(pipeFds[1]);
+  BOOST_CHECK(!writer.isRegularFile());
+
+  // the segments received out of order must be buffered until the gap is filled
+  writer.addSegment(segments[1]);
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), 0);
+  writer.addSegment(segments[0]);
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), 2 * segmentSize);
+  ::close(pipeFds[1]);
+
+  std::string output(2 * segmentSize, '\0');
+  BOOST_REQUIRE_EQUAL(::read(pipeFds[0], &output[0], output.size()),
+                      static_cast<ssize_t>(output.size()));
+  ::close(pipeFds[0]);
+  BOOST_CHECK_EQUAL(output, expected.substr(0, 2 * segmentSize));
+}
+
+BOOST_AUTO_TEST_CASE(PipeSmallRing)
+{
+  int pipeFds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(pipeFds), 0);
+
+  // a run as long as the ring must not wrap around onto its own first slot
+  SegmentWriter writer(pipeFds[1], 2);
+  writer.addSegment(segments[1]);
+  writer.addSegment(segments[0]);
+  BOOST_CHECK_EQUAL(writer.getNextSegmentNo(), 2);
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), 2 * segmentSize);
+  ::close(pipeFds[1]);
+
+  std::string output(3 * segmentSize, '\0');
+  BOOST_REQUIRE_EQUAL(::read(pipeFds[0], &output[0], output.size()),
+                      static_cast<ssize_t>(2 * segmentSize));
+  ::close(pipeFds[0]);
+  output.resize(2 * segmentSize);
+  BOOST_CHECK_EQUAL(output, expected.substr(0, 2 * segmentSize));
+}
+
+BOOST_AUTO_TEST_CASE(BufferedSegmentSize)
+{
+  SegmentWriter writer(fd);
+
+  // an empty segment that is not the last one cannot be checked until the segment size is known
+  auto empty = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(2));
+  empty->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+  writer.addSegment(empty);
+  BOOST_CHECK_EQUAL(writer.getWrittenBytes(), 0);
+
+  BOOST_CHECK_THROW(writer.addSegment(segments[1]), SegmentWriter::Error);
+}
+
+BOOST_AUTO_TEST_CASE(EmptySegment)
+{
+  SegmentWriter writer(fd);
+  writer.addSegment(segments[0]);
+
+  auto empty = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(1));
+  empty->setFinalBlockId(name::Component::fromSegment(nSegments - 1));
+  BOOST_CHECK_THROW(writer.addSegment(empty), SegmentWriter::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmentWriter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/streaming-producer.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/**
+ * @brief stream buffer whose reads block until the test writes to it, or closes it
+ */
+class BlockingStreamBuf : public std::streambuf
+{
+public:
+  void
+  write(const std::string& str)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending += str;
+    m_cv.notify_all();
+  }
+
+  void
+  close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isClosed = true;
+    m_cv.notify_all();
+  }
+
+protected:
+  int_type
+  underflow() NDN_CXX_DECL_OVERRIDE
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_pending.empty() || m_isClosed; });
+    if (m_pending.empty())
+      return traits_type::eof();
+
+    m_current.swap(m_pending);
+    m_pending.clear();
+    setg(&m_current[0], &m_current[0], &m_current[0] + m_current.size());
+    return traits_type::to_int_type(m_current[0]);
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::string m_pending;
+  std::string m_current;
+  bool m_isClosed = false;
+};
+
+class StreamingProducerFixture
+{
+public:
+  StreamingProducerFixture()
+    : face(io, {true, true})
+    , makeKeyChain([] { return make_unique<KeyChain>(); })
+    , prefix(Name("/ndn/chunks/test").appendVersion(1449227841747))
+    , input(&inputBuf)
+  {
+  }
+
+  /**
+   * @brief process the events until @p isDone returns true, or a timeout
+   */
+  bool
+  waitUntil(const function<bool()>& isDone)
+  {
+    for (int i = 0; i < 5000 && !isDone(); ++i) {
+      io.poll();
+      io.reset();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return isDone();
+  }
+
+  bool
+  waitForData(size_t nData)
+  {
+    return waitUntil([this, nData] { return face.sentData.size() >= nData; });
+  }
+
+  /**
+   * @brief process the events posted in the next few milliseconds
+   */
+  void
+  processEvents()
+  {
+    for (int i = 0; i < 20; ++i) {
+      io.poll();
+      io.reset();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  StreamingProducer::KeyChainFactory makeKeyChain;
+  security::SigningInfo signingInfo;
+  Name prefix;
+  BlockingStreamBuf inputBuf;
+  std::istream input;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestStreamingProducer, StreamingProducerFixture)
+
+BOOST_AUTO_TEST_CASE(PublishWhileReading)
+{
+  StreamingProducer producer(prefix, face, makeKeyChain, signingInfo, time::seconds(10), 40,
+                             false, false, input);
+  processEvents();
+
+  // discovery Interest and Interest for a segment not read yet
+  face.receive(*makeInterest(prefix.getPrefix(-1)));
+  face.receive(*makeInterest(Name(prefix).appendSegment(1)));
+  processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 2);
+
+  // a full segment is published only when the stream goes on
+  inputBuf.write(std::string(40, 'a'));
+  processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+
+  inputBuf.write(std::string(10, 'b'));
+  BOOST_REQUIRE(waitForData(1));
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), Name(prefix).appendSegment(0));
+  BOOST_CHECK_EQUAL(face.sentData[0].getContent().value_size(), 40);
+  BOOST_CHECK(face.sentData[0].getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 1);
+
+  // the last segment is known at the end of the stream
+  inputBuf.close();
+  BOOST_REQUIRE(waitForData(2));
+  BOOST_CHECK_EQUAL(face.sentData[1].getName(), Name(prefix).appendSegment(1));
+  BOOST_CHECK_EQUAL(face.sentData[1].getContent().value_size(), 10);
+  BOOST_REQUIRE(!face.sentData[1].getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(face.sentData[1].getFinalBlockId().toSegment(), 1);
+  BOOST_CHECK(producer.m_isEof);
+  BOOST_CHECK(producer.m_pendingInterests.empty());
+
+  // the published segments are served immediately
+  face.receive(*makeInterest(Name(prefix).appendSegment(0)));
+  face.processEvents();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 3);
+  BOOST_CHECK(face.sentData[2] == face.sentData[0]);
+
+  // segments after the last one are not kept pending
+  face.receive(*makeInterest(Name(prefix).appendSegment(2)));
+  face.processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 3);
+  BOOST_CHECK(producer.m_pendingInterests.empty());
+}
+
+BOOST_AUTO_TEST_CASE(EmptyInput)
+{
+  StreamingProducer producer(prefix, face, makeKeyChain, signingInfo, time::seconds(10), 40,
+                             false, false, input);
+  face.receive(*makeInterest(Name(prefix).appendSegment(0)));
+  inputBuf.close();
+
+  BOOST_REQUIRE(waitForData(1));
+  BOOST_CHECK_EQUAL(face.sentData[0].getContent().value_size(), 0);
+  BOOST_REQUIRE(!face.sentData[0].getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(face.sentData[0].getFinalBlockId().toSegment(), 0);
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ExpiredPendingInterest)
+{
+  StreamingProducer producer(prefix, face, makeKeyChain, signingInfo, time::seconds(10), 40,
+                             false, false, input);
+
+  auto interest = makeInterest(Name(prefix).appendSegment(0));
+  interest->setInterestLifetime(time::milliseconds(1));
+  face.receive(*interest);
+  processEvents();
+
+  inputBuf.write("abc");
+  inputBuf.close();
+  BOOST_REQUIRE(waitUntil([&producer] { return producer.m_isEof; }));
+  BOOST_REQUIRE_EQUAL(producer.m_store.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  BOOST_CHECK(producer.m_pendingInterests.empty());
+}
+
+BOOST_AUTO_TEST_CASE(DestroyedWhileReading)
+{
+  {
+    StreamingProducer producer(prefix, face, makeKeyChain, signingInfo, time::seconds(10), 40,
+                               false, false, input);
+    face.receive(*makeInterest(Name(prefix).appendSegment(0)));
+
+    // the reading thread is blocked waiting for the character after the first segment
+    inputBuf.write(std::string(40, 'a'));
+    processEvents();
+    BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  }
+
+  // the detached reading thread stops without signing or publishing the segment
+  inputBuf.write("b");
+  inputBuf.close();
+  processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestStreamingProducer
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/telemetry-log.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class TelemetryLogFixture
+{
+public:
+  TelemetryLogFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "TelemetryLogTest")
+    , filePath((tmpPath / "telemetry").string())
+  {
+    boost::filesystem::create_directories(tmpPath);
+  }
+
+  ~TelemetryLogFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+  std::vector<std::string>
+  decodeLines()
+  {
+    std::ostringstream os;
+    TelemetryLog::decode(filePath, os);
+
+    std::vector<std::string> lines;
+    std::istringstream is(os.str());
+    for (std::string line; std::getline(is, line);)
+      lines.push_back(line);
+    return lines;
+  }
+
+protected:
+  boost::filesystem::path tmpPath;
+  std::string filePath;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestTelemetryLog, TelemetryLogFixture)
+
+BOOST_AUTO_TEST_CASE(Decode)
+{
+  TelemetryLog log(filePath, 16);
+  auto start = time::steady_clock::now();
+  log.record(TelemetryEvent::InterestSent, 7, 4000, start);
+  log.record(TelemetryEvent::DataReceived, 7, 12.5, start);
+  log.record(TelemetryEvent::Nack, 8, static_cast<int>(lp::NackReason::CONGESTION), start);
+  log.record(TelemetryEvent::Timeout, 9, 2, start);
+  log.record(TelemetryEvent::WindowChange, 0, 6, start);
+  BOOST_CHECK_EQUAL(log.getNRecords(), 5);
+
+  // the file can be decoded while it is being written
+  std::vector<std::string> lines = decodeLines();
+  BOOST_REQUIRE_EQUAL(lines.size(), 6);
+  BOOST_CHECK_EQUAL(lines[0], "time,event,segment,value");
+  BOOST_CHECK_EQUAL(lines[1].substr(lines[1].find(',')), ",interest_sent,7,4000.000");
+  BOOST_CHECK_EQUAL(lines[2].substr(lines[2].find(',')), ",data_received,7,12.500");
+  BOOST_CHECK_EQUAL(lines[3].substr(lines[3].find(',')), ",nack,8,Congestion");
+  BOOST_CHECK_EQUAL(lines[4].substr(lines[4].find(',')), ",timeout,9,2.000");
+  BOOST_CHECK_EQUAL(lines[5].substr(lines[5].find(',')), ",window,,6.000");
+}
+
+BOOST_AUTO_TEST_CASE(Wraparound)
+{
+  {
+    TelemetryLog log(filePath, 3);
+    BOOST_CHECK_EQUAL(log.getCapacity(), 4);
+    for (uint64_t i = 0; i < 6; ++i)
+      log.record(TelemetryEvent::InterestSent, i, 1000);
+  }
+
+  // only the newest records are left, oldest first
+  std::vector<std::string> lines = decodeLines();
+  BOOST_REQUIRE_EQUAL(lines.size(), 5);
+  for (uint64_t i = 0; i < 4; ++i)
+    BOOST_CHECK_EQUAL(lines[i + 1].substr(lines[i + 1].find(',')),
+                      ",interest_sent," + to_string(i + 2) + ",1000.000");
+}
+
+BOOST_AUTO_TEST_CASE(NotATelemetryLog)
+{
+  std::ofstream(filePath) << "not a telemetry log, but long enough to contain a header........";
+  BOOST_CHECK_THROW(decodeLines(), TelemetryLog::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTelemetryLog
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
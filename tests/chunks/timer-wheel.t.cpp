@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/timer-wheel.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class TimerWheelFixture : public UnitTestTimeFixture
+{
+public:
+  TimerWheelFixture()
+    : wheel(time::milliseconds(1))
+  {
+  }
+
+  void
+  advance(const time::nanoseconds& duration)
+  {
+    steadyClock->advance(duration);
+    wheel.advance(time::steady_clock::now(), [this] (uint64_t key) { expired.push_back(key); });
+  }
+
+protected:
+  TimerWheel wheel;
+  std::vector<uint64_t> expired;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestTimerWheel, TimerWheelFixture)
+
+BOOST_AUTO_TEST_CASE(Expire)
+{
+  auto now = time::steady_clock::now();
+  wheel.add(now + time::milliseconds(10), 1);
+  wheel.add(now + time::milliseconds(5), 2);
+  wheel.add(now + time::milliseconds(10), 3);
+  BOOST_CHECK_EQUAL(wheel.size(), 3);
+  BOOST_CHECK(wheel.getNextExpiry() == now + time::milliseconds(5));
+
+  advance(time::milliseconds(4));
+  BOOST_CHECK(expired.empty());
+
+  advance(time::milliseconds(1));
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0], 2);
+  BOOST_CHECK(wheel.getNextExpiry() == now + time::milliseconds(10));
+
+  advance(time::milliseconds(10));
+  BOOST_CHECK_EQUAL(expired.size(), 3);
+  BOOST_CHECK(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  auto now = time::steady_clock::now();
+  auto id1 = wheel.add(now + time::milliseconds(10), 1);
+  wheel.add(now + time::milliseconds(10), 2);
+
+  wheel.cancel(id1);
+  wheel.cancel(id1);
+  BOOST_CHECK_EQUAL(wheel.size(), 1);
+
+  advance(time::milliseconds(10));
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0], 2);
+
+  // the released nodes are reused
+  auto id3 = wheel.add(time::steady_clock::now() + time::milliseconds(1), 3);
+  BOOST_CHECK_LT(id3, 2);
+}
+
+BOOST_AUTO_TEST_CASE(SecondLevel)
+{
+  auto now = time::steady_clock::now();
+  wheel.add(now + time::milliseconds(1000), 1);
+  wheel.add(now + time::seconds(100), 2); // beyond the second level
+
+  // the wheel wakes up at every move of a second level slot
+  BOOST_CHECK(wheel.getNextExpiry() <= now + time::milliseconds(256));
+
+  advance(time::milliseconds(999));
+  BOOST_CHECK(expired.empty());
+  advance(time::milliseconds(1));
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0], 1);
+
+  advance(time::milliseconds(98999));
+  BOOST_CHECK_EQUAL(expired.size(), 1);
+  advance(time::milliseconds(1));
+  BOOST_REQUIRE_EQUAL(expired.size(), 2);
+  BOOST_CHECK_EQUAL(expired[1], 2);
+}
+
+BOOST_AUTO_TEST_CASE(AddFromCallback)
+{
+  auto now = time::steady_clock::now();
+  wheel.add(now + time::milliseconds(2), 1);
+
+  steadyClock->advance(time::milliseconds(2));
+  wheel.advance(time::steady_clock::now(), [this] (uint64_t key) {
+      expired.push_back(key);
+      if (key == 1) {
+        wheel.add(time::steady_clock::now(), 2);
+      }
+    });
+  BOOST_CHECK_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(wheel.size(), 1);
+
+  advance(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(expired.size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTimerWheel
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2015,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/hdr-histogram.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace tools {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(CoreHdrHistogram)
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  HdrHistogram histogram(3600000000);
+
+  BOOST_CHECK_EQUAL(histogram.getTotalCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.getMin(), 0);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 0);
+  BOOST_CHECK_EQUAL(histogram.getMean(), 0);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(50), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Percentiles)
+{
+  HdrHistogram histogram(3600000000, 2);
+
+  for (uint64_t value = 1; value <= 10000; ++value) {
+    histogram.record(value);
+  }
+
+  BOOST_CHECK_EQUAL(histogram.getTotalCount(), 10000);
+  BOOST_CHECK_EQUAL(histogram.getMin(), 1);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 10000);
+  BOOST_CHECK_CLOSE(histogram.getMean(), 5000.5, 0.001);
+
+  // small values are recorded exactly
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(0), 1);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(1), 100);
+
+  // larger values within the requested precision
+  BOOST_CHECK_CLOSE(static_cast<double>(histogram.getValueAtPercentile(50)), 5000, 1);
+  BOOST_CHECK_CLOSE(static_cast<double>(histogram.getValueAtPercentile(99)), 9900, 1);
+  BOOST_CHECK_CLOSE(static_cast<double>(histogram.getValueAtPercentile(99.9)), 9990, 1);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(100), 10000);
+
+  histogram.reset();
+  BOOST_CHECK_EQUAL(histogram.getTotalCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(100), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Clamp)
+{
+  HdrHistogram histogram(1000, 3);
+
+  histogram.record(5);
+  histogram.record(1000000);
+
+  BOOST_CHECK_EQUAL(histogram.getTotalCount(), 2);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 1000);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(50), 5);
+  BOOST_CHECK_EQUAL(histogram.getValueAtPercentile(100), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidArguments)
+{
+  BOOST_CHECK_THROW(HdrHistogram(1), std::invalid_argument);
+  BOOST_CHECK_THROW(HdrHistogram(1000, 0), std::invalid_argument);
+  BOOST_CHECK_THROW(HdrHistogram(1000, 6), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace tools
+} // namespace ndn
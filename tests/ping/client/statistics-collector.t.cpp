@@ -140,6 +140,19 @@ BOOST_AUTO_TEST_CASE(Resp50msLoss)
   BOOST_CHECK_CLOSE(stats.stdDevRtt, 0.0, 0.001);
 }
 
+BOOST_AUTO_TEST_CASE(Percentiles)
+{
+  for (int i = 1; i <= 100; ++i) {
+    sc.recordResponse(time::milliseconds(i));
+  }
+
+  Statistics stats = sc.computeStatistics();
+  BOOST_CHECK_EQUAL(stats.nReceived, 100);
+  BOOST_CHECK_CLOSE(stats.p50Rtt, 50.0, 1);
+  BOOST_CHECK_CLOSE(stats.p99Rtt, 99.0, 1);
+  BOOST_CHECK_CLOSE(stats.p999Rtt, 100.0, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
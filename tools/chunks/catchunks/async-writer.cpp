@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "async-writer.hpp"
+
+namespace ndn {
+namespace chunks {
+
+AsyncWriter::AsyncWriter(boost::asio::io_service& io, std::ostream& os, size_t capacity,
+                         const SpaceCallback& onSpace, const ErrorCallback& onError)
+  : m_io(io)
+  , m_os(os)
+  , m_ring(capacity)
+  , m_head(0)
+  , m_tail(0)
+  , m_isSpaceRequested(false)
+  , m_isWriterWaiting(false)
+  , m_hasError(false)
+  , m_isClosed(false)
+  , m_callbacks(make_shared<Callbacks>())
+{
+  BOOST_ASSERT(capacity >= 1);
+
+  m_callbacks->onSpace = onSpace;
+  m_callbacks->onError = onError;
+  m_callbacks->isCanceled = false;
+
+  m_thread = std::thread(&AsyncWriter::run, this);
+}
+
+AsyncWriter::~AsyncWriter()
+{
+  close();
+  m_callbacks->isCanceled = true;
+}
+
+bool
+AsyncWriter::push(const Block& content)
+{
+  if (getNFree() == 0)
+    return false;
+
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  m_ring[tail % m_ring.size()] = content;
+  m_tail.store(tail + 1);
+
+  // the writer sets the flag before checking the tail, so either it sees the new tail or it is
+  // notified
+  if (m_isWriterWaiting.load()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cv.notify_one();
+  }
+
+  return true;
+}
+
+void
+AsyncWriter::requestSpace()
+{
+  m_isSpaceRequested = true;
+
+  // the writer may have made room before the request
+  if (getNFree() >= m_ring.size() - m_ring.size() / 2 && m_isSpaceRequested.exchange(false))
+    post([] (Callbacks& callbacks) { callbacks.onSpace(); });
+}
+
+void
+AsyncWriter::close()
+{
+  if (!m_thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isClosed = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void
+AsyncWriter::run()
+{
+  uint64_t head = m_head.load(std::memory_order_relaxed);
+
+  while (true) {
+    if (head == m_tail.load()) {
+      // make the output visible before waiting for more segments
+      m_os.flush();
+      if (!m_os && !m_hasError) {
+        m_hasError = true;
+        post([] (Callbacks& callbacks) { callbacks.onError("Cannot flush the output"); });
+      }
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_isWriterWaiting = true;
+      m_cv.wait(lock, [this, head] { return head != m_tail.load() || m_isClosed; });
+      m_isWriterWaiting = false;
+
+      if (head == m_tail.load())
+        return; // closed and drained
+      continue;
+    }
+
+    Block& slot = m_ring[head % m_ring.size()];
+    if (!m_hasError) {
+      m_os.write(reinterpret_cast<const char*>(slot.value()), slot.value_size());
+      if (!m_os) {
+        m_hasError = true;
+        post([] (Callbacks& callbacks) { callbacks.onError("Cannot write the output"); });
+      }
+    }
+
+    // release the buffer of the segment in this thread, then the slot
+    slot = Block();
+    m_head.store(++head, std::memory_order_release);
+
+    if (m_isSpaceRequested.load(std::memory_order_relaxed) &&
+        m_tail.load() - head <= m_ring.size() / 2 && m_isSpaceRequested.exchange(false))
+      post([] (Callbacks& callbacks) { callbacks.onSpace(); });
+  }
+}
+
+void
+AsyncWriter::post(const function<void(Callbacks&)>& invoke)
+{
+  shared_ptr<Callbacks> callbacks = m_callbacks;
+  m_io.post([callbacks, invoke] {
+      if (!callbacks->isCanceled)
+        invoke(*callbacks);
+    });
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_ASYNC_WRITER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_ASYNC_WRITER_HPP
+
+#include "core/common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Writes the content of the segments to an output stream from a dedicated thread
+ *
+ * The thread of the io_service pushes the content blocks, in order, into a bounded
+ * single-producer/single-consumer ring, and the writer thread pops them and writes them to the
+ * stream. A slow output therefore does not stall the processing of the Data packets: when the
+ * ring is full, push() fails and the caller is expected to request fewer segments until the
+ * writer has made room.
+ *
+ * The ring indices are lock-free; the mutex is taken only to put the writer thread to sleep when
+ * the ring is empty, and to wake it up.
+ */
+class AsyncWriter : noncopyable
+{
+public:
+  typedef function<void()> SpaceCallback;
+  typedef function<void(const std::string& reason)> ErrorCallback;
+
+  /**
+   * @param io the io_service on which @p onSpace and @p onError are invoked
+   * @param capacity the number of segments in the ring, must be at least 1
+   * @param onSpace called when at least half of the ring is free after requestSpace()
+   * @param onError called if a write fails, the following segments are discarded
+   */
+  AsyncWriter(boost::asio::io_service& io, std::ostream& os, size_t capacity,
+              const SpaceCallback& onSpace, const ErrorCallback& onError);
+
+  /**
+   * @brief write the segments left in the ring and join the writer thread
+   */
+  ~AsyncWriter();
+
+  /**
+   * @brief queue @p content for writing
+   *
+   * @return false if the ring is full
+   */
+  bool
+  push(const Block& content);
+
+  /**
+   * @brief invoke the space callback once at least half of the ring is free
+   */
+  void
+  requestSpace();
+
+  /**
+   * @brief write the segments left in the ring, flush the stream and join the writer thread
+   *
+   * Blocks the caller until the segments have been written. No segment can be pushed afterwards.
+   */
+  void
+  close();
+
+  size_t
+  getCapacity() const
+  {
+    return m_ring.size();
+  }
+
+  /**
+   * @return the number of free slots in the ring, as seen by the producer
+   */
+  size_t
+  getNFree() const
+  {
+    return m_ring.size() - (m_tail.load(std::memory_order_relaxed) -
+                            m_head.load(std::memory_order_acquire));
+  }
+
+private:
+  void
+  run();
+
+  /**
+   * @brief the state shared with the handlers posted to the io_service, which can run after the
+   *        writer has been destroyed
+   */
+  struct Callbacks
+  {
+    SpaceCallback onSpace;
+    ErrorCallback onError;
+    std::atomic<bool> isCanceled;
+  };
+
+  void
+  post(const function<void(Callbacks&)>& invoke);
+
+private:
+  boost::asio::io_service& m_io;
+  std::ostream& m_os;
+  std::vector<Block> m_ring;
+  std::atomic<uint64_t> m_head; ///< next slot to write, advanced by the writer thread
+  std::atomic<uint64_t> m_tail; ///< next slot to fill, advanced by the producer
+  std::atomic<bool> m_isSpaceRequested;
+  std::atomic<bool> m_isWriterWaiting;
+  bool m_hasError; ///< accessed only by the writer thread
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_isClosed;
+
+  shared_ptr<Callbacks> m_callbacks;
+  std::thread m_thread;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_ASYNC_WRITER_HPP
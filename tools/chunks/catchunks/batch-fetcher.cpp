@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "batch-fetcher.hpp"
+
+#include <cstdio>
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+
+static PipelineInterestsOptions
+makeSegmentTableOptions(PipelineInterestsOptions options)
+{
+  options.useSegmentTable = true;
+  options.usePacing = false;
+  return options;
+}
+
+BatchFetcher::BatchFetcher(Face& face, Validator& validator, const PipelineInterestsOptions& options,
+                           const DiscoverFactory& makeDiscover, size_t maxConcurrentObjects,
+                           bool noDiscovery, bool printStat)
+  : m_face(face)
+  , m_validator(validator)
+  , m_options(makeSegmentTableOptions(options))
+  , m_makeDiscover(makeDiscover)
+  , m_maxConcurrentObjects(maxConcurrentObjects)
+  , m_noDiscovery(noDiscovery)
+  , m_printStat(printStat)
+  , m_discoveryCache(nullptr)
+  , m_nextObject(0)
+  , m_nCompleted(0)
+  , m_nFailed(0)
+  , m_nBytes(0)
+  , m_lastNBytes(0)
+  , m_sharedWindow(face.getIoService(), m_options)
+  , m_scheduler(face.getIoService())
+{
+  BOOST_ASSERT(m_maxConcurrentObjects > 0);
+}
+
+std::vector<BatchFetcher::Object>
+BatchFetcher::parseManifest(std::istream& is, const std::string& outputDir)
+{
+  std::string directory = outputDir.empty() ? "." : outputDir;
+  if (directory.back() != '/')
+    directory += '/';
+
+  std::vector<Object> objects;
+  std::string line;
+  for (size_t lineNo = 1; std::getline(is, line); ++lineNo) {
+    std::istringstream iss(line);
+    std::string uri;
+    std::string outputFile;
+    if (!(iss >> uri) || uri[0] == '#')
+      continue;
+
+    std::string extra;
+    iss >> outputFile >> extra;
+    if (!extra.empty())
+      throw Error("Line " + to_string(lineNo) + ": too many fields");
+
+    Object object;
+    try {
+      object.name = Name(uri);
+    }
+    catch (const tlv::Error&) {
+      throw Error("Line " + to_string(lineNo) + ": invalid name " + uri);
+    }
+
+    if (outputFile.empty()) {
+      Name name = object.name;
+      while (!name.empty() && (name[-1].isVersion() || name[-1].isSegment()))
+        name = name.getPrefix(-1);
+      if (name.empty())
+        throw Error("Line " + to_string(lineNo) + ": no output file for " + uri);
+
+      // the escaped component never contains '/', "." and ".." are escaped as "..." and "...."
+      outputFile = name[-1].toUri();
+    }
+
+    object.outputFile = outputFile[0] == '/' ? outputFile : directory + outputFile;
+    objects.push_back(object);
+  }
+
+  return objects;
+}
+
+void
+BatchFetcher::run(const std::vector<Object>& objects)
+{
+  start(objects);
+
+  m_face.processEvents();
+
+  printSummary();
+}
+
+void
+BatchFetcher::start(const std::vector<Object>& objects)
+{
+  m_objects = objects;
+  m_nextObject = 0;
+  m_startTime = time::steady_clock::now();
+  m_lastPrintTime = m_startTime;
+
+  startNextObjects();
+  if (m_objects.empty())
+    m_face.getIoService().post(bind(&BatchFetcher::stopIfFinished, this));
+
+  if (m_printStat)
+    m_scheduler.scheduleEvent(time::seconds(1), bind(&BatchFetcher::printStatistics, this));
+}
+
+void
+BatchFetcher::startNextObjects()
+{
+  while (m_jobs.size() < m_maxConcurrentObjects && m_nextObject < m_objects.size()) {
+    auto job = m_jobs.insert(m_jobs.end(), make_unique<Job>());
+    Job& j = **job;
+    j.object = m_objects[m_nextObject++];
+
+    j.os.open(j.object.outputFile, std::ios::binary | std::ios::trunc);
+    if (!j.os) {
+      onJobFailure(job, "Cannot open " + j.object.outputFile);
+      continue;
+    }
+
+    j.discover = m_makeDiscover(j.object.name);
+    j.pipeline = make_unique<PipelineInterests>(m_face, m_sharedWindow, m_options);
+    j.consumer = make_unique<Consumer>(m_face, m_validator, m_options.isVerbose, j.os);
+    j.consumer->setCompletionCallback(bind(&BatchFetcher::onJobComplete, this, job));
+    j.consumer->setFailureCallback(bind(&BatchFetcher::onJobFailure, this, job, _1));
+    if (m_discoveryCache != nullptr)
+      j.consumer->setDiscoveryCache(*m_discoveryCache);
+
+    j.consumer->start(*j.discover, *j.pipeline, m_noDiscovery);
+  }
+}
+
+void
+BatchFetcher::onJobComplete(std::list<unique_ptr<Job>>::iterator job)
+{
+  Job& j = **job;
+  if (j.isFinished)
+    return;
+
+  uint64_t nBytes = getNWrittenBytes(j);
+  j.os.close();
+  if (!j.os) {
+    onJobFailure(job, "Cannot write " + j.object.outputFile);
+    return;
+  }
+
+  j.isFinished = true;
+  ++m_nCompleted;
+  m_nBytes += nBytes;
+
+  if (m_options.isVerbose)
+    std::cerr << "Completed " << j.object.name << " -> " << j.object.outputFile << std::endl;
+
+  // the job is destroyed after the consumer has returned
+  m_face.getIoService().post([this, job] {
+      m_jobs.erase(job);
+      startNextObjects();
+      stopIfFinished();
+    });
+}
+
+void
+BatchFetcher::onJobFailure(std::list<unique_ptr<Job>>::iterator job, const std::string& reason)
+{
+  Job& j = **job;
+  if (j.isFinished)
+    return;
+
+  std::cerr << "ERROR: " << j.object.name << ": " << reason << std::endl;
+
+  j.isFinished = true;
+  ++m_nFailed;
+  if (j.pipeline != nullptr)
+    j.pipeline->cancel();
+
+  // do not leave a truncated file that could be mistaken for the complete object
+  if (j.os.is_open())
+    j.os.close();
+  std::remove(j.object.outputFile.c_str());
+
+  m_face.getIoService().post([this, job] {
+      m_failedJobs.splice(m_failedJobs.end(), m_jobs, job);
+      startNextObjects();
+      stopIfFinished();
+    });
+}
+
+void
+BatchFetcher::stopIfFinished()
+{
+  // other handlers (e.g. the SIGINT handler) may keep the io_service busy after the last object
+  if (m_nCompleted + m_nFailed == m_objects.size())
+    m_face.getIoService().stop();
+}
+
+uint64_t
+BatchFetcher::getNWrittenBytes(Job& job)
+{
+  std::streamoff position = job.os.tellp();
+  return position > 0 ? static_cast<uint64_t>(position) : 0;
+}
+
+void
+BatchFetcher::printStatistics()
+{
+  auto now = time::steady_clock::now();
+  time::milliseconds runningTime = time::duration_cast<time::milliseconds>(now - m_startTime);
+  time::milliseconds lastRunningTime = time::duration_cast<time::milliseconds>(now - m_lastPrintTime);
+
+  uint64_t nBytes = m_nBytes;
+  for (const auto& job : m_jobs)
+    if (!job->isFinished)
+      nBytes += getNWrittenBytes(*job);
+
+  std::cerr << m_nCompleted + m_nFailed << "/" << m_objects.size() << " objects \t"
+            << m_nFailed << " failed \t"
+            << " T " << nBytes / 1000 << " KB \t"
+            << static_cast<double>(nBytes) / std::max<int64_t>(runningTime.count(), 1) << " KB/s \t"
+            << " C " << (nBytes - m_lastNBytes) / 1000 << " KB \t"
+            << static_cast<double>(nBytes - m_lastNBytes) / std::max<int64_t>(lastRunningTime.count(), 1)
+            << " KB/s \t"
+            << "Wnd " << m_sharedWindow.getWindowSize() << " \t"
+            << "Rtt " << int(m_sharedWindow.rttEstimator.getRttMean())
+            << "(" << int(m_sharedWindow.rttEstimator.getRttVar()) << ")"
+            << std::endl;
+
+  m_lastPrintTime = now;
+  m_lastNBytes = nBytes;
+
+  if (m_nCompleted + m_nFailed < m_objects.size())
+    m_scheduler.scheduleEvent(time::seconds(1), bind(&BatchFetcher::printStatistics, this));
+}
+
+void
+BatchFetcher::printSummary()
+{
+  time::milliseconds runningTime =
+    time::duration_cast<time::milliseconds>(time::steady_clock::now() - m_startTime);
+
+  std::cerr << "Fetched " << m_nCompleted << " of " << m_objects.size() << " objects ("
+            << m_nFailed << " failed), " << m_nBytes << " bytes in " << runningTime.count()
+            << " ms, " << static_cast<double>(m_nBytes) / std::max<int64_t>(runningTime.count(), 1)
+            << " KB/s" << std::endl;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_BATCH_FETCHER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_BATCH_FETCHER_HPP
+
+#include "consumer.hpp"
+#include "discover-version.hpp"
+#include "shared-window.hpp"
+
+#include <fstream>
+#include <list>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Fetches a list of objects concurrently over one Face
+ *
+ * Each object is retrieved by its own version discovery, pipeline and consumer, and written to
+ * its own output file. The pipelines share the Interest window, the congestion control and the
+ * RTT estimation (see SharedWindow), so the objects after the first one do not go through slow
+ * start again. At most maxConcurrentObjects objects are fetched at the same time.
+ */
+class BatchFetcher : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Object
+  {
+    Name name;
+    std::string outputFile;
+  };
+
+  typedef function<unique_ptr<DiscoverVersion>(const Name& prefix)> DiscoverFactory;
+
+  /**
+   * @param options options of the pipelines, the segment table mode is always used
+   * @param makeDiscover creates the version discovery of an object
+   * @throw std::invalid_argument the congestion control in @p options is unknown
+   */
+  BatchFetcher(Face& face, Validator& validator, const PipelineInterestsOptions& options,
+               const DiscoverFactory& makeDiscover, size_t maxConcurrentObjects,
+               bool noDiscovery = false, bool printStat = false);
+
+  /**
+   * @brief read the list of objects from @p is
+   *
+   * Each line contains an NDN name, optionally followed by the output file. Empty lines and the
+   * lines starting with '#' are ignored. Relative output files are placed in @p outputDir; without
+   * an output file, the object is written in @p outputDir to a file named after the last name
+   * component that is not a version.
+   *
+   * @throw Error the list is malformed
+   */
+  static std::vector<Object>
+  parseManifest(std::istream& is, const std::string& outputDir);
+
+  /**
+   * @brief skip the version discovery of the objects found in @p cache, see
+   *        Consumer::setDiscoveryCache
+   */
+  void
+  setDiscoveryCache(DiscoveryCache& cache)
+  {
+    m_discoveryCache = &cache;
+  }
+
+  /**
+   * @brief fetch all the @p objects and return when they are completed or have failed
+   */
+  void
+  run(const std::vector<Object>& objects);
+
+  /**
+   * @brief start fetching the @p objects without processing the events of the face
+   *
+   * The io_service of the face is stopped when all the objects are completed or have failed.
+   */
+  void
+  start(const std::vector<Object>& objects);
+
+  size_t
+  getNCompleted() const
+  {
+    return m_nCompleted;
+  }
+
+  size_t
+  getNFailed() const
+  {
+    return m_nFailed;
+  }
+
+  /**
+   * @return the bytes written for the completed objects
+   */
+  uint64_t
+  getNBytes() const
+  {
+    return m_nBytes;
+  }
+
+  const SharedWindow&
+  getSharedWindow() const
+  {
+    return m_sharedWindow;
+  }
+
+private:
+  struct Job
+  {
+    Object object;
+    bool isFinished = false; ///< completed or failed
+    std::ofstream os;
+    unique_ptr<DiscoverVersion> discover;
+    unique_ptr<PipelineInterests> pipeline;
+    unique_ptr<Consumer> consumer;
+  };
+
+  /**
+   * @brief start the next objects until maxConcurrentObjects objects are being fetched
+   */
+  void
+  startNextObjects();
+
+  void
+  onJobComplete(std::list<unique_ptr<Job>>::iterator job);
+
+  void
+  onJobFailure(std::list<unique_ptr<Job>>::iterator job, const std::string& reason);
+
+  /**
+   * @brief stop the io_service of the face if all the objects are completed or have failed
+   */
+  void
+  stopIfFinished();
+
+  static uint64_t
+  getNWrittenBytes(Job& job);
+
+  void
+  printStatistics();
+
+  void
+  printSummary();
+
+private:
+  Face& m_face;
+  Validator& m_validator;
+  const PipelineInterestsOptions m_options;
+  DiscoverFactory m_makeDiscover;
+  size_t m_maxConcurrentObjects;
+  bool m_noDiscovery;
+  bool m_printStat;
+  DiscoveryCache* m_discoveryCache;
+
+  std::vector<Object> m_objects;
+  size_t m_nextObject;
+  size_t m_nCompleted;
+  size_t m_nFailed;
+  uint64_t m_nBytes;
+  time::steady_clock::TimePoint m_startTime;
+  uint64_t m_lastNBytes;
+  time::steady_clock::TimePoint m_lastPrintTime;
+
+  SharedWindow m_sharedWindow;
+  std::list<unique_ptr<Job>> m_jobs; ///< objects being fetched
+  std::list<unique_ptr<Job>> m_failedJobs; ///< kept until the end, validations may be pending
+  Scheduler m_scheduler;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_BATCH_FETCHER_HPP
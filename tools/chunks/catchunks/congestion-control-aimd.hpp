@@ -0,0 +1,56 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_AIMD_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_AIMD_HPP
+
+#include "congestion-control.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Additive increase, multiplicative decrease of the window
+ *
+ * The window grows by one segment per received segment up to the slow start threshold, then by
+ * one segment per round. On a loss, the window of the round is multiplied by the window cut
+ * multiplier.
+ */
+class CongestionControlAimd : public CongestionControl
+{
+public:
+  using CongestionControl::CongestionControl;
+
+  float
+  onData(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+
+  float
+  onLoss(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_AIMD_HPP
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "congestion-control-bbr.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace chunks {
+
+const double CongestionControlBbr::PROBE_BW_GAINS[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+
+/**
+ * @brief gain of the window in Startup, 2/ln(2) doubles the delivery rate every round
+ */
+static const double STARTUP_GAIN = 2.89;
+
+/**
+ * @brief minimum growth of the delivery rate per round to stay in Startup
+ */
+static const double FULL_RATE_GROWTH = 1.25;
+
+/**
+ * @brief number of rounds without growth after which the pipe is considered full
+ */
+static const size_t FULL_RATE_ROUNDS = 3;
+
+CongestionControlBbr::CongestionControlBbr(const PipelineInterestsOptions& options,
+                                           const RttEstimator& rttEstimator)
+  : CongestionControl(options, rttEstimator)
+  , m_state(State::Startup)
+  , m_nRoundDelivered(0)
+  , m_roundStart(time::steady_clock::now())
+  , m_fullRate(0)
+  , m_nFullRateRounds(0)
+  , m_probeBwCycle(0)
+{
+}
+
+double
+CongestionControlBbr::getMaxDeliveryRate() const
+{
+  if (m_deliveryRates.empty())
+    return 0;
+
+  return *std::max_element(m_deliveryRates.begin(), m_deliveryRates.end());
+}
+
+double
+CongestionControlBbr::getBdp() const
+{
+  float rttMin = m_rttEstimator.getRttMin();
+  if (rttMin <= 0)
+    return 0;
+
+  return getMaxDeliveryRate() * rttMin;
+}
+
+double
+CongestionControlBbr::getGain() const
+{
+  switch (m_state) {
+    case State::Startup:
+      return STARTUP_GAIN;
+    case State::Drain:
+      // the window keeps one BDP in flight, which drains the queue built in Startup even
+      // without pacing
+      return 1;
+    case State::ProbeBw:
+    default:
+      return PROBE_BW_GAINS[m_probeBwCycle];
+  }
+}
+
+double
+CongestionControlBbr::getPacingGain() const
+{
+  // the queue built in Startup is drained by pacing below the bottleneck rate
+  if (m_state == State::Drain)
+    return 1 / STARTUP_GAIN;
+
+  return getGain();
+}
+
+float
+CongestionControlBbr::onData(float windowSize, float roundWindowSize)
+{
+  ++m_nRoundDelivered;
+
+  double bdp = getBdp();
+  if (bdp == 0)
+    return windowSize + 1;
+
+  double target = getGain() * bdp;
+  if (windowSize < target)
+    return std::min<float>(windowSize + 1, target);
+
+  // the delivery rate is underestimated until the pipe is full, do not shrink the window yet
+  if (m_state == State::Startup)
+    return windowSize;
+
+  return target;
+}
+
+float
+CongestionControlBbr::onLoss(float windowSize, float roundWindowSize)
+{
+  double bdp = getBdp();
+  if (bdp == 0)
+    return roundWindowSize * m_options.windowCutMultiplier;
+
+  // the loss is not taken as a congestion signal, only the excess over the BDP is removed
+  return std::min<float>(windowSize, std::max<float>(bdp, roundWindowSize * m_options.windowCutMultiplier));
+}
+
+void
+CongestionControlBbr::onRoundEnd(float windowSize)
+{
+  auto now = time::steady_clock::now();
+  double duration = time::duration_cast<time::microseconds>(now - m_roundStart).count() / 1000.0;
+
+  if (duration > 0 && m_nRoundDelivered > 0) {
+    m_deliveryRates.push_back(m_nRoundDelivered / duration);
+    if (m_deliveryRates.size() > RATE_FILTER_LENGTH)
+      m_deliveryRates.pop_front();
+  }
+
+  m_nRoundDelivered = 0;
+  m_roundStart = now;
+
+  switch (m_state) {
+    case State::Startup: {
+      double maxRate = getMaxDeliveryRate();
+      if (maxRate >= m_fullRate * FULL_RATE_GROWTH) {
+        m_fullRate = maxRate;
+        m_nFullRateRounds = 0;
+      }
+      else if (++m_nFullRateRounds >= FULL_RATE_ROUNDS) {
+        m_state = State::Drain;
+      }
+      break;
+    }
+    case State::Drain:
+      m_state = State::ProbeBw;
+      m_probeBwCycle = 0;
+      break;
+    case State::ProbeBw:
+      m_probeBwCycle = (m_probeBwCycle + 1) % N_PROBE_BW_GAINS;
+      break;
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_BBR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_BBR_HPP
+
+#include "congestion-control.hpp"
+
+#include <deque>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Delay-based congestion control inspired by BBR
+ *
+ * The window is set to a multiple of the estimated bandwidth-delay product, computed as the
+ * maximum delivery rate measured over the last rounds times the minimum RTT. Losses do not cut
+ * the window below the bandwidth-delay product.
+ *
+ * The controller starts in Startup, where the window grows exponentially until the delivery
+ * rate stops growing, then drains the queue built during Startup for one round and finally
+ * probes for more bandwidth one round out of eight (ProbeBw).
+ */
+class CongestionControlBbr : public CongestionControl
+{
+public:
+  enum class State {
+    Startup,
+    Drain,
+    ProbeBw
+  };
+
+  CongestionControlBbr(const PipelineInterestsOptions& options, const RttEstimator& rttEstimator);
+
+  float
+  onData(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+
+  float
+  onLoss(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+
+  void
+  onRoundEnd(float windowSize) NDN_CXX_DECL_FINAL;
+
+  double
+  getPacingGain() const NDN_CXX_DECL_FINAL;
+
+  State
+  getState() const
+  {
+    return m_state;
+  }
+
+  /**
+   * @return the maximum delivery rate of the last rounds, in segments per millisecond
+   */
+  double
+  getMaxDeliveryRate() const;
+
+  /**
+   * @return the estimated bandwidth-delay product in segments, or 0 if it is not known yet
+   */
+  double
+  getBdp() const;
+
+public:
+  static const size_t RATE_FILTER_LENGTH = 10; ///< rounds over which the maximum rate is kept
+  static const size_t N_PROBE_BW_GAINS = 8;
+  static const double PROBE_BW_GAINS[N_PROBE_BW_GAINS];
+
+private:
+  double
+  getGain() const;
+
+private:
+  State m_state;
+  std::deque<double> m_deliveryRates; ///< delivery rate of the last rounds, in segments per ms
+
+  uint64_t m_nRoundDelivered;
+  time::steady_clock::TimePoint m_roundStart;
+
+  double m_fullRate;       ///< maximum rate when the growth has last been checked in Startup
+  size_t m_nFullRateRounds; ///< consecutive rounds in Startup without a significant rate growth
+  size_t m_probeBwCycle;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_BBR_HPP
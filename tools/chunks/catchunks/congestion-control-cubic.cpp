@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "congestion-control-cubic.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+const double CongestionControlCubic::C = 0.4;
+const double CongestionControlCubic::BETA = 0.7;
+
+CongestionControlCubic::CongestionControlCubic(const PipelineInterestsOptions& options,
+                                               const RttEstimator& rttEstimator)
+  : CongestionControl(options, rttEstimator)
+  , m_slowStartThreshold(options.slowStartThreshold)
+  , m_wMax(0)
+  , m_wLastMax(0)
+  , m_k(0)
+  , m_hasEpoch(false)
+{
+}
+
+double
+CongestionControlCubic::getRtt() const
+{
+  if (m_rttEstimator.getRttMean() != -1)
+    return m_rttEstimator.getRttMean() / 1000;
+
+  return 0.1;
+}
+
+float
+CongestionControlCubic::onData(float windowSize, float roundWindowSize)
+{
+  if (m_slowStartThreshold == 0 || windowSize < m_slowStartThreshold)
+    return windowSize + 1;
+
+  auto now = time::steady_clock::now();
+  if (!m_hasEpoch) {
+    // first increase in congestion avoidance without a previous loss
+    m_hasEpoch = true;
+    m_epochStart = now;
+    if (m_wMax < windowSize) {
+      m_wMax = windowSize;
+      m_k = 0;
+    }
+  }
+
+  double rtt = getRtt();
+  double t = time::duration_cast<time::microseconds>(now - m_epochStart).count() / 1000000.0;
+
+  // window that the cubic function reaches in one RTT
+  double target = C * std::pow(t + rtt - m_k, 3) + m_wMax;
+
+  // window of a standard AIMD flow with the same decrease factor
+  double wEst = m_wMax * BETA + (3 * (1 - BETA) / (1 + BETA)) * (t / rtt);
+  if (wEst > target)
+    target = wEst;
+
+  if (target > windowSize)
+    return windowSize + (target - windowSize) / windowSize;
+  else
+    return windowSize + 0.01 / windowSize;
+}
+
+float
+CongestionControlCubic::onLoss(float windowSize, float roundWindowSize)
+{
+  // fast convergence: release bandwidth for the new flows when the window keeps shrinking
+  if (windowSize < m_wLastMax)
+    m_wMax = windowSize * (1 + BETA) / 2;
+  else
+    m_wMax = windowSize;
+  m_wLastMax = windowSize;
+
+  float newWindowSize = windowSize * BETA;
+  m_slowStartThreshold = std::max(newWindowSize, 2.0f);
+
+  m_k = std::cbrt(m_wMax * (1 - BETA) / C);
+  m_hasEpoch = true;
+  m_epochStart = time::steady_clock::now();
+
+  return newWindowSize;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_CUBIC_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_CUBIC_HPP
+
+#include "congestion-control.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief CUBIC window growth (RFC 8312)
+ *
+ * After a loss, the window grows as a cubic function of the time elapsed since the loss, so that
+ * it quickly returns close to the window at which the loss happened and then probes beyond it.
+ * The growth does not depend on the RTT, which allows high bandwidth-delay product paths to be
+ * filled. The window is never lower than the one of a standard AIMD flow (TCP-friendly region).
+ */
+class CongestionControlCubic : public CongestionControl
+{
+public:
+  CongestionControlCubic(const PipelineInterestsOptions& options, const RttEstimator& rttEstimator);
+
+  float
+  onData(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+
+  float
+  onLoss(float windowSize, float roundWindowSize) NDN_CXX_DECL_FINAL;
+
+public:
+  static const double C;    ///< scaling constant of the cubic function
+  static const double BETA; ///< multiplicative decrease factor
+
+private:
+  /**
+   * @return the RTT used to compute the window growth, in seconds
+   */
+  double
+  getRtt() const;
+
+private:
+  double m_slowStartThreshold; ///< 0 means no threshold
+  double m_wMax;               ///< window before the last reduction
+  double m_wLastMax;           ///< window before the previous reduction, for fast convergence
+  double m_k;                  ///< time to grow back to m_wMax, in seconds
+  bool m_hasEpoch;
+  time::steady_clock::TimePoint m_epochStart;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_CUBIC_HPP
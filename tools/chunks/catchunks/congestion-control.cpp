@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "congestion-control.hpp"
+#include "congestion-control-aimd.hpp"
+#include "congestion-control-bbr.hpp"
+#include "congestion-control-cubic.hpp"
+
+namespace ndn {
+namespace chunks {
+
+CongestionControl::CongestionControl(const PipelineInterestsOptions& options,
+                                     const RttEstimator& rttEstimator)
+  : m_options(options)
+  , m_rttEstimator(rttEstimator)
+{
+}
+
+CongestionControl::~CongestionControl() = default;
+
+unique_ptr<CongestionControl>
+CongestionControl::create(const std::string& type, const PipelineInterestsOptions& options,
+                          const RttEstimator& rttEstimator)
+{
+  if (type == "aimd")
+    return make_unique<CongestionControlAimd>(options, rttEstimator);
+  if (type == "cubic")
+    return make_unique<CongestionControlCubic>(options, rttEstimator);
+  if (type == "bbr")
+    return make_unique<CongestionControlBbr>(options, rttEstimator);
+
+  return nullptr;
+}
+
+void
+CongestionControl::onRoundEnd(float windowSize)
+{
+}
+
+double
+CongestionControl::getPacingGain() const
+{
+  return 1.25;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_HPP
+
+#include "pipeline-interests.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Congestion controller of the Interest window of PipelineInterests
+ *
+ * The pipeline divides the retrieval in rounds: a round ends when as many segments as the window
+ * size at its beginning have been received or timed out. The controller is notified of every
+ * received segment, of the first loss of every round and of the end of every round. The window
+ * size returned by the controller is bounded by the pipeline between the start and the max
+ * pipeline size.
+ */
+class CongestionControl : noncopyable
+{
+public:
+  CongestionControl(const PipelineInterestsOptions& options, const RttEstimator& rttEstimator);
+
+  virtual
+  ~CongestionControl();
+
+  /**
+   * @brief create the congestion controller named @p type
+   *
+   * @param type one of "aimd", "cubic" or "bbr"
+   * @return the controller, or nullptr if @p type is unknown
+   */
+  static unique_ptr<CongestionControl>
+  create(const std::string& type, const PipelineInterestsOptions& options,
+         const RttEstimator& rttEstimator);
+
+  /**
+   * @brief compute the window size after a segment has been received
+   *
+   * @param windowSize the current window size
+   * @param roundWindowSize the window size at the beginning of the current round
+   */
+  virtual float
+  onData(float windowSize, float roundWindowSize) = 0;
+
+  /**
+   * @brief compute the window size after a loss, called at most once per round
+   *
+   * @param windowSize the current window size
+   * @param roundWindowSize the window size at the beginning of the current round
+   */
+  virtual float
+  onLoss(float windowSize, float roundWindowSize) = 0;
+
+  /**
+   * @brief notify the end of a round
+   *
+   * @param windowSize the window size at the end of the round, i.e. at the beginning of the next
+   */
+  virtual void
+  onRoundEnd(float windowSize);
+
+  /**
+   * @return the factor applied to the estimated bottleneck rate to obtain the pacing rate
+   *
+   * It must allow some headroom over the bottleneck rate, otherwise the delivery rate, and with
+   * it the pacing rate, cannot grow.
+   */
+  virtual double
+  getPacingGain() const;
+
+protected:
+  const PipelineInterestsOptions& m_options;
+  const RttEstimator& m_rttEstimator;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_CONTROL_HPP
@@ -26,7 +26,11 @@
  */
 
 #include "consumer.hpp"
+#include "data-fetcher.hpp"
 #include "discover-version.hpp"
+#include "discovery-cache.hpp"
+
+#include <numeric>
 
 namespace ndn {
 namespace chunks {
@@ -39,29 +43,52 @@ Consumer::Consumer(Face& face, Validator& validator, bool isVerbose, std::ostrea
   , m_nextToPrint(0)
   , m_outputStream(os)
   , m_isVerbose(isVerbose)
+  , m_isComplete(false)
   , m_printStat(printStat)
   , m_scheduler(face.getIoService())
+  , m_nReceivedSegments(0)
+  , m_lastSegmentNo(0)
+  , m_hasFinalBlockId(false)
+  , m_speculativeWindow(0)
+  , m_discoveryCache(nullptr)
+  , m_isCachedVersion(false)
+  , m_syncEvent(m_scheduler)
 {
   m_statIntervalMs = 500;
 }
 
 void
 Consumer::run(DiscoverVersion& discover, PipelineInterests& pipeline, bool noDiscovery)
+{
+  start(discover, pipeline, noDiscovery);
+
+  m_face.processEvents();
+}
+
+void
+Consumer::start(DiscoverVersion& discover, PipelineInterests& pipeline, bool noDiscovery)
 {
   m_pipeline = &pipeline;
   m_nextToPrint = 0;
+  m_isComplete = false;
+  m_prefix = discover.m_prefix;
+  m_nameWithVersion.clear();
+  m_isCachedVersion = false;
 
-  if (!noDiscovery) {
+  if (noDiscovery) {
+    runWithName(discover.m_prefix);
+  }
+  else if (!runWithCachedVersion(discover.m_prefix)) {
     discover.onDiscoverySuccess.connect(bind(&Consumer::runWithData, this, _1));
     discover.onDiscoveryFailure.connect(bind(&Consumer::onFailure, this, _1));
+    if (m_speculativeWindow > 0 && m_resumableOutput == nullptr)
+      discover.onVersionCandidate.connect(bind(&Consumer::speculate, this, _1));
     discover.run();
   }
-  else{
-    runWithName(discover.m_prefix);
-  }
-
 
-  m_face.processEvents();
+  if (m_resumableOutput != nullptr)
+    m_syncEvent = m_scheduler.scheduleEvent(time::seconds(1),
+                                            bind(&Consumer::syncResumableOutput, this));
 }
 
 void
@@ -70,21 +97,64 @@ Consumer::cancel()
   m_face.getIoService().stop();
 }
 
+void
+Consumer::setOutputFd(int fd)
+{
+  m_segmentWriter = make_unique<SegmentWriter>(fd);
+}
+
+void
+Consumer::setWriterThread(size_t ringCapacity)
+{
+  m_asyncWriter = make_unique<AsyncWriter>(m_face.getIoService(), m_outputStream, ringCapacity,
+                                           bind(&Consumer::onWriterSpace, this),
+                                           bind(&Consumer::onFailure, this, _1));
+}
+
+void
+Consumer::setResumableOutput(const std::string& path)
+{
+  m_resumableOutput = make_unique<ResumableOutput>(path);
+}
+
 void
 Consumer::runWithData(const Data& data)
 {
   m_nReceivedSegments = 0;
   m_lastSegmentNo = 0;
+  m_hasFinalBlockId = false;
   m_receivedBytes = 0;
   m_lastReceivedBytes = 0;
 
+  bool isResumed = false;
+  Name nameWithVersion = data.getName().getPrefix(-1);
+  m_nameWithVersion = nameWithVersion;
+  if (m_resumableOutput != nullptr && !data.getFinalBlockId().empty()) {
+    m_resumableOutput->start(nameWithVersion, data.getFinalBlockId().toSegment());
+    isResumed = true;
+  }
+
   m_validator.validate(data,
                        bind(&Consumer::onDataValidated, this, _1),
                        bind(&Consumer::onFailure, this, _2));
 
-  m_pipeline->runWithExcludedSegment(data,
-                                     bind(&Consumer::onData, this, _1, _2),
-                                     bind(&Consumer::onFailure, this, _1));
+  if (isResumed) {
+    // the validation of data may not be over yet
+    std::vector<uint64_t> missingSegments = m_resumableOutput->getMissingSegments();
+    missingSegments.erase(std::remove(missingSegments.begin(), missingSegments.end(),
+                                      data.getName()[-1].toSegment()),
+                          missingSegments.end());
+
+    m_pipeline->runWithSegments(nameWithVersion, m_resumableOutput->getLastSegmentNo(),
+                                missingSegments,
+                                bind(&Consumer::onData, this, _1, _2),
+                                bind(&Consumer::onFailure, this, _1));
+  }
+  else if (!runWithSpeculativeData(data)) {
+    m_pipeline->runWithExcludedSegment(data,
+                                       bind(&Consumer::onData, this, _1, _2),
+                                       bind(&Consumer::onFailure, this, _1));
+  }
 
   m_startTime = time::steady_clock::now();
   m_lastPrintTime = m_startTime;
@@ -95,17 +165,38 @@ Consumer::runWithData(const Data& data)
 }
 
 void
-Consumer::runWithName(Name nameWithVersion)
+Consumer::runWithName(Name nameWithVersion, uint64_t lastSegmentNo)
 {
   m_nReceivedSegments = 0;
   m_lastSegmentNo = std::numeric_limits<uint64_t>::max();
+  m_hasFinalBlockId = false;
   m_receivedBytes = 0;
   m_lastReceivedBytes = 0;
 
-
-  m_pipeline->runWithName(nameWithVersion,
-                          bind(&Consumer::onData, this, _1, _2),
-                          bind(&Consumer::onFailure, this, _1));
+  if (m_resumableOutput != nullptr && m_resumableOutput->resume(nameWithVersion)) {
+    m_lastSegmentNo = m_resumableOutput->getLastSegmentNo();
+    m_hasFinalBlockId = true;
+    m_pipeline->runWithSegments(nameWithVersion, m_lastSegmentNo,
+                                m_resumableOutput->getMissingSegments(),
+                                bind(&Consumer::onData, this, _1, _2),
+                                bind(&Consumer::onFailure, this, _1));
+    // all the segments may have been written before the interruption
+    checkCompletion();
+  }
+  else if (lastSegmentNo != std::numeric_limits<uint64_t>::max()) {
+    m_lastSegmentNo = lastSegmentNo;
+    m_hasFinalBlockId = true;
+    std::vector<uint64_t> segments(lastSegmentNo + 1);
+    std::iota(segments.begin(), segments.end(), 0);
+    m_pipeline->runWithSegments(nameWithVersion, lastSegmentNo, segments,
+                                bind(&Consumer::onData, this, _1, _2),
+                                bind(&Consumer::onFailure, this, _1));
+  }
+  else {
+    m_pipeline->runWithName(nameWithVersion,
+                            bind(&Consumer::onData, this, _1, _2),
+                            bind(&Consumer::onFailure, this, _1));
+  }
 
   m_startTime = time::steady_clock::now();
   m_lastPrintTime = m_startTime;
@@ -115,6 +206,139 @@ Consumer::runWithName(Name nameWithVersion)
   }
 }
 
+bool
+Consumer::runWithCachedVersion(const Name& prefix)
+{
+  DiscoveryCache::Entry entry;
+  if (m_discoveryCache == nullptr || !m_discoveryCache->find(prefix, entry))
+    return false;
+
+  // with fixed version discovery, the prefix already ends with the version
+  Name nameWithVersion = prefix;
+  if (prefix.empty() || !prefix[-1].isVersion() || prefix[-1].toVersion() != entry.version)
+    nameWithVersion.appendVersion(entry.version);
+
+  if (m_isVerbose)
+    std::cerr << "Cached version: " << nameWithVersion << std::endl;
+
+  m_isCachedVersion = true;
+  m_pipeline->rttEstimator.seed(entry.rttMean, entry.rttVar);
+  m_pipeline->setInitialWindowSize(entry.windowSize);
+
+  runWithName(nameWithVersion, entry.lastSegmentNo);
+  return true;
+}
+
+void
+Consumer::updateDiscoveryCache()
+{
+  if (m_discoveryCache == nullptr || m_nameWithVersion.empty() ||
+      !m_nameWithVersion[-1].isVersion())
+    return;
+
+  DiscoveryCache::Entry entry;
+  entry.version = m_nameWithVersion[-1].toVersion();
+  entry.lastSegmentNo = m_lastSegmentNo;
+  entry.rttMean = m_pipeline->rttEstimator.getRttMean();
+  entry.rttVar = m_pipeline->rttEstimator.getRttVar();
+  entry.windowSize = static_cast<uint32_t>(m_pipeline->getWindowSize());
+  m_discoveryCache->insert(m_prefix, entry);
+}
+
+void
+Consumer::speculate(const Data& data)
+{
+  Name nameWithVersion = data.getName().getPrefix(-1);
+  if (nameWithVersion == m_speculativeName || !data.getName()[-1].isSegment())
+    return;
+
+  // a larger version has been found
+  cancelSpeculation();
+  m_speculativeName = nameWithVersion;
+
+  uint64_t lastSegmentNo = m_speculativeWindow - 1;
+  if (!data.getFinalBlockId().empty())
+    lastSegmentNo = std::min(lastSegmentNo, data.getFinalBlockId().toSegment());
+
+  uint64_t excludedSegmentNo = data.getName()[-1].toSegment();
+  for (uint64_t segmentNo = 0; segmentNo <= lastSegmentNo; ++segmentNo) {
+    if (segmentNo == excludedSegmentNo)
+      continue;
+
+    Interest interest(Name(nameWithVersion).appendSegment(segmentNo));
+    interest.setInterestLifetime(m_pipeline->getInterestLifetime());
+    interest.refreshNonce();
+
+    // no retransmissions, the pipeline fetches the segments that are still missing
+    m_speculativeFetchers.push_back(DataFetcher::fetch(m_face, interest, 0, 0,
+                                                       bind(&Consumer::onSpeculativeData, this,
+                                                            _1, _2),
+                                                       nullptr, nullptr, nullptr, nullptr,
+                                                       m_isVerbose, nullptr));
+  }
+
+  if (m_isVerbose)
+    std::cerr << "Speculatively fetching " << m_speculativeFetchers.size()
+              << " segments of " << nameWithVersion << std::endl;
+}
+
+void
+Consumer::onSpeculativeData(const Interest& interest, const Data& data)
+{
+  m_speculativeData[data.getName()[-1].toSegment()] = make_shared<Data>(data);
+}
+
+bool
+Consumer::runWithSpeculativeData(const Data& data)
+{
+  Name nameWithVersion = data.getName().getPrefix(-1);
+  bool isConfirmed = nameWithVersion == m_speculativeName && !data.getFinalBlockId().empty();
+
+  std::map<uint64_t, shared_ptr<const Data>> speculativeData;
+  speculativeData.swap(m_speculativeData);
+  // the segments still in flight are requested again by the pipeline
+  cancelSpeculation();
+
+  if (!isConfirmed)
+    return false;
+
+  uint64_t lastSegmentNo = data.getFinalBlockId().toSegment();
+  uint64_t excludedSegmentNo = data.getName()[-1].toSegment();
+  std::vector<uint64_t> missingSegments;
+  for (uint64_t segmentNo = 0; segmentNo <= lastSegmentNo; ++segmentNo) {
+    if (segmentNo != excludedSegmentNo && speculativeData.count(segmentNo) == 0)
+      missingSegments.push_back(segmentNo);
+  }
+
+  if (m_isVerbose)
+    std::cerr << "Speculation confirmed, " << speculativeData.size()
+              << " segments already received" << std::endl;
+
+  m_pipeline->runWithSegments(nameWithVersion, lastSegmentNo, missingSegments,
+                              bind(&Consumer::onData, this, _1, _2),
+                              bind(&Consumer::onFailure, this, _1));
+
+  for (const auto& segment : speculativeData) {
+    if (segment.first <= lastSegmentNo)
+      m_validator.validate(*segment.second,
+                           bind(&Consumer::onDataValidated, this, _1),
+                           bind(&Consumer::onFailure, this, _2));
+  }
+
+  return true;
+}
+
+void
+Consumer::cancelSpeculation()
+{
+  for (const auto& fetcher : m_speculativeFetchers)
+    fetcher->cancel();
+
+  m_speculativeFetchers.clear();
+  m_speculativeData.clear();
+  m_speculativeName.clear();
+}
+
 void
 Consumer::onData(const Interest& interest, const Data& data)
 {
@@ -131,24 +355,59 @@ Consumer::onDataValidated(shared_ptr<const Data> data)
       std::cerr << "Application level NACK: " << *data << std::endl;
 
     m_pipeline->cancel();
+    if (m_onFailure) {
+      m_onFailure(ApplicationNackError(*data).what());
+      return;
+    }
     throw ApplicationNackError(*data);
   }
 
-  m_lastSegmentNo = data->getFinalBlockId().toSegment();
+  // a streamed content has the FinalBlockId only in its last segment
+  if (!data->getFinalBlockId().empty()) {
+    m_lastSegmentNo = data->getFinalBlockId().toSegment();
+    m_hasFinalBlockId = true;
+  }
 
-  m_bufferedData[data->getName()[-1].toSegment()] = data;
+  if (m_resumableOutput != nullptr) {
+    if (!m_resumableOutput->isStarted()) {
+      if (!m_hasFinalBlockId) {
+        m_pipeline->cancel();
+        onFailure("Segment " + data->getName().toUri() + " has no FinalBlockId, "
+                  "resume requires the number of segments");
+        return;
+      }
+      m_resumableOutput->start(data->getName().getPrefix(-1), m_lastSegmentNo);
+    }
+    m_resumableOutput->addSegment(data);
+  }
+  else if (m_segmentWriter != nullptr)
+    m_segmentWriter->addSegment(data);
+  else
+    m_bufferedData[data->getName()[-1].toSegment()] = data;
 
   m_receivedBytes += 1407; // data->getContent().value_size(); // TODO
   m_lastReceivedBytes += 1407; // data->getContent().value_size();
 
   m_nReceivedSegments++;
 
-  writeInOrderData();
+  if (m_segmentWriter == nullptr && m_resumableOutput == nullptr)
+    writeInOrderData();
+
+  checkCompletion();
 }
 
 void
 Consumer::onFailure(const std::string& reason)
 {
+  // the cached version may have been removed, the next retrieval discovers the version again
+  if (m_isCachedVersion)
+    m_discoveryCache->erase(m_prefix);
+
+  if (m_onFailure) {
+    m_onFailure(reason);
+    return;
+  }
+
   throw std::runtime_error(reason);
 }
 
@@ -161,8 +420,12 @@ Consumer::printStatistics()
       time::duration_cast<time::milliseconds> (time::steady_clock::now() - m_lastPrintTime);
 
   if (m_receivedBytes > 0) {
-    int perc = (static_cast<float>(m_nReceivedSegments) / m_lastSegmentNo) * 100;
-    std::cerr << perc << "% \t"
+    if (m_hasFinalBlockId)
+      std::cerr << static_cast<int>(static_cast<float>(m_nReceivedSegments) /
+                                    (m_lastSegmentNo + 1) * 100) << "% \t";
+    else
+      std::cerr << m_nReceivedSegments << " segments \t";
+    std::cerr
               << " T " << static_cast<double>(m_receivedBytes/1000) << " KB \t"
               << static_cast<double>(m_receivedBytes) / (runningTime.count()) << " KB/s \t"
               << " C " << static_cast<double>(m_lastReceivedBytes/1000) << " KB  \t"
@@ -171,6 +434,9 @@ Consumer::printStatistics()
               << "Rtt " << int(m_pipeline->rttEstimator.getRttMean())
               << "(" << int(m_pipeline->rttEstimator.getRttVar()) << ") "
               << "(" << int(m_pipeline->rttEstimator.getRtoMultiplier()) << ")\t"
+              << "p50/p99/p99.9 " << m_pipeline->rttHistogram.getValueAtPercentile(50) / 1000.0
+              << "/" << m_pipeline->rttHistogram.getValueAtPercentile(99) / 1000.0
+              << "/" << m_pipeline->rttHistogram.getValueAtPercentile(99.9) / 1000.0 << " ms"
               << std::endl;
   }
   else {
@@ -185,11 +451,77 @@ Consumer::printStatistics()
     m_pipeline->setWindowSize(m_pipeline->getWindowSize() + m_windowMultiplier);
   }*/
 
-  if (m_nReceivedSegments < m_lastSegmentNo) {
+  // a resumed transfer receives only the missing segments
+  if (!m_isComplete && (!m_hasFinalBlockId || m_nReceivedSegments < m_lastSegmentNo)) {
     m_scheduler.scheduleEvent(time::milliseconds(m_statIntervalMs), bind(&Consumer::printStatistics, this));
   }
-  else
+  else {
+    printTimeSummary();
     m_face.getIoService().stop();
+  }
+}
+
+void
+Consumer::printTimeSummary() const
+{
+  const tools::HdrHistogram* histograms[] = {&m_pipeline->rttHistogram,
+                                             &m_pipeline->retrievalTimeHistogram};
+  const char* names[] = {"Rtt", "Retrieval time"};
+
+  for (size_t i = 0; i < 2; ++i) {
+    const tools::HdrHistogram& histogram = *histograms[i];
+    std::cerr << names[i] << " min/avg/max = " << histogram.getMin() / 1000.0
+              << "/" << histogram.getMean() / 1000.0
+              << "/" << histogram.getMax() / 1000.0 << " ms, "
+              << "p50/p90/p99/p99.9 = " << histogram.getValueAtPercentile(50) / 1000.0
+              << "/" << histogram.getValueAtPercentile(90) / 1000.0
+              << "/" << histogram.getValueAtPercentile(99) / 1000.0
+              << "/" << histogram.getValueAtPercentile(99.9) / 1000.0 << " ms"
+              << " (" << histogram.getTotalCount() << " segments)" << std::endl;
+  }
+}
+
+bool
+Consumer::isComplete() const
+{
+  if (m_resumableOutput != nullptr)
+    return m_resumableOutput->isComplete();
+
+  uint64_t nextSegmentNo = m_segmentWriter != nullptr ? m_segmentWriter->getNextSegmentNo() :
+                                                        m_nextToPrint;
+  return m_hasFinalBlockId && nextSegmentNo > m_lastSegmentNo;
+}
+
+void
+Consumer::checkCompletion()
+{
+  if (m_isComplete || !isComplete())
+    return;
+
+  m_isComplete = true;
+  updateDiscoveryCache();
+
+  if (m_resumableOutput != nullptr) {
+    m_syncEvent.cancel();
+    m_resumableOutput->sync();
+  }
+
+  // the last segments may still be in the ring
+  if (m_asyncWriter != nullptr)
+    m_asyncWriter->close();
+
+  if (m_onComplete)
+    m_onComplete();
+}
+
+void
+Consumer::syncResumableOutput()
+{
+  m_resumableOutput->sync();
+
+  if (!m_isComplete)
+    m_syncEvent = m_scheduler.scheduleEvent(time::seconds(1),
+                                            bind(&Consumer::syncResumableOutput, this));
 }
 
 void
@@ -200,8 +532,36 @@ Consumer::writeInOrderData()
        it = m_bufferedData.erase(it), ++m_nextToPrint) {
 
     const Block& content = it->second->getContent();
-    m_outputStream.write(reinterpret_cast<const char*>(content.value()), content.value_size());
+    if (m_asyncWriter == nullptr)
+      m_outputStream.write(reinterpret_cast<const char*>(content.value()), content.value_size());
+    else if (!m_asyncWriter->push(content))
+      break; // pushed again once the writer has made room
   }
+
+  if (m_asyncWriter != nullptr)
+    updateReceiveWindow();
+}
+
+void
+Consumer::updateReceiveWindow()
+{
+  // the segments waiting for an earlier one will take a slot of the ring as well
+  size_t nFree = m_asyncWriter->getNFree();
+  size_t receiveWindow = nFree > m_bufferedData.size() ? nFree - m_bufferedData.size() : 0;
+  m_pipeline->setReceiveWindow(receiveWindow);
+
+  if (receiveWindow < m_asyncWriter->getCapacity() / 2)
+    m_asyncWriter->requestSpace();
+}
+
+void
+Consumer::onWriterSpace()
+{
+  if (m_isComplete)
+    return;
+
+  writeInOrderData();
+  checkCompletion();
 }
 
 } // namespace chunks
@@ -30,13 +30,18 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_CONSUMER_HPP
 
 #include "pipeline-interests.hpp"
+#include "async-writer.hpp"
 #include "discover-version.hpp"
+#include "resumable-output.hpp"
+#include "segment-writer.hpp"
 
 #include <ndn-cxx/security/validator.hpp>
 
 namespace ndn {
 namespace chunks {
 
+class DiscoveryCache;
+
 /**
  * @brief Segmented version consumer
  *
@@ -63,21 +68,148 @@ public:
   Consumer(Face& face, Validator& validator, bool isVerbose,
            std::ostream& os = std::cout, bool printStat = false);
 
+  typedef function<void()> CompletionCallback;
+  typedef function<void(const std::string& reason)> FailureCallback;
+
   /**
    * @brief Run the consumer
    */
   void
   run(DiscoverVersion& discover, PipelineInterests& pipeline, bool noDiscovery = false);
 
+  /**
+   * @brief Start the consumer without processing the events of the face
+   *
+   * Used when several consumers share the same face.
+   */
+  void
+  start(DiscoverVersion& discover, PipelineInterests& pipeline, bool noDiscovery = false);
+
   void
   cancel();
 
+  /**
+   * @brief write the retrieved content directly to @p fd instead of the output stream
+   *
+   * The segments are written with a SegmentWriter, without copying their content.
+   */
+  void
+  setOutputFd(int fd);
+
+  /**
+   * @brief write the retrieved content to the output stream from a dedicated thread
+   *
+   * The segments are passed to the thread through a ring of @p ringCapacity segments. When the
+   * output is slower than the network, the receive window of the pipeline is reduced to the room
+   * left in the ring instead of blocking the event loop.
+   */
+  void
+  setWriterThread(size_t ringCapacity);
+
+  /**
+   * @brief write the retrieved content to the file at @p path, resuming the transfer recorded in
+   *        its sidecar if any
+   *
+   * Only the segments missing from the file are fetched. The received segments are recorded in
+   * the sidecar every second.
+   *
+   * @throw ResumableOutput::Error the file cannot be opened
+   */
+  void
+  setResumableOutput(const std::string& path);
+
+  /**
+   * @brief fetch the first @p nSegments segments of the candidate versions reported by the
+   *        discovery while it goes on (0 = disabled)
+   *
+   * When the discovery confirms a candidate version, only the segments that have not been
+   * received yet are fetched by the pipeline, which saves at least one round trip for the
+   * objects that fit in the first window. The segments of a candidate superseded by a larger
+   * version are discarded. The speculative Interests are not retransmitted. Not used with a
+   * resumable output.
+   */
+  void
+  setSpeculativeWindow(size_t nSegments)
+  {
+    m_speculativeWindow = nSegments;
+  }
+
+  /**
+   * @brief skip the version discovery of the prefixes found in @p cache, and store the result of
+   *        the discovery of the other prefixes once their content has been retrieved
+   *
+   * With a cached version, all the segments are requested right away, and the RTT estimator and
+   * the window of the pipeline start from the values of the previous retrieval. If the retrieval
+   * of a cached version fails, its entry is erased. @p cache must outlive the consumer.
+   */
+  void
+  setDiscoveryCache(DiscoveryCache& cache)
+  {
+    m_discoveryCache = &cache;
+  }
+
+  /**
+   * @brief call @p onComplete once all the segments have been written
+   */
+  void
+  setCompletionCallback(const CompletionCallback& onComplete)
+  {
+    m_onComplete = onComplete;
+  }
+
+  /**
+   * @brief report the errors to @p onFailure instead of throwing them from the event loop
+   */
+  void
+  setFailureCallback(const FailureCallback& onFailure)
+  {
+    m_onFailure = onFailure;
+  }
+
 private:
   void
   runWithData(const Data& data);
 
+  /**
+   * @param lastSegmentNo the last segment of the content, if known
+   */
+  void
+  runWithName(Name nameWithVersion,
+              uint64_t lastSegmentNo = std::numeric_limits<uint64_t>::max());
+
+  /**
+   * @brief fetch the version of @p prefix found in the discovery cache, if any
+   *
+   * @return false if the discovery cannot be skipped
+   */
+  bool
+  runWithCachedVersion(const Name& prefix);
+
+  /**
+   * @brief store the discovered version, the RTT and the window of the completed retrieval
+   */
+  void
+  updateDiscoveryCache();
+
+  /**
+   * @brief start fetching the first segments of the version of @p data
+   */
+  void
+  speculate(const Data& data);
+
+  void
+  onSpeculativeData(const Interest& interest, const Data& data);
+
+  /**
+   * @brief fetch the segments of the version of @p data that the speculation has not received
+   *
+   * @return false if the speculation cannot be used for @p data
+   */
+  bool
+  runWithSpeculativeData(const Data& data);
+
   void
-  runWithName(Name nameWithVersion);
+  cancelSpeculation();
 
   void
   onData(const Interest& interest, const Data& data);
@@ -91,6 +223,33 @@ private:
   void
   printStatistics();
 
+  /**
+   * @brief print the percentiles of the round trip and retrieval times of the segments
+   */
+  void
+  printTimeSummary() const;
+
+  bool
+  isComplete() const;
+
+  /**
+   * @brief notify the completion, if all the segments have been written
+   */
+  void
+  checkCompletion();
+
+  void
+  syncResumableOutput();
+
+  /**
+   * @brief limit the segments in flight to the room left in the ring of the writer thread
+   */
+  void
+  updateReceiveWindow();
+
+  void
+  onWriterSpace();
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   writeInOrderData();
@@ -102,13 +261,17 @@ private:
   uint64_t m_nextToPrint;
   std::ostream& m_outputStream;
   bool m_isVerbose;
+  CompletionCallback m_onComplete;
+  FailureCallback m_onFailure;
+  bool m_isComplete;
 
   // Statistics
   bool m_printStat;
   uint32_t m_statIntervalMs;
   Scheduler m_scheduler;
   uint64_t m_nReceivedSegments;
-  uint64_t m_lastSegmentNo;
+  uint64_t m_lastSegmentNo; ///< valid only if m_hasFinalBlockId
+  bool m_hasFinalBlockId; ///< false until the last segment is known, e.g. when streamed
   uint64_t m_receivedBytes;
   time::steady_clock::TimePoint m_startTime;
 
@@ -117,8 +280,23 @@ private:
 
   int m_windowMultiplier;
 
+  // Speculative fetching of the candidate versions
+  size_t m_speculativeWindow;
+  Name m_speculativeName;
+  std::vector<shared_ptr<DataFetcher>> m_speculativeFetchers;
+
+  DiscoveryCache* m_discoveryCache;
+  Name m_prefix;
+  Name m_nameWithVersion; ///< name of the discovered version, empty if the discovery was skipped
+  bool m_isCachedVersion;
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::map<uint64_t, shared_ptr<const Data>> m_bufferedData;
+  std::map<uint64_t, shared_ptr<const Data>> m_speculativeData;
+  unique_ptr<SegmentWriter> m_segmentWriter;
+  unique_ptr<ResumableOutput> m_resumableOutput;
+  unique_ptr<AsyncWriter> m_asyncWriter;
+  scheduler::ScopedEventId m_syncEvent;
 };
 
 } // namespace chunks
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "delivery-rate-estimator.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace chunks {
+
+DeliveryRateEstimator::DeliveryRateEstimator(const time::milliseconds& sampleInterval,
+                                             size_t filterLength)
+  : m_sampleInterval(sampleInterval)
+  , m_filterLength(filterLength)
+  , m_nDelivered(0)
+  , m_nDeliveredBytes(0)
+  , m_sampleStartDelivered(0)
+  , m_lastRate(0)
+{
+  BOOST_ASSERT(m_filterLength > 0);
+}
+
+void
+DeliveryRateEstimator::addDelivery(size_t nBytes)
+{
+  auto now = time::steady_clock::now();
+
+  if (m_nDelivered == 0) {
+    m_firstDeliveryTime = now;
+    m_sampleStart = now;
+  }
+
+  ++m_nDelivered;
+  m_nDeliveredBytes += nBytes;
+
+  time::nanoseconds elapsed = now - m_sampleStart;
+  if (elapsed < m_sampleInterval)
+    return;
+
+  // the segment that starts a sample is not part of it
+  double elapsedMs = time::duration_cast<time::microseconds>(elapsed).count() / 1000.0;
+  m_lastRate = (m_nDelivered - m_sampleStartDelivered - 1) / elapsedMs;
+
+  m_rates.push_back(m_lastRate);
+  if (m_rates.size() > m_filterLength)
+    m_rates.pop_front();
+
+  m_sampleStart = now;
+  m_sampleStartDelivered = m_nDelivered - 1;
+}
+
+void
+DeliveryRateEstimator::setSampleInterval(const time::milliseconds& sampleInterval)
+{
+  m_sampleInterval = sampleInterval;
+}
+
+double
+DeliveryRateEstimator::getMaxDeliveryRate() const
+{
+  if (m_rates.empty())
+    return 0;
+
+  return *std::max_element(m_rates.begin(), m_rates.end());
+}
+
+double
+DeliveryRateEstimator::getGoodput() const
+{
+  if (m_nDelivered < 2)
+    return 0;
+
+  auto elapsed = time::duration_cast<time::microseconds>(time::steady_clock::now() -
+                                                         m_firstDeliveryTime);
+  if (elapsed.count() <= 0)
+    return 0;
+
+  return m_nDeliveredBytes * 1000000.0 / elapsed.count();
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_DELIVERY_RATE_ESTIMATOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_DELIVERY_RATE_ESTIMATOR_HPP
+
+#include "core/common.hpp"
+
+#include <deque>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Estimates the delivery rate and the goodput from the arrival times of the Data
+ *
+ * The delivery rate is sampled over intervals of at least the sample interval, which should be
+ * close to the RTT so that a sample is not biased by the bursts of the window. The maximum of
+ * the last samples estimates the bottleneck rate.
+ */
+class DeliveryRateEstimator
+{
+public:
+  explicit
+  DeliveryRateEstimator(const time::milliseconds& sampleInterval = time::milliseconds(100),
+                        size_t filterLength = 10);
+
+  /**
+   * @brief record the arrival of a segment with @p nBytes of content
+   */
+  void
+  addDelivery(size_t nBytes);
+
+  void
+  setSampleInterval(const time::milliseconds& sampleInterval);
+
+  /**
+   * @return the delivery rate of the last complete sample, in segments per millisecond, or 0 if
+   *         no sample is complete yet
+   */
+  double
+  getDeliveryRate() const
+  {
+    return m_lastRate;
+  }
+
+  /**
+   * @return the maximum delivery rate of the last samples, in segments per millisecond
+   */
+  double
+  getMaxDeliveryRate() const;
+
+  /**
+   * @return the content bytes delivered per second since the first segment, or 0 if less than
+   *         two segments have been delivered
+   */
+  double
+  getGoodput() const;
+
+  uint64_t
+  getNDelivered() const
+  {
+    return m_nDelivered;
+  }
+
+  uint64_t
+  getNDeliveredBytes() const
+  {
+    return m_nDeliveredBytes;
+  }
+
+private:
+  time::nanoseconds m_sampleInterval;
+  size_t m_filterLength;
+
+  uint64_t m_nDelivered;
+  uint64_t m_nDeliveredBytes;
+  time::steady_clock::TimePoint m_firstDeliveryTime;
+
+  time::steady_clock::TimePoint m_sampleStart;
+  uint64_t m_sampleStartDelivered;
+
+  double m_lastRate;
+  std::deque<double> m_rates; ///< the last samples, in segments per millisecond
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_DELIVERY_RATE_ESTIMATOR_HPP
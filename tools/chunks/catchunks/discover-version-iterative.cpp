@@ -81,6 +81,8 @@ DiscoverVersionIterative::handleData(const Interest& interest, const Data& data)
 
     if (isVerbose)
       std::cerr << "Discovered version = " << m_latestVersion << std::endl;
+
+    this->emitSignal(onVersionCandidate, data);
   }
   else {
     // didn't find a version number at expected index.
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "discover-version-parallel.hpp"
+#include "data-fetcher.hpp"
+
+#include "../chunks-tracepoint.hpp"
+
+namespace ndn {
+namespace chunks {
+
+DiscoverVersionParallel::DiscoverVersionParallel(const Name& prefix, Face& face,
+                                                 const Options& options)
+  : chunks::Options(options)
+  , DiscoverVersion(prefix, face, options)
+  , Options(options)
+  , m_nPendingRanges(0)
+  , m_latestVersion(0)
+  , m_latestVersionData(nullptr)
+  , m_isFinished(false)
+{
+  if (nRanges == 0)
+    BOOST_THROW_EXCEPTION(std::invalid_argument("the number of version ranges must be positive"));
+}
+
+DiscoverVersionParallel::~DiscoverVersionParallel()
+{
+  for (size_t rangeNo = 0; rangeNo < m_ranges.size(); ++rangeNo)
+    closeRange(rangeNo);
+}
+
+void
+DiscoverVersionParallel::run()
+{
+  for (size_t rangeNo = 0; rangeNo < m_ranges.size(); ++rangeNo)
+    closeRange(rangeNo);
+  m_ranges.clear();
+  m_latestVersion = 0;
+  m_latestVersionData = nullptr;
+  m_lastFailureReason.clear();
+  m_isFinished = false;
+
+  // versions are milliseconds since the Unix epoch, the newest range is open towards the future
+  uint64_t now = time::toUnixTimestamp(time::system_clock::now()).count();
+  uint64_t age = newestRangeAge.count();
+  uint64_t last = std::numeric_limits<uint64_t>::max();
+
+  while (m_ranges.size() < nRanges) {
+    Range range;
+    range.first = (m_ranges.size() + 1 == nRanges || age >= now) ? 0 : now - age;
+    range.last = last;
+    range.isPending = true;
+    m_ranges.push_back(range);
+
+    if (range.first == 0)
+      break;
+    last = range.first - 1;
+    age = age > now / 10 ? now : age * 10;
+  }
+
+  m_nPendingRanges = m_ranges.size();
+  for (size_t rangeNo = 0; rangeNo < m_ranges.size(); ++rangeNo)
+    expressRangeInterest(rangeNo);
+}
+
+void
+DiscoverVersionParallel::expressRangeInterest(size_t rangeNo)
+{
+  Range& range = m_ranges[rangeNo];
+
+  Exclude exclude;
+  if (range.first > 0)
+    exclude.excludeBefore(name::Component::fromVersion(range.first - 1));
+  if (range.last < std::numeric_limits<uint64_t>::max())
+    exclude.excludeAfter(name::Component::fromVersion(range.last + 1));
+
+  for (const auto& i : range.strayExcludes) {
+    exclude.excludeOne(i.first);
+  }
+
+  Interest interest(m_prefix);
+  interest.setInterestLifetime(interestLifetime);
+  interest.setMustBeFresh(mustBeFresh);
+  interest.setMinSuffixComponents(3);
+  interest.setMaxSuffixComponents(3);
+  interest.setChildSelector(1);
+  interest.setExclude(exclude);
+
+  range.fetcher = DataFetcher::fetch(m_face, interest,
+                                     maxRetriesOnTimeoutOrNack, maxRetriesOnTimeoutOrNack,
+                                     bind(&DiscoverVersionParallel::handleRangeData, this,
+                                          rangeNo, _1, _2),
+                                     bind(&DiscoverVersionParallel::handleRangeFailure, this,
+                                          rangeNo, _1, _2),
+                                     bind(&DiscoverVersionParallel::handleRangeFailure, this,
+                                          rangeNo, _1, _2),
+                                     nullptr,
+                                     nullptr,
+                                     isVerbose,
+                                     nullptr);
+  tracepoint(chunksLog, interest_discovery, rangeNo, interest.getInterestLifetime().count());
+}
+
+void
+DiscoverVersionParallel::handleRangeData(size_t rangeNo, const Interest& interest,
+                                         const Data& data)
+{
+  size_t versionIndex = m_prefix.size();
+  const Name& name = data.getName();
+
+  if (isVerbose)
+    std::cerr << "Data: " << data << std::endl;
+
+  BOOST_ASSERT(name.size() > m_prefix.size());
+  if (!name[versionIndex].isVersion()) {
+    // didn't find a version number at expected index.
+    m_ranges[rangeNo].strayExcludes.excludeOne(name[versionIndex]);
+    expressRangeInterest(rangeNo);
+    return;
+  }
+
+  uint64_t version = name[versionIndex].toVersion();
+  if (isVerbose)
+    std::cerr << "Discovered version = " << version << " in range " << rangeNo << std::endl;
+
+  bool isLatest = m_latestVersionData == nullptr || version > m_latestVersion;
+  if (isLatest) {
+    m_latestVersion = version;
+    m_latestVersionData = make_shared<Data>(data);
+  }
+
+  closeRange(rangeNo);
+  // the ranges entirely below the latest version cannot answer with a larger one
+  for (size_t i = 0; i < m_ranges.size(); ++i) {
+    if (m_ranges[i].last < m_latestVersion)
+      closeRange(i);
+  }
+
+  if (isLatest && m_nPendingRanges > 0)
+    this->emitSignal(onVersionCandidate, *m_latestVersionData);
+
+  checkFinished();
+}
+
+void
+DiscoverVersionParallel::handleRangeFailure(size_t rangeNo, const Interest& interest,
+                                            const std::string& reason)
+{
+  if (isVerbose)
+    std::cerr << "Range " << rangeNo << " failed: " << reason << std::endl;
+
+  m_lastFailureReason = reason;
+  closeRange(rangeNo);
+  checkFinished();
+}
+
+void
+DiscoverVersionParallel::closeRange(size_t rangeNo)
+{
+  Range& range = m_ranges[rangeNo];
+  if (!range.isPending)
+    return;
+
+  range.isPending = false;
+  if (range.fetcher != nullptr)
+    range.fetcher->cancel();
+  --m_nPendingRanges;
+}
+
+void
+DiscoverVersionParallel::checkFinished()
+{
+  if (m_nPendingRanges == 0)
+    finish();
+}
+
+void
+DiscoverVersionParallel::finish()
+{
+  if (m_isFinished)
+    return;
+
+  m_isFinished = true;
+
+  if (m_latestVersionData != nullptr) {
+    if (isVerbose)
+      std::cerr << "Found data with the latest version: " << m_latestVersion << std::endl;
+
+    this->emitSignal(onDiscoverySuccess, *m_latestVersionData);
+  }
+  else {
+    this->emitSignal(onDiscoveryFailure, m_lastFailureReason);
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
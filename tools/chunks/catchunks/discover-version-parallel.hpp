@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_PARALLEL_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_PARALLEL_HPP
+
+#include "discover-version.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Options for discover version parallel DiscoverVersionParallel
+ *
+ * The canonical name to use is DiscoverVersionParallel::Options
+ */
+class DiscoverVersionParallelOptions : public virtual Options
+{
+public:
+  explicit
+  DiscoverVersionParallelOptions(const Options& opt = Options())
+    : Options(opt)
+    , nRanges(4)
+    , newestRangeAge(time::seconds(10))
+  {
+  }
+
+public:
+  size_t nRanges;                     ///< number of version ranges explored concurrently
+  time::milliseconds newestRangeAge;  ///< age of the oldest version in the newest range
+};
+
+/**
+ * @brief Service for discovering the latest Data version with concurrent Interests
+ *
+ * The version space is split in nRanges ranges by age, relative to the current time: the newest
+ * range contains the versions younger than newestRangeAge, every older range spans ten times
+ * the age of the previous one and the last range extends down to version 0. One Interest with
+ * ChildSelector set to prefer the rightmost child and an Exclude selector restricting it to its
+ * range is expressed for every range at the same time.
+ *
+ * As soon as a range answers, the older ranges are abandoned as they cannot hold a larger
+ * version. The discovery terminates when every remaining range has answered, has been Nacked or
+ * has failed, and the largest discovered version is declared the latest. The newer ranges are
+ * waited for even if an older range answered quickly, e.g. from a nearby cache, since their
+ * producer may be farther away; the onVersionCandidate signal reports the answers in the
+ * meantime.
+ *
+ * A name component after the prefix that is not a version is excluded from the next Interests
+ * of its range.
+ *
+ * DiscoverVersionParallel's user is notified once after identifying the latest retrievable
+ * version or on failure to find any version Data.
+ */
+class DiscoverVersionParallel : public DiscoverVersion, protected DiscoverVersionParallelOptions
+{
+public:
+  typedef DiscoverVersionParallelOptions Options;
+
+public:
+  /**
+   * @brief create a DiscoverVersionParallel service
+   *
+   * @throw std::invalid_argument nRanges is zero
+   */
+  DiscoverVersionParallel(const Name& prefix, Face& face, const Options& options);
+
+  ~DiscoverVersionParallel();
+
+  /**
+   * @brief identify the latest Data version published.
+   */
+  void
+  run() NDN_CXX_DECL_FINAL;
+
+private:
+  struct Range
+  {
+    uint64_t first;                 ///< smallest version in the range
+    uint64_t last;                  ///< largest version in the range
+    Exclude strayExcludes;          ///< non-version components received in the range
+    shared_ptr<DataFetcher> fetcher;
+    bool isPending;
+  };
+
+  void
+  expressRangeInterest(size_t rangeNo);
+
+  void
+  handleRangeData(size_t rangeNo, const Interest& interest, const Data& data);
+
+  void
+  handleRangeFailure(size_t rangeNo, const Interest& interest, const std::string& reason);
+
+  /**
+   * @brief stop fetching a range
+   */
+  void
+  closeRange(size_t rangeNo);
+
+  /**
+   * @brief terminate the discovery if no range is pending anymore
+   */
+  void
+  checkFinished();
+
+  /**
+   * @brief notify the user of the largest discovered version
+   */
+  void
+  finish();
+
+private:
+  std::vector<Range> m_ranges;
+  size_t m_nPendingRanges;
+  uint64_t m_latestVersion;
+  shared_ptr<const Data> m_latestVersionData;
+  std::string m_lastFailureReason;
+  bool m_isFinished;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_PARALLEL_HPP
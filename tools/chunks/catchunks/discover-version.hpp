@@ -55,8 +55,18 @@ public: // signals
    */
   signal::Signal<DiscoverVersion, const std::string&> onDiscoveryFailure;
 
+  /**
+   * @brief Signal emitted when a segment of a version is found before the version is known to
+   *        be the latest one.
+   *
+   * Emitted again whenever a larger version is found. The segments of the candidate version can
+   * be fetched speculatively while the discovery goes on.
+   */
+  signal::Signal<DiscoverVersion, const Data&> onVersionCandidate;
+
   DECLARE_SIGNAL_EMIT(onDiscoverySuccess)
   DECLARE_SIGNAL_EMIT(onDiscoveryFailure)
+  DECLARE_SIGNAL_EMIT(onVersionCandidate)
 
 public:
   /**
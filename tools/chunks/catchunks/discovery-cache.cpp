@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "discovery-cache.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+static const char MAGIC[8] = {'N', 'D', 'N', 'C', 'D', 'I', 'S', 'C'};
+static const uint32_t VERSION = 1;
+
+/**
+ * @brief maximum number of slots examined for a prefix, starting from its hash
+ */
+static const size_t MAX_PROBES = 8;
+
+const uint64_t DiscoveryCache::NO_LAST_SEGMENT = std::numeric_limits<uint64_t>::max();
+const size_t DiscoveryCache::MAX_PREFIX_SIZE;
+const size_t DiscoveryCache::DEFAULT_CAPACITY = 4096;
+
+namespace {
+
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t slotSize;
+  uint64_t capacity;
+  uint64_t reserved[5];
+};
+
+static_assert(sizeof(Header) == 64, "Header must not be padded");
+
+} // namespace
+
+struct DiscoveryCache::Slot
+{
+  uint64_t hash;       ///< hash of the prefix, 0 if the slot has never been used
+  uint64_t updateTime; ///< milliseconds since the epoch, 0 if the entry has been erased
+  Entry entry;
+  uint16_t prefixSize;
+  uint8_t reserved[6];
+  uint8_t prefix[MAX_PREFIX_SIZE]; ///< wire encoding of the prefix
+};
+
+static_assert(sizeof(DiscoveryCache::Entry) == 32, "Entry must have a fixed layout");
+
+static uint64_t
+computeHash(const Block& wire)
+{
+  // FNV-1a, which unlike std::hash is the same in every process
+  uint64_t hash = 14695981039346656037ULL;
+  for (const uint8_t* byte = wire.wire(); byte != wire.wire() + wire.size(); ++byte) {
+    hash ^= *byte;
+    hash *= 1099511628211ULL;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+static uint64_t
+getNow()
+{
+  return time::toUnixTimestamp(time::system_clock::now()).count();
+}
+
+DiscoveryCache::FileLock::FileLock(int fd, bool isExclusive)
+  : m_fd(fd)
+{
+  // without the lock, which is only advisory, an entry could be read while it is written
+  while (::flock(m_fd, isExclusive ? LOCK_EX : LOCK_SH) < 0 && errno == EINTR)
+    ;
+}
+
+DiscoveryCache::FileLock::~FileLock()
+{
+  ::flock(m_fd, LOCK_UN);
+}
+
+DiscoveryCache::DiscoveryCache(const std::string& path, time::milliseconds ttl, size_t capacity)
+  : m_fd(::open(path.c_str(), O_RDWR | O_CREAT, 0644))
+  , m_map(nullptr)
+  , m_mapSize(0)
+  , m_slots(nullptr)
+  , m_capacity(0)
+  , m_ttl(ttl)
+{
+  if (m_fd < 0)
+    throw Error("Cannot open " + path + ": " + std::strerror(errno));
+
+  try {
+    // another process may be creating the file
+    FileLock lock(m_fd, true);
+
+    struct stat st;
+    if (::fstat(m_fd, &st) < 0)
+      throw Error("Cannot stat " + path + ": " + std::strerror(errno));
+
+    Header header;
+    if (st.st_size == 0) {
+      if (capacity == 0)
+        throw Error("The capacity of " + path + " must be positive");
+
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+      header.version = VERSION;
+      header.slotSize = sizeof(Slot);
+      header.capacity = capacity;
+
+      // the slots are zero-filled, i.e. free
+      if (::ftruncate(m_fd, sizeof(Header) + capacity * sizeof(Slot)) < 0 ||
+          ::pwrite(m_fd, &header, sizeof(header), 0) != sizeof(header))
+        throw Error("Cannot initialize " + path + ": " + std::strerror(errno));
+    }
+    else {
+      if (static_cast<size_t>(st.st_size) < sizeof(Header) ||
+          ::pread(m_fd, &header, sizeof(header), 0) != sizeof(header) ||
+          std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw Error(path + " is not a discovery cache");
+
+      if (header.version != VERSION || header.slotSize != sizeof(Slot) || header.capacity == 0 ||
+          static_cast<uint64_t>(st.st_size) < sizeof(Header) + header.capacity * sizeof(Slot))
+        throw Error(path + " has an unsupported format");
+    }
+
+    m_capacity = header.capacity;
+    m_mapSize = sizeof(Header) + m_capacity * sizeof(Slot);
+
+    void* map = ::mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED)
+      throw Error("Cannot map " + path + ": " + std::strerror(errno));
+    m_map = static_cast<uint8_t*>(map);
+    m_slots = reinterpret_cast<Slot*>(m_map + sizeof(Header));
+  }
+  catch (const Error&) {
+    ::close(m_fd);
+    throw;
+  }
+}
+
+DiscoveryCache::~DiscoveryCache()
+{
+  ::munmap(m_map, m_mapSize);
+  ::close(m_fd);
+}
+
+bool
+DiscoveryCache::find(const Name& prefix, Entry& entry) const
+{
+  const Block& wire = prefix.wireEncode();
+  if (wire.size() > MAX_PREFIX_SIZE)
+    return false;
+
+  FileLock lock(m_fd, false);
+  const Slot* slot = findSlot(wire, computeHash(wire));
+  if (slot == nullptr || slot->updateTime == 0)
+    return false;
+
+  // an entry stored in the future, e.g. before the clock has been adjusted, is still valid
+  uint64_t now = getNow();
+  if (now > slot->updateTime && now - slot->updateTime >= static_cast<uint64_t>(m_ttl.count()))
+    return false;
+
+  entry = slot->entry;
+  return true;
+}
+
+void
+DiscoveryCache::insert(const Name& prefix, const Entry& entry)
+{
+  const Block& wire = prefix.wireEncode();
+  if (wire.size() > MAX_PREFIX_SIZE)
+    return;
+
+  uint64_t hash = computeHash(wire);
+  FileLock lock(m_fd, true);
+
+  Slot* slot = findSlot(wire, hash);
+  if (slot == nullptr) {
+    // a free slot, or else the least recently updated one
+    for (size_t i = 0; i < std::min(MAX_PROBES, m_capacity); ++i) {
+      Slot& candidate = m_slots[(hash + i) % m_capacity];
+      if (candidate.hash == 0) {
+        slot = &candidate;
+        break;
+      }
+      if (slot == nullptr || candidate.updateTime < slot->updateTime)
+        slot = &candidate;
+    }
+  }
+
+  slot->hash = hash;
+  slot->updateTime = getNow();
+  slot->entry = entry;
+  slot->prefixSize = wire.size();
+  std::memcpy(slot->prefix, wire.wire(), wire.size());
+}
+
+void
+DiscoveryCache::erase(const Name& prefix)
+{
+  const Block& wire = prefix.wireEncode();
+  if (wire.size() > MAX_PREFIX_SIZE)
+    return;
+
+  FileLock lock(m_fd, true);
+  // the slot is not freed, the prefixes stored after it would not be found anymore
+  Slot* slot = findSlot(wire, computeHash(wire));
+  if (slot != nullptr)
+    slot->updateTime = 0;
+}
+
+DiscoveryCache::Slot*
+DiscoveryCache::findSlot(const Block& prefix, uint64_t hash) const
+{
+  for (size_t i = 0; i < std::min(MAX_PROBES, m_capacity); ++i) {
+    Slot& slot = m_slots[(hash + i) % m_capacity];
+    if (slot.hash == 0)
+      return nullptr;
+
+    if (slot.hash == hash && slot.prefixSize == prefix.size() &&
+        std::memcmp(slot.prefix, prefix.wire(), prefix.size()) == 0)
+      return &slot;
+  }
+  return nullptr;
+}
+
+} // namespace chunks
+} // namespace ndn
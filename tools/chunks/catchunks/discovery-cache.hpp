@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVERY_CACHE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVERY_CACHE_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Persistent cache of the results of the version discovery, shared by the processes that
+ *        open the same file
+ *
+ * Maps a prefix to the latest version discovered under it, with the last segment number and the
+ * RTT and window observed while the content was fetched, so that a later retrieval of the same
+ * prefix can skip the discovery and start with a warm RTT estimator and window. An entry is used
+ * until it is older than the TTL, even if a newer version has been published meanwhile.
+ *
+ * The entries are stored in an open addressing hash table in a memory mapped file of fixed size.
+ * When all the slots that a prefix can use are taken, the least recently updated one is replaced.
+ * The accesses are serialized among processes with an advisory lock on the file. The prefixes
+ * whose encoding is longer than MAX_PREFIX_SIZE are not cached.
+ */
+class DiscoveryCache : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Entry
+  {
+    uint64_t version;
+    uint64_t lastSegmentNo; ///< NO_LAST_SEGMENT if unknown
+    float rttMean;          ///< smoothed RTT in milliseconds, -1 if unknown
+    float rttVar;           ///< RTT variation in milliseconds, -1 if unknown
+    uint32_t windowSize;    ///< Interest window at the end of the retrieval, 0 if unknown
+  };
+
+  static const uint64_t NO_LAST_SEGMENT;
+  static const size_t MAX_PREFIX_SIZE = 200;
+  static const size_t DEFAULT_CAPACITY;
+
+  /**
+   * @brief open the cache file at @p path, creating it if it does not exist
+   *
+   * @param ttl how long an entry is used after it has been stored
+   * @param capacity the number of entries of a new file, ignored if the file exists
+   * @throw Error the file cannot be created or mapped, or is not a discovery cache
+   */
+  DiscoveryCache(const std::string& path, time::milliseconds ttl,
+                 size_t capacity = DEFAULT_CAPACITY);
+
+  ~DiscoveryCache();
+
+  /**
+   * @brief look up the entry of @p prefix
+   *
+   * @return false if @p prefix has no entry or its entry has expired
+   */
+  bool
+  find(const Name& prefix, Entry& entry) const;
+
+  /**
+   * @brief store @p entry for @p prefix, replacing the previous entry of @p prefix if any
+   */
+  void
+  insert(const Name& prefix, const Entry& entry);
+
+  /**
+   * @brief expire the entry of @p prefix, e.g. because its version cannot be retrieved anymore
+   */
+  void
+  erase(const Name& prefix);
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+private:
+  struct Slot;
+
+  /**
+   * @return the slot holding @p prefix, or nullptr
+   */
+  Slot*
+  findSlot(const Block& prefix, uint64_t hash) const;
+
+  /**
+   * @brief exclusive (or shared) advisory lock on the cache file for the lifetime of the object
+   */
+  class FileLock : noncopyable
+  {
+  public:
+    FileLock(int fd, bool isExclusive);
+
+    ~FileLock();
+
+  private:
+    int m_fd;
+  };
+
+private:
+  int m_fd;
+  uint8_t* m_map;
+  size_t m_mapSize;
+  Slot* m_slots;
+  size_t m_capacity;
+  time::milliseconds m_ttl;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVERY_CACHE_HPP
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "interest-pacer.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+InterestPacer::InterestPacer(Scheduler& scheduler, size_t burstSize)
+  : m_scheduler(scheduler)
+  , m_releaseEvent(scheduler)
+  , m_isReleaseScheduled(false)
+  , m_rate(0)
+  , m_burstSize(burstSize)
+  , m_nTokens(burstSize)
+  , m_lastRefill(time::steady_clock::now())
+{
+  BOOST_ASSERT(burstSize > 0);
+}
+
+void
+InterestPacer::setRate(double rate)
+{
+  refill();
+  m_rate = rate;
+
+  if (m_rate <= 0) {
+    m_releaseEvent.cancel();
+    m_isReleaseScheduled = false;
+    release();
+  }
+  else if (m_isReleaseScheduled) {
+    // the next token is available at a different time
+    m_releaseEvent.cancel();
+    m_isReleaseScheduled = false;
+    scheduleRelease();
+  }
+}
+
+void
+InterestPacer::schedule(const SendCallback& send)
+{
+  if (m_rate <= 0) {
+    send();
+    return;
+  }
+
+  refill();
+  if (m_queue.empty() && m_nTokens >= 1) {
+    m_nTokens -= 1;
+    send();
+    return;
+  }
+
+  m_queue.push(send);
+  scheduleRelease();
+}
+
+void
+InterestPacer::cancel()
+{
+  m_releaseEvent.cancel();
+  m_isReleaseScheduled = false;
+  m_queue = std::queue<SendCallback>();
+}
+
+void
+InterestPacer::refill()
+{
+  auto now = time::steady_clock::now();
+  if (m_rate > 0) {
+    double elapsedMs = time::duration_cast<time::microseconds>(now - m_lastRefill).count() / 1000.0;
+    m_nTokens = std::min(m_burstSize, m_nTokens + elapsedMs * m_rate);
+  }
+  m_lastRefill = now;
+}
+
+void
+InterestPacer::release()
+{
+  m_isReleaseScheduled = false;
+  refill();
+
+  while (!m_queue.empty() && (m_rate <= 0 || m_nTokens >= 1)) {
+    // the callback can schedule other Interests, remove it from the queue first
+    SendCallback send = std::move(m_queue.front());
+    m_queue.pop();
+    if (m_rate > 0)
+      m_nTokens -= 1;
+    send();
+  }
+
+  if (!m_queue.empty())
+    scheduleRelease();
+}
+
+void
+InterestPacer::scheduleRelease()
+{
+  if (m_isReleaseScheduled)
+    return;
+
+  double waitMs = (1 - m_nTokens) / m_rate;
+  auto wait = time::microseconds(static_cast<int64_t>(std::ceil(std::max(waitMs, 0.0) * 1000)));
+
+  m_isReleaseScheduled = true;
+  m_releaseEvent = m_scheduler.scheduleEvent(wait, bind(&InterestPacer::release, this));
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_PACER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_PACER_HPP
+
+#include "core/common.hpp"
+
+#include <queue>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Token bucket that spaces the Interests expressed by the pipeline
+ *
+ * The bucket is refilled at the pacing rate and holds at most burstSize tokens. An Interest is
+ * sent immediately if a token is available, otherwise it is queued and sent by a scheduler event
+ * when the next token becomes available. With a rate of 0, the Interests are not paced.
+ */
+class InterestPacer : noncopyable
+{
+public:
+  typedef function<void()> SendCallback;
+
+  explicit
+  InterestPacer(Scheduler& scheduler, size_t burstSize = 2);
+
+  /**
+   * @brief set the pacing rate, in Interests per millisecond
+   *
+   * A rate of 0 disables the pacing and sends all the queued Interests.
+   */
+  void
+  setRate(double rate);
+
+  double
+  getRate() const
+  {
+    return m_rate;
+  }
+
+  /**
+   * @brief call @p send when the pacing rate allows it, possibly immediately
+   */
+  void
+  schedule(const SendCallback& send);
+
+  /**
+   * @brief drop the queued Interests without sending them
+   */
+  void
+  cancel();
+
+  size_t
+  getNQueued() const
+  {
+    return m_queue.size();
+  }
+
+private:
+  void
+  refill();
+
+  /**
+   * @brief send the queued Interests for which a token is available
+   */
+  void
+  release();
+
+  void
+  scheduleRelease();
+
+private:
+  Scheduler& m_scheduler;
+  scheduler::ScopedEventId m_releaseEvent;
+  bool m_isReleaseScheduled;
+
+  double m_rate;
+  double m_burstSize;
+  double m_nTokens;
+  time::steady_clock::TimePoint m_lastRefill;
+
+  std::queue<SendCallback> m_queue;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_PACER_HPP
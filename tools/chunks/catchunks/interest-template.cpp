@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "interest-template.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+
+#include <cstring>
+
+namespace ndn {
+namespace chunks {
+
+static size_t
+getIndex(size_t segmentNoLength)
+{
+  switch (segmentNoLength) {
+  case 1:
+    return 0;
+  case 2:
+    return 1;
+  case 4:
+    return 2;
+  default:
+    return 3;
+  }
+}
+
+static size_t
+getSegmentNoLength(uint64_t segmentNo)
+{
+  // the NonNegativeInteger encoding of the segment number
+  if (segmentNo <= std::numeric_limits<uint8_t>::max())
+    return 1;
+  if (segmentNo <= std::numeric_limits<uint16_t>::max())
+    return 2;
+  if (segmentNo <= std::numeric_limits<uint32_t>::max())
+    return 4;
+  return 8;
+}
+
+static void
+writeBigEndian(uint8_t* buffer, uint64_t value, size_t length)
+{
+  for (size_t i = length; i > 0; --i) {
+    buffer[i - 1] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+}
+
+InterestTemplate::InterestTemplate(const Name& prefix, bool mustBeFresh, int maxSuffixComponents)
+  : m_prefix(prefix)
+  , m_mustBeFresh(mustBeFresh)
+  , m_maxSuffixComponents(maxSuffixComponents)
+{
+}
+
+Interest
+InterestTemplate::makeInterest(uint64_t segmentNo, const time::milliseconds& lifetime)
+{
+  return makeInterest(segmentNo, lifetime, random::generateWord32());
+}
+
+Interest
+InterestTemplate::makeInterest(uint64_t segmentNo, const time::milliseconds& lifetime,
+                               uint32_t nonce)
+{
+  size_t segmentNoLength = getSegmentNoLength(segmentNo);
+  const Wire& wire = getWire(segmentNoLength);
+
+  auto buffer = make_shared<Buffer>(wire.bytes.begin(), wire.bytes.end());
+  uint8_t* bytes = buffer->buf();
+  writeBigEndian(bytes + wire.segmentOffset, segmentNo, segmentNoLength);
+  // the Nonce is encoded in host order by Interest::setNonce
+  std::memcpy(bytes + wire.nonceOffset, &nonce, sizeof(nonce));
+  writeBigEndian(bytes + wire.lifetimeOffset,
+                 std::min<uint64_t>(lifetime.count(), std::numeric_limits<uint32_t>::max()), 4);
+
+  return Interest(Block(buffer));
+}
+
+const InterestTemplate::Wire&
+InterestTemplate::getWire(size_t segmentNoLength)
+{
+  Wire& wire = m_wires[getIndex(segmentNoLength)];
+  if (!wire.bytes.empty())
+    return wire;
+
+  // the smallest segment number encoded on segmentNoLength bytes
+  uint64_t segmentNo = segmentNoLength == 1 ? 0 : uint64_t(1) << (segmentNoLength * 4);
+
+  Interest interest(Name(m_prefix).appendSegment(segmentNo));
+  interest.setMustBeFresh(m_mustBeFresh);
+  interest.setMaxSuffixComponents(m_maxSuffixComponents);
+  interest.setNonce(0);
+  // a lifetime that needs 4 bytes
+  interest.setInterestLifetime(time::milliseconds(std::numeric_limits<uint16_t>::max() + 1));
+
+  const Block& block = interest.wireEncode();
+  block.parse();
+  wire.bytes.assign(block.begin(), block.end());
+
+  for (const Block& element : block.elements()) {
+    size_t valueOffset = element.value_begin() - block.begin();
+    switch (element.type()) {
+    case tlv::Name:
+      // the segment number ends the value of the last name component
+      wire.segmentOffset = valueOffset + element.value_size() - segmentNoLength;
+      break;
+    case tlv::Nonce:
+      wire.nonceOffset = valueOffset;
+      break;
+    case tlv::InterestLifetime:
+      BOOST_ASSERT(element.value_size() == 4);
+      wire.lifetimeOffset = valueOffset;
+      break;
+    default:
+      break;
+    }
+  }
+
+  BOOST_ASSERT(wire.segmentOffset > 0 && wire.nonceOffset > 0 && wire.lifetimeOffset > 0);
+  return wire;
+}
+
+} // namespace chunks
+} // namespace ndn
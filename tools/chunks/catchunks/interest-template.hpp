@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Pre-encoded Interest for the segments of a versioned name
+ *
+ * The wire encoding of the Interest is built once for each length of the segment number (1, 2,
+ * 4 or 8 bytes). An Interest is made by copying the encoding and patching the segment number,
+ * the Nonce and the InterestLifetime in place, so the prefix is never encoded again. The
+ * Interest is decoded from this wire, which the Face sends as is.
+ *
+ * The InterestLifetime is always encoded on 4 bytes, so that it can be patched.
+ */
+class InterestTemplate
+{
+public:
+  /**
+   * @param prefix name of the segments, without the segment number
+   */
+  InterestTemplate(const Name& prefix, bool mustBeFresh, int maxSuffixComponents = 1);
+
+  const Name&
+  getPrefix() const
+  {
+    return m_prefix;
+  }
+
+  /**
+   * @brief make the Interest for segment @p segmentNo with a random Nonce
+   */
+  Interest
+  makeInterest(uint64_t segmentNo, const time::milliseconds& lifetime);
+
+  Interest
+  makeInterest(uint64_t segmentNo, const time::milliseconds& lifetime, uint32_t nonce);
+
+private:
+  struct Wire
+  {
+    std::vector<uint8_t> bytes;
+    size_t segmentOffset = 0;
+    size_t nonceOffset = 0;
+    size_t lifetimeOffset = 0;
+  };
+
+  /**
+   * @return the encoding for segment numbers of @p segmentNoLength bytes, built on first use
+   */
+  const Wire&
+  getWire(size_t segmentNoLength);
+
+private:
+  Name m_prefix;
+  bool m_mustBeFresh;
+  int m_maxSuffixComponents;
+  std::array<Wire, 4> m_wires; ///< indexed by log2 of the length of the segment number
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "manifest-validator.hpp"
+#include "data-fetcher.hpp"
+
+namespace ndn {
+namespace chunks {
+
+const size_t ManifestValidator::MAX_IN_FLIGHT = 32;
+
+ManifestValidator::Manifest::Manifest(const Name& prefix)
+  : prefix(prefix)
+  , isVerified(false)
+  , hasFailed(false)
+  , nSegments(0)
+  , nextSegmentNo(1)
+  , nReceivedSegments(0)
+{
+}
+
+ManifestValidator::Manifest::~Manifest()
+{
+  for (const auto& fetcher : fetchers)
+    fetcher.second->cancel();
+}
+
+ManifestValidator::ManifestValidator(Face& face, unique_ptr<Validator> manifestValidator,
+                                     const Options& options)
+  : m_face(face)
+  , m_manifestValidator(std::move(manifestValidator))
+  , m_options(options)
+{
+}
+
+ManifestValidator::~ManifestValidator() = default;
+
+void
+ManifestValidator::checkPolicy(const Interest& interest,
+                               int nSteps,
+                               const OnInterestValidated& onValidated,
+                               const OnInterestValidationFailed& onValidationFailed,
+                               std::vector<shared_ptr<ValidationRequest>>& nextSteps)
+{
+  onValidationFailed(interest.shared_from_this(), "Interest validation is not supported");
+}
+
+void
+ManifestValidator::checkPolicy(const Data& data,
+                               int nSteps,
+                               const OnDataValidated& onValidated,
+                               const OnDataValidationFailed& onValidationFailed,
+                               std::vector<shared_ptr<ValidationRequest>>& nextSteps)
+{
+  const Name& name = data.getName();
+  if (name.empty() || !name[-1].isSegment()) {
+    onValidationFailed(data.shared_from_this(), "Data is not a segment");
+    return;
+  }
+
+  Name versionedPrefix = name.getPrefix(-1);
+  auto& manifest = m_manifests[versionedPrefix];
+  if (manifest == nullptr) {
+    manifest = make_shared<Manifest>(MerkleManifest::getPrefix(versionedPrefix));
+    fetchSegment(manifest, 0);
+  }
+
+  Job job{data.shared_from_this(), onValidated, onValidationFailed};
+  if (manifest->hasFailed)
+    onValidationFailed(job.data, manifest->failureReason);
+  else if (manifest->isVerified)
+    validateJobs(*manifest, {job});
+  else
+    manifest->pendingJobs.push_back(job);
+}
+
+void
+ManifestValidator::fetchSegment(const shared_ptr<Manifest>& manifest, uint64_t segmentNo)
+{
+  Interest interest(Name(manifest->prefix).appendSegment(segmentNo));
+  interest.setInterestLifetime(m_options.interestLifetime);
+  interest.setMustBeFresh(m_options.mustBeFresh);
+
+  // the manifest is destroyed with the validator, the callbacks must then do nothing
+  weak_ptr<Manifest> weakManifest = manifest;
+  auto onFailure = [this, weakManifest] (const Interest& interest, const std::string& reason) {
+    auto manifest = weakManifest.lock();
+    if (manifest != nullptr)
+      failManifest(manifest, "Failed to fetch " + interest.getName().toUri() + ": " + reason);
+  };
+
+  manifest->fetchers[segmentNo] = DataFetcher::fetch(m_face, interest,
+    m_options.maxRetriesOnTimeoutOrNack, m_options.maxRetriesOnTimeoutOrNack,
+    [this, weakManifest] (const Interest&, const Data& data, const shared_ptr<DataFetcher>&) {
+      auto manifest = weakManifest.lock();
+      if (manifest != nullptr)
+        handleSegment(manifest, data);
+    },
+    onFailure, onFailure, nullptr, nullptr, m_options.isVerbose, nullptr);
+}
+
+void
+ManifestValidator::fetchLeafSegments(const shared_ptr<Manifest>& manifest)
+{
+  while (manifest->fetchers.size() < MAX_IN_FLIGHT &&
+         manifest->nextSegmentNo < manifest->nSegments) {
+    fetchSegment(manifest, manifest->nextSegmentNo++);
+  }
+}
+
+void
+ManifestValidator::handleSegment(const shared_ptr<Manifest>& manifest, const Data& data)
+{
+  if (manifest->hasFailed)
+    return;
+
+  uint64_t segmentNo = data.getName()[-1].toSegment();
+  manifest->fetchers.erase(segmentNo);
+
+  if (segmentNo == 0) {
+    weak_ptr<Manifest> weakManifest = manifest;
+    m_manifestValidator->validate(data,
+      [this, weakManifest] (const shared_ptr<const Data>& data) {
+        auto manifest = weakManifest.lock();
+        if (manifest != nullptr)
+          handleRootValidated(manifest, *data);
+      },
+      [this, weakManifest] (const shared_ptr<const Data>&, const std::string& reason) {
+        auto manifest = weakManifest.lock();
+        if (manifest != nullptr)
+          failManifest(manifest, "Failed to validate the manifest: " + reason);
+      });
+    return;
+  }
+
+  // the leaves are authenticated by the root, the segments containing them need no validation
+  manifest->leafSegments.at(segmentNo - 1) = data.getContent();
+  ++manifest->nReceivedSegments;
+
+  if (manifest->nReceivedSegments == manifest->nSegments - 1)
+    completeManifest(manifest);
+  else
+    fetchLeafSegments(manifest);
+}
+
+void
+ManifestValidator::handleRootValidated(const shared_ptr<Manifest>& manifest, const Data& data)
+{
+  if (manifest->hasFailed)
+    return;
+
+  const Block& content = data.getContent();
+  if (content.value_size() != manifest->root.size()) {
+    failManifest(manifest, "The manifest does not contain a Merkle root");
+    return;
+  }
+  std::copy(content.value_begin(), content.value_end(), manifest->root.begin());
+
+  if (data.getFinalBlockId().empty() || !data.getFinalBlockId().isSegment() ||
+      data.getFinalBlockId().toSegment() == 0) {
+    failManifest(manifest, "The manifest does not contain any digest");
+    return;
+  }
+
+  manifest->nSegments = data.getFinalBlockId().toSegment() + 1;
+  manifest->leafSegments.resize(manifest->nSegments - 1);
+  fetchLeafSegments(manifest);
+}
+
+void
+ManifestValidator::completeManifest(const shared_ptr<Manifest>& manifest)
+{
+  const size_t digestSize = manifest->root.size();
+  for (const auto& segment : manifest->leafSegments) {
+    if (segment.value_size() % digestSize != 0) {
+      failManifest(manifest, "The manifest contains a truncated digest");
+      return;
+    }
+    for (auto it = segment.value_begin(); it != segment.value_end(); it += digestSize) {
+      manifest->leaves.emplace_back();
+      std::copy(it, it + digestSize, manifest->leaves.back().begin());
+    }
+  }
+  manifest->leafSegments.clear();
+
+  if (manifest->leaves.empty() || MerkleManifest::computeRoot(manifest->leaves) != manifest->root) {
+    failManifest(manifest, "The digests do not match the Merkle root of the manifest");
+    return;
+  }
+
+  manifest->isVerified = true;
+  if (m_options.isVerbose)
+    std::cerr << "Verified the manifest " << manifest->prefix << " with "
+              << manifest->leaves.size() << " digests" << std::endl;
+
+  std::vector<Job> jobs;
+  jobs.swap(manifest->pendingJobs);
+  validateJobs(*manifest, jobs);
+}
+
+void
+ManifestValidator::failManifest(const shared_ptr<Manifest>& manifest, const std::string& reason)
+{
+  if (manifest->hasFailed)
+    return;
+
+  manifest->hasFailed = true;
+  manifest->failureReason = reason;
+  for (const auto& fetcher : manifest->fetchers)
+    fetcher.second->cancel();
+  manifest->fetchers.clear();
+
+  std::vector<Job> jobs;
+  jobs.swap(manifest->pendingJobs);
+  for (const auto& job : jobs)
+    job.onValidationFailed(job.data, reason);
+}
+
+void
+ManifestValidator::validateJobs(const Manifest& manifest, const std::vector<Job>& jobs)
+{
+  BOOST_ASSERT(manifest.isVerified);
+
+  // the signed portion is the value of the Data without the SignatureValue element
+  std::vector<std::pair<const uint8_t*, size_t>> signedPortions;
+  signedPortions.reserve(jobs.size());
+  for (const auto& job : jobs) {
+    const Block& wire = job.data->wireEncode();
+    signedPortions.emplace_back(wire.value(),
+                                wire.value_size() - job.data->getSignature().getValue().size());
+  }
+
+  auto digests = computeSha256Digests(signedPortions);
+
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    uint64_t segmentNo = jobs[i].data->getName()[-1].toSegment();
+    if (segmentNo >= manifest.leaves.size())
+      jobs[i].onValidationFailed(jobs[i].data, "The manifest has no digest for this segment");
+    else if (digests[i] != manifest.leaves[segmentNo])
+      jobs[i].onValidationFailed(jobs[i].data, "The digest does not match the manifest");
+    else
+      jobs[i].onValidated(jobs[i].data);
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_MANIFEST_VALIDATOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_MANIFEST_VALIDATOR_HPP
+
+#include "options.hpp"
+#include "../common/merkle-manifest.hpp"
+
+#include <ndn-cxx/security/validator.hpp>
+
+#include <map>
+
+namespace ndn {
+namespace chunks {
+
+class DataFetcher;
+
+/**
+ * @brief Validator that checks the segments of an object against its MerkleManifest
+ *
+ * When the first segment of an object /prefix/<version> is submitted, the manifest
+ * /prefix/<version>/_manifest is fetched. Only its segment 0, which contains the Merkle root,
+ * is validated by the validator given to the constructor, i.e. with an asymmetric signature
+ * verification. The root computed from the digests in the following manifest segments must
+ * match. Each segment of the object is then validated by comparing the digest of its signed
+ * portion with the digest at its position in the manifest.
+ *
+ * The segments submitted while the manifest is being fetched are validated together, with a
+ * multi-buffer SHA-256, when the manifest has been verified. If the manifest cannot be fetched or
+ * verified, all the segments of the object fail the validation.
+ */
+class ManifestValidator : public Validator
+{
+public:
+  /**
+   * @brief the maximum number of manifest segments requested at the same time
+   */
+  static const size_t MAX_IN_FLIGHT;
+
+  /**
+   * @param manifestValidator validates the manifest segment containing the Merkle root
+   * @param options the Interest lifetime and retries used to fetch the manifest
+   */
+  ManifestValidator(Face& face, unique_ptr<Validator> manifestValidator, const Options& options);
+
+  ~ManifestValidator();
+
+protected:
+  void
+  checkPolicy(const Interest& interest,
+              int nSteps,
+              const OnInterestValidated& onValidated,
+              const OnInterestValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE;
+
+  void
+  checkPolicy(const Data& data,
+              int nSteps,
+              const OnDataValidated& onValidated,
+              const OnDataValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE;
+
+private:
+  struct Job
+  {
+    shared_ptr<const Data> data;
+    OnDataValidated onValidated;
+    OnDataValidationFailed onValidationFailed;
+  };
+
+  /**
+   * @brief the manifest of an object, while it is fetched and after it has been verified
+   */
+  struct Manifest
+  {
+    explicit
+    Manifest(const Name& prefix);
+
+    /**
+     * @brief cancel the fetching of the manifest segments
+     */
+    ~Manifest();
+
+    Name prefix; ///< the prefix of the manifest segments
+    bool isVerified;
+    bool hasFailed;
+    std::string failureReason;
+
+    Sha256Digest root;
+    uint64_t nSegments; ///< including the segment with the root, 0 until it is received
+    uint64_t nextSegmentNo;
+    uint64_t nReceivedSegments;
+    std::vector<Block> leafSegments; ///< the content of the segments 1..nSegments-1
+
+    std::vector<Sha256Digest> leaves;
+    std::vector<Job> pendingJobs; ///< submitted before the manifest is verified
+    std::map<uint64_t, shared_ptr<DataFetcher>> fetchers;
+  };
+
+  void
+  fetchSegment(const shared_ptr<Manifest>& manifest, uint64_t segmentNo);
+
+  void
+  fetchLeafSegments(const shared_ptr<Manifest>& manifest);
+
+  void
+  handleSegment(const shared_ptr<Manifest>& manifest, const Data& data);
+
+  void
+  handleRootValidated(const shared_ptr<Manifest>& manifest, const Data& data);
+
+  /**
+   * @brief compute the Merkle root of the received leaves and validate the pending jobs
+   */
+  void
+  completeManifest(const shared_ptr<Manifest>& manifest);
+
+  void
+  failManifest(const shared_ptr<Manifest>& manifest, const std::string& reason);
+
+  /**
+   * @brief validate @p jobs with the leaves of @p manifest, which has been verified
+   */
+  static void
+  validateJobs(const Manifest& manifest, const std::vector<Job>& jobs);
+
+private:
+  Face& m_face;
+  unique_ptr<Validator> m_manifestValidator;
+  Options m_options;
+
+  std::map<Name, shared_ptr<Manifest>> m_manifests; ///< indexed by versioned prefix
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_MANIFEST_VALIDATOR_HPP
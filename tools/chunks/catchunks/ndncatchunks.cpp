@@ -27,13 +27,22 @@
 
 #include "core/version.hpp"
 #include "options.hpp"
+#include "batch-fetcher.hpp"
 #include "consumer.hpp"
 #include "discover-version-fixed.hpp"
 #include "discover-version-iterative.hpp"
+#include "discover-version-parallel.hpp"
+#include "discovery-cache.hpp"
+#include "manifest-validator.hpp"
+#include "parallel-validator.hpp"
+#include "telemetry-log.hpp"
 #include "../chunks-tracepoint.hpp"
 
+#include <ndn-cxx/security/validator-config.hpp>
 #include <ndn-cxx/security/validator-null.hpp>
 
+#include <unistd.h>
+
 namespace ndn {
 namespace chunks {
 
@@ -47,6 +56,16 @@ handleSIGINT(const boost::system::error_code& errorCode, Consumer& consumer) {
   tracepoint(chunksLog, cat_stopped, 4);
 }
 
+void
+handleBatchSIGINT(const boost::system::error_code& errorCode, Face& face) {
+  if (errorCode == boost::asio::error::operation_aborted) {
+    return;
+  }
+
+  face.getIoService().stop();
+  tracepoint(chunksLog, cat_stopped, 4);
+}
+
 static int
 main(int argc, char** argv)
 {
@@ -54,6 +73,10 @@ main(int argc, char** argv)
   PipelineInterests::Options options;
   std::string discoverType("fixed");
   int maxRetriesAfterVersionFound(1);
+  size_t nDiscoveryRanges(DiscoverVersionParallel::Options().nRanges);
+  size_t speculativeWindow = 0;
+  std::string discoveryCacheFile;
+  uint64_t discoveryCacheTtl = 60000;
   std::string uri;
 
 
@@ -61,13 +84,28 @@ main(int argc, char** argv)
   uint64_t randomWaitMax = 0;
   bool startWait = false;
   bool noDiscovery = false;
+  bool zeroCopy = false;
+  std::string resumeFile;
+  size_t writerRingSize = 0;
+  std::string telemetryFile;
+  size_t telemetryCapacity = TelemetryLog::DEFAULT_CAPACITY;
+  std::string decodeTelemetryFile;
+  std::string validatorConfig;
+  size_t nValidatorThreads = 0;
+  bool useManifest = false;
+  std::string batchFile;
+  std::string outputDir(".");
+  size_t batchConcurrency = 16;
+  std::vector<std::string> mirrors;
+  bool useMirrorFaces = false;
 
   namespace po = boost::program_options;
   po::options_description visibleDesc("Options");
   visibleDesc.add_options()
     ("help,h",      "print this help message and exit")
     ("discover-version,d",  po::value<std::string>(&discoverType)->default_value(discoverType),
-                            "version discovery algorithm to use; valid values are: 'fixed', 'iterative'")
+                            "version discovery algorithm to use; valid values are: 'fixed', 'iterative', "
+                            "'parallel'")
     ("fresh,f",     po::bool_switch(&options.mustBeFresh), "only return fresh content")
     ("lifetime,l",  po::value<uint64_t>()->default_value(options.interestLifetime.count()),
                     "lifetime of expressed Interests, in milliseconds")
@@ -77,6 +115,10 @@ main(int argc, char** argv)
                     "maximum size of the Interest pipeline (0 = same as start pipeline size)")
     ("timeoutBeforeReset,R",  po::value<size_t>(&options.nTimeoutBeforeReset)->default_value(options.nTimeoutBeforeReset),
                     "number of consecutive timeouts to reset the rtt estimator")
+    ("rttWindow",   po::value<size_t>(&options.rttWindowSize)->default_value(options.rttWindowSize),
+                    "number of RTT samples over which the minimum RTT is computed")
+    ("karn",        po::bool_switch(&options.useKarnAlgorithm),
+                    "do not measure the RTT of the retransmitted segments (Karn's algorithm)")
     ("rtoMultiplierReset,M",  po::bool_switch(&options.rtoMultiplierReset),
                     "turn on reset RTO multiplier on Data received (Now is half not a full reset)")
     ("retries,r",   po::value<int>(&options.maxRetriesOnTimeoutOrNack)->default_value(options.maxRetriesOnTimeoutOrNack),
@@ -84,6 +126,17 @@ main(int argc, char** argv)
     ("retries-iterative,i", po::value<int>(&maxRetriesAfterVersionFound)->default_value(maxRetriesAfterVersionFound),
                             "number of timeouts that have to occur in order to confirm a discovered Data "
                             "version as the latest one (only applicable to 'iterative' version discovery)")
+    ("discoveryRanges",     po::value<size_t>(&nDiscoveryRanges)->default_value(nDiscoveryRanges),
+                            "number of version ranges explored concurrently (only applicable to "
+                            "'parallel' version discovery)")
+    ("speculativeWindow",   po::value<size_t>(&speculativeWindow)->default_value(speculativeWindow),
+                            "fetch this many segments of a discovered version before it is "
+                            "confirmed as the latest one (0 = wait for the end of the discovery)")
+    ("discoveryCache",      po::value<std::string>(&discoveryCacheFile),
+                            "remember the discovered versions in this file, shared with the other "
+                            "runs, and skip the discovery of the names found in it")
+    ("discoveryCacheTtl",   po::value<uint64_t>(&discoveryCacheTtl)->default_value(discoveryCacheTtl),
+                            "how long a version is taken from the discovery cache, in milliseconds")
     ("verbose,v",   po::bool_switch(&options.isVerbose), "turn on verbose output")
     ("version,V",   "print program version and exit")
     ("printStat,S", po::bool_switch(&printStat), "turn on statistics output")
@@ -95,6 +148,59 @@ main(int argc, char** argv)
                                     "window cut multiplier")
     ("slowStartThreshold,t",  po::value<size_t>(&options.slowStartThreshold)->default_value(options.slowStartThreshold),
                               "slow start threshold (0 = no threshold)")
+    ("segmentTable", po::bool_switch(&options.useSegmentTable),
+                     "track the segments in a flat state table instead of one fetcher per pipe")
+    ("zeroCopy",     po::bool_switch(&zeroCopy),
+                     "write the content to the standard output with writev/pwrite, without copying it")
+    ("writerRing",   po::value<size_t>(&writerRingSize)->default_value(writerRingSize),
+                     "write the output from a dedicated thread, through a ring of this many "
+                     "segments (0 = write from the event loop)")
+    ("resume",       po::value<std::string>(&resumeFile),
+                     "write the content to this file instead of the standard output, and record the "
+                     "received segments in FILE.bitmap so that an interrupted transfer can be resumed")
+    ("congestionControl", po::value<std::string>(&options.congestionControl)
+                            ->default_value(options.congestionControl),
+                          "congestion control of the Interest window: 'aimd', 'cubic' or 'bbr'")
+    ("pacing",       po::bool_switch(&options.usePacing),
+                     "space the Interests at the estimated bottleneck rate instead of sending them in "
+                     "window-sized bursts")
+    ("lossDetection", po::bool_switch(&options.useLossDetection),
+                      "detect the lost segments with a retransmission timer and the gaps in the "
+                      "received segments, before the Interest lifetime expires (requires --segmentTable)")
+    ("reorderThreshold", po::value<size_t>(&options.reorderThreshold)
+                           ->default_value(options.reorderThreshold),
+                         "number of later segments received before a segment is considered lost "
+                         "(0 = no gap detection)")
+    ("validatorConfig", po::value<std::string>(&validatorConfig),
+                        "validate the retrieved Data with the validator configuration in this file "
+                        "(default: no validation)")
+    ("validatorThreads", po::value<size_t>(&nValidatorThreads)->default_value(nValidatorThreads),
+                         "number of threads that validate the Data, the certificates must then be "
+                         "trust anchors in the configuration file (0 = validate on the face thread)")
+    ("manifest",    po::bool_switch(&useManifest),
+                    "fetch the Merkle manifest of the retrieved Data, validate only the manifest with "
+                    "the validator, and check each segment against its digest in the manifest "
+                    "(requires --validatorConfig)")
+    ("mirror",      po::value<std::vector<std::string>>(&mirrors)->composing(),
+                    "fetch the segments also from this prefix, followed by the version of the "
+                    "content; the segments are shared among the paths according to their speed "
+                    "(can be repeated)")
+    ("mirrorFaces", po::bool_switch(&useMirrorFaces),
+                    "open a separate Face to the forwarder for each mirror")
+    ("telemetry",   po::value<std::string>(&telemetryFile),
+                    "record the Interests, Data, timeouts, Nacks and window changes in a binary "
+                    "ring in this file")
+    ("telemetryRecords", po::value<size_t>(&telemetryCapacity)->default_value(telemetryCapacity),
+                    "number of records in the telemetry ring, the oldest ones are overwritten")
+    ("decodeTelemetry", po::value<std::string>(&decodeTelemetryFile),
+                    "print the records of this telemetry file as CSV and exit")
+    ("batch",       po::value<std::string>(&batchFile),
+                    "fetch the names listed in this file ('-' for the standard input) over one face, "
+                    "one name per line optionally followed by the output file")
+    ("outputDir",   po::value<std::string>(&outputDir)->default_value(outputDir),
+                    "directory of the output files in batch mode")
+    ("batchConcurrency", po::value<size_t>(&batchConcurrency)->default_value(batchConcurrency),
+                         "maximum number of objects fetched at the same time in batch mode")
     ;
 
   po::options_description hiddenDesc("Hidden options");
@@ -123,6 +229,7 @@ main(int argc, char** argv)
 
   if (vm.count("help") > 0) {
     std::cout << "Usage: " << programName << " [options] ndn:/name" << std::endl;
+    std::cout << "       " << programName << " [options] --batch FILE" << std::endl;
     std::cout << visibleDesc;
     return 0;
   }
@@ -132,19 +239,61 @@ main(int argc, char** argv)
     return 0;
   }
 
-  if (vm.count("ndn-name") == 0) {
+  if (!decodeTelemetryFile.empty()) {
+    try {
+      TelemetryLog::decode(decodeTelemetryFile, std::cout);
+    }
+    catch (const TelemetryLog::Error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (vm.count("ndn-name") == 0 && batchFile.empty()) {
     std::cerr << "Usage: " << programName << " [options] ndn:/name" << std::endl;
+    std::cerr << "       " << programName << " [options] --batch FILE" << std::endl;
     std::cerr << visibleDesc;
     return 2;
   }
 
-  Name prefix(uri);
-  if (discoverType == "fixed" && (prefix.empty() || !prefix[-1].isVersion())) {
-    std::cerr << "ERROR: The specified name must contain a version component when using "
-                 "fixed version discovery" << std::endl;
+  if (discoverType != "fixed" && discoverType != "iterative" && discoverType != "parallel") {
+    std::cerr << "ERROR: discover version type not valid" << std::endl;
     return 2;
   }
 
+  std::vector<BatchFetcher::Object> objects;
+  if (!batchFile.empty()) {
+    try {
+      if (batchFile == "-") {
+        objects = BatchFetcher::parseManifest(std::cin, outputDir);
+      }
+      else {
+        std::ifstream is(batchFile);
+        if (!is) {
+          std::cerr << "ERROR: cannot open " << batchFile << std::endl;
+          return 2;
+        }
+        objects = BatchFetcher::parseManifest(is, outputDir);
+      }
+    }
+    catch (const BatchFetcher::Error& e) {
+      std::cerr << "ERROR: " << batchFile << ": " << e.what() << std::endl;
+      return 2;
+    }
+  }
+  else {
+    objects.push_back({Name(uri), ""});
+  }
+
+  for (const auto& object : objects) {
+    if (discoverType == "fixed" && (object.name.empty() || !object.name[-1].isVersion())) {
+      std::cerr << "ERROR: The specified name must contain a version component when using "
+                   "fixed version discovery" << std::endl;
+      return 2;
+    }
+  }
+
   if (options.startPipelineSize < 1 || options.startPipelineSize > 65536) {
     std::cerr << "ERROR: start pipeline size must be between 1 and 65536" << std::endl;
     return 2;
@@ -168,39 +317,203 @@ main(int argc, char** argv)
     return 2;
   }
 
+  if (nDiscoveryRanges < 1 || nDiscoveryRanges > 16) {
+    std::cerr << "ERROR: discovery ranges must be between 1 and 16" << std::endl;
+    return 2;
+  }
+
   if (options.windowCutMultiplier < 0 || options.windowCutMultiplier > 1) {
     std::cerr << "ERROR: window cut multiplier value must be between 0 and 1" << std::endl;
     return 2;
   }
 
+  if (options.rttWindowSize < 1 || options.rttWindowSize > 65536) {
+    std::cerr << "ERROR: RTT window must be between 1 and 65536" << std::endl;
+    return 2;
+  }
+
+  if (options.congestionControl != "aimd" && options.congestionControl != "cubic" &&
+      options.congestionControl != "bbr") {
+    std::cerr << "ERROR: congestion control must be 'aimd', 'cubic' or 'bbr'" << std::endl;
+    return 2;
+  }
+
+  if (!resumeFile.empty() && (zeroCopy || !batchFile.empty())) {
+    std::cerr << "ERROR: resume is not supported with zero copy output or in batch mode" << std::endl;
+    return 2;
+  }
+
+  if (writerRingSize > 0 && (zeroCopy || !resumeFile.empty() || !batchFile.empty())) {
+    std::cerr << "ERROR: the writer ring is not supported with zero copy output, with resume or "
+                 "in batch mode" << std::endl;
+    return 2;
+  }
+
+  if (!batchFile.empty()) {
+    if (batchConcurrency < 1) {
+      std::cerr << "ERROR: batch concurrency must be at least 1" << std::endl;
+      return 2;
+    }
+    if (zeroCopy || options.usePacing) {
+      std::cerr << "ERROR: zero copy output and pacing are not supported in batch mode" << std::endl;
+      return 2;
+    }
+    // the objects share the window through their segment tables
+    options.useSegmentTable = true;
+  }
+
+  if (!mirrors.empty()) {
+    if (!batchFile.empty() || !resumeFile.empty() || noDiscovery) {
+      std::cerr << "ERROR: mirrors are not supported in batch mode, with resume or without "
+                   "discovery" << std::endl;
+      return 2;
+    }
+    // each path tracks its own segments
+    options.useSegmentTable = true;
+  }
+  else if (useMirrorFaces) {
+    std::cerr << "ERROR: mirror faces require at least one mirror" << std::endl;
+    return 2;
+  }
+
+  if (!discoveryCacheFile.empty() && !mirrors.empty()) {
+    std::cerr << "ERROR: the discovery cache is not supported with mirrors" << std::endl;
+    return 2;
+  }
+
+  if (speculativeWindow > 0) {
+    if (speculativeWindow > 65536) {
+      std::cerr << "ERROR: speculative window must be between 0 and 65536" << std::endl;
+      return 2;
+    }
+    if (!batchFile.empty() || !resumeFile.empty() || !mirrors.empty()) {
+      std::cerr << "ERROR: the speculative window is not supported in batch mode, with resume or "
+                   "with mirrors" << std::endl;
+      return 2;
+    }
+  }
+
+  if (!telemetryFile.empty()) {
+    if (telemetryCapacity < 1) {
+      std::cerr << "ERROR: the telemetry ring must have at least one record" << std::endl;
+      return 2;
+    }
+    // the events are recorded by the segment table
+    options.useSegmentTable = true;
+  }
+
+  if (options.useLossDetection && !options.useSegmentTable) {
+    std::cerr << "ERROR: loss detection requires the segment table" << std::endl;
+    return 2;
+  }
+
+  if (nValidatorThreads > 0 && validatorConfig.empty()) {
+    std::cerr << "ERROR: validator threads require a validator configuration file" << std::endl;
+    return 2;
+  }
+
+  // the segments are only as trustworthy as the manifest holding their digests
+  if (useManifest && validatorConfig.empty()) {
+    std::cerr << "ERROR: the manifest requires a validator configuration file" << std::endl;
+    return 2;
+  }
+
   options.interestLifetime = time::milliseconds(vm["lifetime"].as<uint64_t>());
 
   try {
     Face face;
     boost::asio::signal_set m_signalSetInt(face.getIoService(), SIGINT);
 
-
-    unique_ptr<DiscoverVersion> discover;
-    if (discoverType == "fixed") {
-      discover = make_unique<DiscoverVersionFixed>(prefix, face, options);
+    unique_ptr<TelemetryLog> telemetryLog;
+    if (!telemetryFile.empty()) {
+      telemetryLog = make_unique<TelemetryLog>(telemetryFile, telemetryCapacity);
+      options.telemetryLog = telemetryLog.get();
     }
-    else if (discoverType == "iterative") {
+
+    unique_ptr<DiscoveryCache> discoveryCache;
+    if (!discoveryCacheFile.empty())
+      discoveryCache = make_unique<DiscoveryCache>(discoveryCacheFile,
+                                                   time::milliseconds(discoveryCacheTtl));
+
+    auto makeDiscover = [&] (const Name& prefix) -> unique_ptr<DiscoverVersion> {
+      if (discoverType == "fixed")
+        return make_unique<DiscoverVersionFixed>(prefix, face, options);
+
+      if (discoverType == "parallel") {
+        DiscoverVersionParallel::Options optionsParallel(options);
+        optionsParallel.nRanges = nDiscoveryRanges;
+        return make_unique<DiscoverVersionParallel>(prefix, face, optionsParallel);
+      }
+
       DiscoverVersionIterative::Options optionsIterative(options);
       optionsIterative.maxRetriesAfterVersionFound = maxRetriesAfterVersionFound;
-      discover = make_unique<DiscoverVersionIterative>(prefix, face, optionsIterative);
+      return make_unique<DiscoverVersionIterative>(prefix, face, optionsIterative);
+    };
+
+    unique_ptr<Validator> validator;
+    if (validatorConfig.empty()) {
+      validator = make_unique<ValidatorNull>();
+    }
+    else if (nValidatorThreads == 0) {
+      auto config = make_unique<ValidatorConfig>(face);
+      config->load(validatorConfig);
+      validator = std::move(config);
     }
     else {
-      std::cerr << "ERROR: discover version type not valid" << std::endl;
-      return 2;
+      validator = make_unique<ParallelValidator>(face.getIoService(), nValidatorThreads,
+        [&validatorConfig] () -> unique_ptr<Validator> {
+          // without a Face, the certificates are not fetched
+          auto config = make_unique<ValidatorConfig>();
+          config->load(validatorConfig);
+          return unique_ptr<Validator>(std::move(config));
+        });
     }
 
-    ValidatorNull validator;
-    Consumer consumer(face, validator, options.isVerbose, std::cout, printStat);
+    if (useManifest)
+      validator = make_unique<ManifestValidator>(face, std::move(validator), options);
+
+    if (!batchFile.empty()) {
+      BatchFetcher fetcher(face, *validator, options, makeDiscover, batchConcurrency,
+                           noDiscovery, printStat);
+      if (discoveryCache != nullptr)
+        fetcher.setDiscoveryCache(*discoveryCache);
+      m_signalSetInt.async_wait(bind(ndn::chunks::handleBatchSIGINT, _1, std::ref(face)));
+
+      fetcher.run(objects);
+      m_signalSetInt.cancel();
+
+      tracepoint(chunksLog, cat_stopped, fetcher.getNFailed() > 0 ? 1 : 0);
+      return fetcher.getNFailed() > 0 ? 1 : 0;
+    }
+
+    unique_ptr<DiscoverVersion> discover = makeDiscover(objects.front().name);
+
+    Consumer consumer(face, *validator, options.isVerbose, std::cout, printStat);
+    if (zeroCopy)
+      consumer.setOutputFd(STDOUT_FILENO);
+    else if (!resumeFile.empty())
+      consumer.setResumableOutput(resumeFile);
+    else if (writerRingSize > 0)
+      consumer.setWriterThread(writerRingSize);
+    consumer.setSpeculativeWindow(speculativeWindow);
+    if (discoveryCache != nullptr)
+      consumer.setDiscoveryCache(*discoveryCache);
     m_signalSetInt.async_wait(bind(ndn::chunks::handleSIGINT, _1, std::ref(consumer)));
 
 
+    // the mirror faces must outlive the pipeline
+    std::vector<unique_ptr<Face>> mirrorFaces;
     PipelineInterests pipeline(face, options, randomWaitMax, startWait);
 
+    for (const std::string& mirror : mirrors) {
+      if (!useMirrorFaces) {
+        pipeline.addPath(face, mirror);
+        continue;
+      }
+      mirrorFaces.push_back(make_unique<Face>(face.getIoService()));
+      pipeline.addPath(*mirrorFaces.back(), mirror);
+    }
+
     BOOST_ASSERT(discover != nullptr);
 
     tracepoint(chunksLog, cat_started, options.startPipelineSize, options.maxPipelineSize, options.interestLifetime.count(),
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "parallel-validator.hpp"
+
+namespace ndn {
+namespace chunks {
+
+ParallelValidator::ResultQueue::ResultQueue()
+  : jobs(128)
+  , isDrainScheduled(false)
+  , isCanceled(false)
+{
+}
+
+ParallelValidator::ParallelValidator(boost::asio::io_service& io, size_t nThreads,
+                                     const ValidatorFactory& makeValidator)
+  : m_io(io)
+  , m_isStopped(false)
+  , m_results(make_shared<ResultQueue>())
+{
+  BOOST_ASSERT(nThreads > 0);
+
+  // create all the validators before starting the threads, so that the errors (e.g. in the
+  // configuration file) are reported to the caller
+  for (size_t i = 0; i < nThreads; ++i)
+    m_validators.push_back(makeValidator());
+
+  for (auto& validator : m_validators)
+    m_workers.emplace_back(&ParallelValidator::runWorker, this, std::ref(*validator));
+}
+
+ParallelValidator::~ParallelValidator()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_cv.notify_all();
+
+  for (auto& worker : m_workers)
+    worker.join();
+
+  for (Job* job : m_pendingJobs)
+    delete job;
+
+  // the handlers already posted to the io_service must not invoke the callbacks
+  m_results->isCanceled = true;
+  Job* job = nullptr;
+  while (m_results->jobs.pop(job))
+    delete job;
+}
+
+void
+ParallelValidator::checkPolicy(const Interest& interest,
+                               int nSteps,
+                               const OnInterestValidated& onValidated,
+                               const OnInterestValidationFailed& onValidationFailed,
+                               std::vector<shared_ptr<ValidationRequest>>& nextSteps)
+{
+  onValidationFailed(interest.shared_from_this(), "Interest validation is not supported");
+}
+
+void
+ParallelValidator::checkPolicy(const Data& data,
+                               int nSteps,
+                               const OnDataValidated& onValidated,
+                               const OnDataValidationFailed& onValidationFailed,
+                               std::vector<shared_ptr<ValidationRequest>>& nextSteps)
+{
+  Job* job = new Job;
+  job->data = data.shared_from_this();
+  job->onValidated = onValidated;
+  job->onValidationFailed = onValidationFailed;
+  job->isValidated = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingJobs.push_back(job);
+  }
+  m_cv.notify_one();
+}
+
+void
+ParallelValidator::runWorker(Validator& validator)
+{
+  while (true) {
+    Job* job = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_isStopped || !m_pendingJobs.empty(); });
+      if (m_isStopped)
+        return;
+
+      job = m_pendingJobs.front();
+      m_pendingJobs.pop_front();
+    }
+
+    job->failureReason = "Validation did not complete";
+    validator.validate(*job->data,
+                       [job] (const shared_ptr<const Data>&) {
+                         job->isValidated = true;
+                       },
+                       [job] (const shared_ptr<const Data>&, const std::string& reason) {
+                         job->failureReason = reason;
+                       });
+
+    m_results->jobs.push(job);
+
+    // post a single drain for all the results that are pushed before it runs
+    if (!m_results->isDrainScheduled.exchange(true)) {
+      shared_ptr<ResultQueue> results = m_results;
+      m_io.post([results] { drainResults(results); });
+    }
+  }
+}
+
+void
+ParallelValidator::drainResults(const shared_ptr<ResultQueue>& results)
+{
+  // reset the flag before popping, so that a result pushed after the last pop schedules another
+  // drain
+  results->isDrainScheduled = false;
+
+  if (results->isCanceled)
+    return;
+
+  Job* job = nullptr;
+  while (results->jobs.pop(job)) {
+    unique_ptr<Job> done(job);
+    if (done->isValidated)
+      done->onValidated(done->data);
+    else
+      done->onValidationFailed(done->data, done->failureReason);
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
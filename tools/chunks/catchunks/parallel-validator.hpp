@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_PARALLEL_VALIDATOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_PARALLEL_VALIDATOR_HPP
+
+#include "core/common.hpp"
+
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/lockfree/queue.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Validator that validates the Data packets on a pool of worker threads
+ *
+ * Every worker owns a separate validator, created by the factory given to the constructor. The
+ * Data packets are dispatched to the workers through a queue, and the results are passed back
+ * through a lock-free queue that is drained on the thread of @p io, where the validation
+ * callbacks are invoked. The callbacks are therefore not invoked in the same order as the
+ * packets have been submitted.
+ *
+ * The validators created by the factory must complete the validation synchronously, i.e. they
+ * must not fetch certificates with a Face. A validation that does not complete fails.
+ */
+class ParallelValidator : public Validator
+{
+public:
+  typedef function<unique_ptr<Validator>()> ValidatorFactory;
+
+  /**
+   * @param io the io_service on which the validation callbacks are invoked
+   * @param nThreads the number of worker threads, must be at least 1
+   * @param makeValidator creates the validator of each worker, it is called @p nThreads times
+   *        before the constructor returns
+   */
+  ParallelValidator(boost::asio::io_service& io, size_t nThreads,
+                    const ValidatorFactory& makeValidator);
+
+  /**
+   * @brief stop and join the worker threads
+   *
+   * The callbacks of the pending validations are not invoked.
+   */
+  ~ParallelValidator();
+
+  size_t
+  getNThreads() const
+  {
+    return m_workers.size();
+  }
+
+protected:
+  void
+  checkPolicy(const Interest& interest,
+              int nSteps,
+              const OnInterestValidated& onValidated,
+              const OnInterestValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE;
+
+  void
+  checkPolicy(const Data& data,
+              int nSteps,
+              const OnDataValidated& onValidated,
+              const OnDataValidationFailed& onValidationFailed,
+              std::vector<shared_ptr<ValidationRequest>>& nextSteps) NDN_CXX_DECL_OVERRIDE;
+
+private:
+  struct Job
+  {
+    shared_ptr<const Data> data;
+    OnDataValidated onValidated;
+    OnDataValidationFailed onValidationFailed;
+    bool isValidated;
+    std::string failureReason;
+  };
+
+  /**
+   * @brief the state shared with the handlers posted to the io_service, which can run after the
+   *        validator has been destroyed
+   */
+  struct ResultQueue
+  {
+    ResultQueue();
+
+    boost::lockfree::queue<Job*> jobs;
+    std::atomic<bool> isDrainScheduled;
+    std::atomic<bool> isCanceled;
+  };
+
+  void
+  runWorker(Validator& validator);
+
+  static void
+  drainResults(const shared_ptr<ResultQueue>& results);
+
+private:
+  boost::asio::io_service& m_io;
+  std::vector<unique_ptr<Validator>> m_validators;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<Job*> m_pendingJobs;
+  bool m_isStopped;
+
+  shared_ptr<ResultQueue> m_results;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_PARALLEL_VALIDATOR_HPP
@@ -26,33 +26,76 @@
  */
 
 #include "pipeline-interests.hpp"
+#include "congestion-control.hpp"
 #include "data-fetcher.hpp"
+#include "interest-template.hpp"
+#include "segment-allocator.hpp"
+#include "shared-window.hpp"
+#include "telemetry-log.hpp"
 
 #include "../chunks-tracepoint.hpp"
 
+#include <cmath>
+
 namespace ndn {
 namespace chunks {
 
+const time::milliseconds PipelineInterests::MIN_RETX_TIMEOUT = time::milliseconds(200);
+
 PipelineInterests::PipelineInterests(Face& face, const Options& options, uint64_t randomWaitMax, bool startWait)
+  : PipelineInterests(face, nullptr, options, randomWaitMax, startWait)
+{
+}
+
+PipelineInterests::PipelineInterests(Face& face, SharedWindow& sharedWindow, const Options& options)
+  : PipelineInterests(face, &sharedWindow, options, 0, false)
+{
+  BOOST_ASSERT(m_options.useSegmentTable);
+}
+
+PipelineInterests::PipelineInterests(Face& face, SharedWindow* sharedWindow, const Options& options,
+                                     uint64_t randomWaitMax, bool startWait)
   : m_face(face)
   , m_nextSegmentNo(0)
   , m_lastSegmentNo(0)
   , m_excludeSegmentNo(0)
   , m_options(options)
+  , m_firstSendSeq(0)
+  , m_nReceivedSent(0)
   , m_hasFinalBlockId(false)
   , m_hasError(false)
   , m_hasFailure(false)
   , m_randomWaitMax(randomWaitMax)
   , m_scheduler(face.getIoService())
+  , m_pacer(m_scheduler)
+  , m_timerWheelEvent(m_scheduler)
+  , m_isTimerWheelEventScheduled(false)
   , m_startWait(startWait)
   , m_currentWindowSize(m_options.startPipelineSize)
   , m_calculatedWindowSize(m_options.startPipelineSize)
+  , m_initialWindowSize(m_options.startPipelineSize)
+  , m_receiveWindow(std::numeric_limits<size_t>::max())
+  , m_isWindowCut(false)
   , m_hasMultiplierChanged(false)
   , m_nConsecutiveTimeouts(0)
+  , m_sharedWindow(sharedWindow)
+  , m_rttEstimator(m_options.rttWindowSize, m_options.useKarnAlgorithm)
+  , m_segmentAllocator(nullptr)
+  , m_isWaitingForSegments(false)
+  , rttEstimator(m_sharedWindow != nullptr ? m_sharedWindow->rttEstimator : m_rttEstimator)
+  , rttHistogram(60000000) // one minute
+  , retrievalTimeHistogram(600000000) // ten minutes
+  , m_congestionControl(CongestionControl::create(m_options.congestionControl, m_options, rttEstimator))
 {
   BOOST_ASSERT(m_options.maxPipelineSize >= m_options.startPipelineSize);
+  BOOST_ASSERT(!m_options.useLossDetection || m_options.useSegmentTable);
+
+  if (m_congestionControl == nullptr)
+    throw std::invalid_argument("Unknown congestion control: " + m_options.congestionControl);
+
+  if (!m_options.useSegmentTable)
+    m_segmentFetchers.resize(m_options.maxPipelineSize);
 
-  m_segmentFetchers.resize(m_options.maxPipelineSize);
   std::random_device rd;
   m_randomGen.seed(rd());
 
@@ -72,30 +115,29 @@ PipelineInterests::runWithExcludedSegment(const Data& data, DataCallback onData,
   m_onFailure = std::move(onFailure);
 
   Name dataName = data.getName();
-  m_prefix = dataName.getPrefix(-1);
+  setPrefix(dataName.getPrefix(-1));
   m_excludeSegmentNo = dataName[-1].toSegment();
 
   if (!data.getFinalBlockId().empty()) {
     m_hasFinalBlockId = true;
     m_lastSegmentNo = data.getFinalBlockId().toSegment();
+    if (m_options.useSegmentTable)
+      m_segmentTable.reserve(m_lastSegmentNo + 1);
   }
 
-  // if the FinalBlockId is unknown, this could potentially request non-existent segments
-  for (size_t nRequestedSegments = 0; nRequestedSegments < m_options.startPipelineSize;
-       nRequestedSegments++) {
-    deferredFetchNextSegment(nRequestedSegments);
-    //if (!fetchNextSegment(nRequestedSegments)) // all segments have been requested
-      //break;
+  if (!m_pathPrefixes.empty()) {
+    startPaths();
+    return;
   }
 
-  for (size_t nWaitingSegments = m_options.startPipelineSize; nWaitingSegments < m_options.maxPipelineSize;
-       nWaitingSegments++) {
-    m_waitingPipes.push(nWaitingSegments);
-  }
+  start();
+}
 
-  setWindowSize(m_options.startPipelineSize);
-  m_nMissingWindowEvents = m_options.startPipelineSize;
-  m_lastWindowSize = m_options.startPipelineSize;
+void
+PipelineInterests::setPrefix(const Name& prefix)
+{
+  m_prefix = prefix;
+  m_interestTemplate.reset(new InterestTemplate(m_prefix, m_options.mustBeFresh));
 }
 
 void
@@ -105,24 +147,78 @@ PipelineInterests::runWithName(Name nameWithVersion, DataCallback onData, Failur
   m_onData = std::move(onData);
   m_onFailure = std::move(onFailure);
 
-  m_prefix = nameWithVersion;
+  setPrefix(nameWithVersion);
   m_excludeSegmentNo = std::numeric_limits<uint64_t>::max();
 
+  start();
+}
+
+void
+PipelineInterests::runWithSegments(const Name& nameWithVersion, uint64_t lastSegmentNo,
+                                   const std::vector<uint64_t>& segments, DataCallback onData,
+                                   FailureCallback onFailure)
+{
+  BOOST_ASSERT(onData != nullptr);
+  m_onData = std::move(onData);
+  m_onFailure = std::move(onFailure);
+
+  setPrefix(nameWithVersion);
+  m_excludeSegmentNo = std::numeric_limits<uint64_t>::max();
+  m_hasFinalBlockId = true;
+  m_lastSegmentNo = lastSegmentNo;
+  // once the queued segments have been requested, there is no next segment to fetch
+  m_nextSegmentNo = lastSegmentNo + 1;
+
+  if (m_options.useSegmentTable)
+    m_segmentTable.resize(lastSegmentNo + 1);
+
+  for (uint64_t segmentNo : segments) {
+    BOOST_ASSERT(segmentNo <= lastSegmentNo);
+    if (m_options.useSegmentTable)
+      m_segmentTable[segmentNo].state = SegmentState::Waiting;
+    m_waitingSegments.push(segmentNo);
+  }
+
+  start();
+}
+
+void
+PipelineInterests::addPath(Face& face, const Name& prefix)
+{
+  BOOST_ASSERT(m_options.useSegmentTable && m_sharedWindow == nullptr);
+  m_pathPrefixes.push_back({&face, prefix});
+}
+
+void
+PipelineInterests::start()
+{
+  if (m_sharedWindow != nullptr) {
+    m_sharedWindow->addPipeline(*this);
+    return;
+  }
+
+  if (m_segmentAllocator != nullptr) {
+    m_hasFinalBlockId = true;
+    m_lastSegmentNo = m_segmentAllocator->getLastSegmentNo();
+    m_segmentTable.resize(m_lastSegmentNo + 1);
+    m_segmentAllocator->addPipeline(*this);
+  }
+
+  m_currentWindowSize = m_initialWindowSize;
   // if the FinalBlockId is unknown, this could potentially request non-existent segments
-  for (size_t nRequestedSegments = 0; nRequestedSegments < m_options.startPipelineSize;
+  for (size_t nRequestedSegments = 0; nRequestedSegments < m_initialWindowSize;
        nRequestedSegments++) {
     deferredFetchNextSegment(nRequestedSegments);
   }
 
-  for (size_t nWaitingSegments = m_options.startPipelineSize; nWaitingSegments < m_options.maxPipelineSize;
+  for (size_t nWaitingSegments = m_initialWindowSize; nWaitingSegments < m_options.maxPipelineSize;
        nWaitingSegments++) {
     m_waitingPipes.push(nWaitingSegments);
   }
 
-
-  setWindowSize(m_options.startPipelineSize);
-  m_nMissingWindowEvents = m_options.startPipelineSize;
-  m_lastWindowSize = m_options.startPipelineSize;
+  setWindowSize(m_initialWindowSize);
+  m_nMissingWindowEvents = m_initialWindowSize;
+  m_lastWindowSize = m_initialWindowSize;
 }
 
 bool
@@ -136,32 +232,53 @@ PipelineInterests::fetchNextSegment(std::size_t pipeNo)
 
   uint64_t segmentNo = m_nextSegmentNo;
 
+  // in segment table mode, a queued segment may have been cancelled while waiting
+  while (m_options.useSegmentTable && m_waitingSegments.size() > 0 &&
+         m_segmentTable[m_waitingSegments.front()].state != SegmentState::Waiting) {
+    m_waitingSegments.pop();
+  }
+
   if (m_waitingSegments.size() > 0) {
     segmentNo = m_waitingSegments.front();
     m_waitingSegments.pop();
 
     //std::cerr << "Pipe: " << pipeNo << " Requesting segment #" << segmentNo << " next segment no " << m_nextSegmentNo << std::endl;
   }
+  else if (m_segmentAllocator != nullptr) {
+    if (!m_segmentAllocator->allocate(*this, segmentNo)) {
+      // give back the slot, the allocator resumes the pipeline if another path releases a segment
+      m_isWaitingForSegments = true;
+      --m_currentWindowSize;
+      return false;
+    }
+  }
   else{
     ++m_nextSegmentNo;
-  }
 
-  if (segmentNo == m_excludeSegmentNo) {
-    ++segmentNo;
+    if (segmentNo == m_excludeSegmentNo) {
+      segmentNo = m_nextSegmentNo++;
+    }
   }
 
   if (m_hasFinalBlockId && segmentNo > m_lastSegmentNo)
    return false;
 
 
+  if (m_options.useSegmentTable) {
+    if (m_options.isVerbose)
+      std::cerr << "Requesting segment #" << segmentNo << std::endl;
+
+    // the segments queued by runWithSegments have not been sent yet
+    const SegmentInfo& info = getSegmentInfo(segmentNo);
+    sendInterest(segmentNo, info.state == SegmentState::Waiting && info.nTransmissions > 0);
+    return true;
+  }
+
   // Send interest for next segment
   if (m_options.isVerbose)
     std::cerr << "Pipe: " << pipeNo << " Requesting segment #" << segmentNo << std::endl;
 
-  Interest interest(Name(m_prefix).appendSegment(segmentNo));
-  interest.setInterestLifetime(getInterestLifetime());
-  interest.setMustBeFresh(m_options.mustBeFresh);
-  interest.setMaxSuffixComponents(1);
+  Interest interest = m_interestTemplate->makeInterest(segmentNo, getInterestLifetime());
 
   BOOST_ASSERT(!m_segmentFetchers[pipeNo].first || !m_segmentFetchers[pipeNo].first->isRunning());
 
@@ -197,14 +314,66 @@ PipelineInterests::deferredFetchNextSegment(std::size_t pipeNo)
   fetchNextSegment(pipeNo);
 }
 
+void
+PipelineInterests::scheduleFetchNextSegment(std::size_t pipeNo)
+{
+  if (m_options.usePacing)
+    m_pacer.schedule([this, pipeNo] { fetchNextSegment(pipeNo); });
+  else if (m_startWait)
+    fetchNextSegment(pipeNo);
+  else
+    deferredFetchNextSegment(pipeNo);
+}
+
+void
+PipelineInterests::recordDelivery(const Data& data)
+{
+  deliveryRateEstimator.addDelivery(data.getContent().value_size());
+
+  if (m_options.usePacing)
+    m_pacer.setRate(m_congestionControl->getPacingGain() * deliveryRateEstimator.getMaxDeliveryRate());
+}
+
+void
+PipelineInterests::recordSegmentTimes(const time::steady_clock::TimePoint& firstSendTime,
+                                      size_t nTransmissions)
+{
+  auto elapsed = time::duration_cast<time::microseconds>(time::steady_clock::now() - firstSendTime);
+  if (nTransmissions == 1)
+    rttHistogram.record(elapsed.count());
+  retrievalTimeHistogram.record(elapsed.count());
+}
+
 void
 PipelineInterests::cancel()
 {
+  for (auto& path : m_paths)
+    path->cancel();
+
+  stop();
+}
+
+void
+PipelineInterests::stop()
+{
+  if (m_sharedWindow != nullptr)
+    m_sharedWindow->removePipeline(*this);
+
+  if (m_segmentAllocator != nullptr)
+    m_segmentAllocator->removePipeline(*this);
+
+  m_pacer.cancel();
+  m_timerWheelEvent.cancel();
+  m_isTimerWheelEventScheduled = false;
+
   for (auto& fetcher : m_segmentFetchers)
     if (fetcher.first)
       fetcher.first->cancel();
 
   m_segmentFetchers.clear();
+
+  for (uint64_t segmentNo = 0; segmentNo < m_segmentTable.size(); ++segmentNo)
+    cancelSegment(segmentNo);
 }
 
 bool
@@ -218,18 +387,37 @@ PipelineInterests::setWindowSize(float size)
     m_calculatedWindowSize = size;
 
   tracepoint(chunksLog, window, m_calculatedWindowSize);
+  if (m_options.telemetryLog != nullptr)
+    m_options.telemetryLog->record(TelemetryEvent::WindowChange, 0, m_calculatedWindowSize);
 
   //std::cerr << "Window size: " << m_calculatedWindowSize << std::endl;
 
   return true;
 }
 
+void
+PipelineInterests::setInitialWindowSize(size_t size)
+{
+  m_initialWindowSize = std::min(std::max(size, m_options.startPipelineSize),
+                                 m_options.maxPipelineSize);
+}
+
 float
 PipelineInterests::getWindowSize() const
 {
   return m_calculatedWindowSize;
 }
 
+void
+PipelineInterests::setReceiveWindow(size_t nSegments)
+{
+  bool isRaised = nSegments > m_receiveWindow;
+  m_receiveWindow = nSegments;
+
+  if (isRaised && !m_hasError && m_sharedWindow == nullptr)
+    fillWindow();
+}
+
 time::milliseconds
 PipelineInterests::getInterestLifetime()
 {
@@ -255,6 +443,17 @@ PipelineInterests::getInterestLifetime()
 void
 PipelineInterests::fail(const std::string& reason)
 {
+  if (!m_hasError && m_segmentAllocator != nullptr && m_segmentAllocator->getNPipelines() > 1) {
+    // the other paths fetch the segments given up by this one
+    if (m_options.isVerbose)
+      std::cerr << "Path " << m_prefix << " failed: " << reason << std::endl;
+
+    stop();
+    m_hasError = true;
+    m_hasFailure = true;
+    return;
+  }
+
   if (!m_hasError) {
     cancel();
     m_hasError = true;
@@ -288,6 +487,10 @@ PipelineInterests::handleData(const Interest& interest, const Data& data,
   m_onData(interest, data);
 
   rttEstimator.addRttMeasurement(dataFetcher);
+  recordDelivery(data);
+  if (!dataFetcher->m_transmissionTimes.empty())
+    recordSegmentTimes(dataFetcher->m_transmissionTimes.front(),
+                       dataFetcher->m_transmissionTimes.size());
 
   if (!m_hasMultiplierChanged && m_options.rtoMultiplierReset) {
     rttEstimator.decrementRtoMultiplier();
@@ -314,21 +517,8 @@ PipelineInterests::handleData(const Interest& interest, const Data& data,
   m_currentWindowSize--;
   m_waitingPipes.push(pipeNo);
 
-  if (m_options.slowStartThreshold == 0 || m_calculatedWindowSize <= m_options.slowStartThreshold)
-    setWindowSize(m_calculatedWindowSize + 1);
-  else
-    setWindowSize(m_calculatedWindowSize + (1 / m_lastWindowSize));
-
-  while (m_currentWindowSize < m_calculatedWindowSize) {
-    if (m_startWait)
-      fetchNextSegment(m_waitingPipes.front());
-    else
-      deferredFetchNextSegment(m_waitingPipes.front());
-
-    m_waitingPipes.pop();
-
-    ++m_currentWindowSize;
-  }
+  increaseWindow();
+  fillWindow();
 
   handleWindowEvent();
 }
@@ -338,19 +528,25 @@ PipelineInterests::handleError(const std::string& reason, std::size_t pipeNo)
 {
   ++m_nConsecutiveTimeouts;
 
-  if (!m_hasMultiplierChanged) {
-    rttEstimator.incrementRtoMultiplier();
-    m_hasMultiplierChanged = true;
-  } // TODO improve tracepoint
+  if (m_sharedWindow != nullptr) {
+    // the window and the RTO multiplier are cut once per round of the shared window
+    m_sharedWindow->onLoss();
+  }
+  else {
+    if (!m_hasMultiplierChanged) {
+      rttEstimator.incrementRtoMultiplier();
+      m_hasMultiplierChanged = true;
+    } // TODO improve tracepoint
 
-  if (!m_isWindowCut) {
-    float lastWindowSize = m_lastWindowSize;
+    if (!m_isWindowCut) {
+      float lastWindowSize = m_lastWindowSize;
 
-    setWindowSize(m_lastWindowSize * m_options.windowCutMultiplier);
-    m_isWindowCut = true;
+      setWindowSize(m_congestionControl->onLoss(m_calculatedWindowSize, m_lastWindowSize));
+      m_isWindowCut = true;
 
-    rttEstimator.incrementRtoMultiplier();
-    tracepoint(chunksLog, window_decrease, lastWindowSize, rttEstimator.getRtoMultiplier());
+      rttEstimator.incrementRtoMultiplier();
+      tracepoint(chunksLog, window_decrease, lastWindowSize, rttEstimator.getRtoMultiplier());
+    }
   }
 
   if (m_options.nTimeoutBeforeReset !=0 && m_nConsecutiveTimeouts == m_options.nTimeoutBeforeReset) {
@@ -359,7 +555,8 @@ PipelineInterests::handleError(const std::string& reason, std::size_t pipeNo)
     // TODO don't cut window?
   }
 
-  handleWindowEvent();
+  if (m_sharedWindow == nullptr)
+    handleWindowEvent();
   //std::cerr << "Window size/2 : " << m_calculatedWindowSize << std::endl;
 }
 
@@ -410,6 +607,12 @@ PipelineInterests::canSend(uint64_t segmentNo, uint64_t pipeNo)
   return false;
 }
 
+void
+PipelineInterests::increaseWindow()
+{
+  setWindowSize(m_congestionControl->onData(m_calculatedWindowSize, m_lastWindowSize));
+}
+
 void
 PipelineInterests::handleWindowEvent()
 {
@@ -420,6 +623,510 @@ PipelineInterests::handleWindowEvent()
     m_isWindowCut = false;
     m_nMissingWindowEvents = m_calculatedWindowSize;
     m_lastWindowSize = m_calculatedWindowSize;
+
+    m_congestionControl->onRoundEnd(m_calculatedWindowSize);
+
+    // sample the delivery rate over about one RTT
+    if (rttEstimator.getRttMin() > 0) {
+      auto rttMin = time::milliseconds(static_cast<int64_t>(rttEstimator.getRttMin()));
+      deliveryRateEstimator.setSampleInterval(rttMin);
+    }
+  }
+}
+
+SegmentInfo&
+PipelineInterests::getSegmentInfo(uint64_t segmentNo)
+{
+  if (segmentNo >= m_segmentTable.size())
+    m_segmentTable.resize(std::max<uint64_t>(segmentNo + 1, m_segmentTable.size() * 2));
+
+  return m_segmentTable[segmentNo];
+}
+
+void
+PipelineInterests::sendInterest(uint64_t segmentNo, bool isRetransmission)
+{
+  Interest interest = m_interestTemplate->makeInterest(segmentNo, getInterestLifetime());
+
+  auto now = time::steady_clock::now();
+  SegmentInfo& info = getSegmentInfo(segmentNo);
+  if (!isRetransmission) {
+    info = SegmentInfo();
+    info.firstSendTime = now;
+  }
+  if (info.state != SegmentState::Backoff)
+    info.nCongestionRetries = 0;
+
+  info.lastSendTime = now;
+  ++info.nTransmissions;
+  info.state = SegmentState::InFlight;
+
+  // the callbacks capture only the pipeline, the segment is identified by the Interest name
+  info.interestId = m_face.expressInterest(interest,
+                                           [this] (const Interest& i, const Data& d) {
+                                             handleSegmentData(i, d);
+                                           },
+                                           [this] (const Interest& i, const lp::Nack& n) {
+                                             handleSegmentNack(i, n);
+                                           },
+                                           [this] (const Interest& i) {
+                                             handleSegmentTimeout(i);
+                                           });
+
+  if (m_options.useLossDetection)
+    trackTransmission(segmentNo);
+
+  tracepoint(chunksLog, interest_sent, segmentNo, interest.getInterestLifetime().count());
+  if (m_options.telemetryLog != nullptr)
+    m_options.telemetryLog->record(TelemetryEvent::InterestSent, segmentNo,
+                                   interest.getInterestLifetime().count(), now);
+}
+
+void
+PipelineInterests::retransmitSegment(uint64_t segmentNo)
+{
+  // in a shared window, the segment still holds the slot of its first transmission
+  if (m_sharedWindow != nullptr || m_currentWindowSize <= m_calculatedWindowSize) {
+    sendInterest(segmentNo, true);
+    return;
+  }
+
+  // the window has been reduced, the segment will be requested when there is room for it
+  m_currentWindowSize--;
+  getSegmentInfo(segmentNo).state = SegmentState::Waiting;
+  m_waitingSegments.push(segmentNo);
+}
+
+void
+PipelineInterests::cancelSegment(uint64_t segmentNo)
+{
+  SegmentInfo& info = m_segmentTable[segmentNo];
+  stopRetxTimer(info);
+
+  switch (info.state) {
+    case SegmentState::InFlight:
+      m_face.removePendingInterest(info.interestId);
+      info.state = SegmentState::Cancelled;
+      break;
+    case SegmentState::Backoff:
+    case SegmentState::Waiting:
+      // the scheduled retransmission or the waiting queue entry will find the segment cancelled
+      info.state = SegmentState::Cancelled;
+      break;
+    default:
+      return;
+  }
+
+  if (m_sharedWindow != nullptr)
+    m_sharedWindow->release(1);
+
+  if (m_segmentAllocator != nullptr)
+    m_segmentAllocator->release(*this, segmentNo);
+}
+
+void
+PipelineInterests::handleSegmentData(const Interest& interest, const Data& data)
+{
+  if (m_hasError)
+    return;
+
+  BOOST_ASSERT(data.getName().equals(interest.getName()));
+
+  uint64_t segmentNo = data.getName()[-1].toSegment();
+  if (segmentNo >= m_segmentTable.size() || m_segmentTable[segmentNo].state != SegmentState::InFlight)
+    return;
+
+  SegmentInfo& info = m_segmentTable[segmentNo];
+  info.state = SegmentState::Received;
+  stopRetxTimer(info);
+
+  if (m_options.useLossDetection && m_options.reorderThreshold > 0 &&
+      info.sendSeq >= m_firstSendSeq) {
+    m_sentSegments[info.sendSeq - m_firstSendSeq].isReceived = true;
+    ++m_nReceivedSent;
+  }
+
+  m_nConsecutiveTimeouts = 0;
+
+  tracepoint(chunksLog, data_received, segmentNo, data.getContent().size(),
+             time::duration_cast<time::milliseconds>(time::steady_clock::now() - info.lastSendTime).count());
+  if (m_options.telemetryLog != nullptr) {
+    auto now = time::steady_clock::now();
+    auto rtt = time::duration_cast<time::microseconds>(now - info.lastSendTime);
+    m_options.telemetryLog->record(TelemetryEvent::DataReceived, segmentNo, rtt.count() / 1000.0f,
+                                   now);
+  }
+
+  if (m_options.isVerbose)
+    std::cerr << "Received segment #" << segmentNo << std::endl;
+
+  // a segment requested over two paths is delivered only once
+  if (m_segmentAllocator == nullptr || m_segmentAllocator->onReceived(*this, segmentNo))
+    m_onData(interest, data);
+
+  rttEstimator.addRttMeasurement(info.firstSendTime, info.lastSendTime, info.nTransmissions);
+  recordDelivery(data);
+  recordSegmentTimes(info.firstSendTime, info.nTransmissions);
+
+  if (m_sharedWindow == nullptr && !m_hasMultiplierChanged && m_options.rtoMultiplierReset) {
+    rttEstimator.decrementRtoMultiplier();
+    m_hasMultiplierChanged = true;
+  }
+
+  if (!m_hasFinalBlockId && !data.getFinalBlockId().empty()) {
+    m_lastSegmentNo = data.getFinalBlockId().toSegment();
+    m_hasFinalBlockId = true;
+
+    for (uint64_t i = 0; i < m_segmentTable.size(); ++i) {
+      if (i > m_lastSegmentNo) {
+        // Stop trying to fetch segments that are not part of the content
+        cancelSegment(i);
+      }
+      else if (m_segmentTable[i].state == SegmentState::Failed) {
+        // there was an error while fetching a segment that is part of the content
+        fail("Failure retriving segment #" + to_string(i));
+        return;
+      }
+    }
+  }
+
+  if (m_sharedWindow != nullptr) {
+    if (m_options.useLossDetection && m_options.reorderThreshold > 0)
+      detectGapLosses();
+
+    // the freed slot may be granted to any pipeline sharing the window, this one included
+    m_sharedWindow->onData();
+    return;
+  }
+
+  m_currentWindowSize--;
+
+  increaseWindow();
+
+  if (m_options.useLossDetection && m_options.reorderThreshold > 0)
+    detectGapLosses();
+
+  fillWindow();
+
+  handleWindowEvent();
+}
+
+void
+PipelineInterests::handleSegmentNack(const Interest& interest, const lp::Nack& nack)
+{
+  if (m_hasError)
+    return;
+
+  uint64_t segmentNo = interest.getName()[-1].toSegment();
+  if (segmentNo >= m_segmentTable.size() || m_segmentTable[segmentNo].state != SegmentState::InFlight)
+    return;
+
+  SegmentInfo& info = m_segmentTable[segmentNo];
+  stopRetxTimer(info);
+
+  tracepoint(chunksLog, interest_nack, segmentNo);
+  if (m_options.telemetryLog != nullptr)
+    m_options.telemetryLog->record(TelemetryEvent::Nack, segmentNo,
+                                   static_cast<int>(nack.getReason()));
+
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE)
+    ++info.nNacks;
+
+  if (m_options.isVerbose)
+    std::cerr << "Received Nack with reason " << nack.getReason()
+              << " for Interest " << interest << std::endl;
+
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE &&
+      info.nNacks > static_cast<uint32_t>(m_options.maxRetriesOnTimeoutOrNack)) {
+    info.state = SegmentState::Failed;
+    handleSegmentFailure(segmentNo, "Reached the maximum number of nack retries (" +
+                                    to_string(m_options.maxRetriesOnTimeoutOrNack) +
+                                    ") while retrieving data for " + interest.getName().toUri());
+    return;
+  }
+
+  switch (nack.getReason()) {
+    case lp::NackReason::DUPLICATE: {
+      retransmitSegment(segmentNo);
+      break;
+    }
+    case lp::NackReason::CONGESTION: {
+      time::milliseconds backoffTime(static_cast<uint64_t>(std::pow(2, info.nCongestionRetries)));
+      if (backoffTime > DataFetcher::MAX_CONGESTION_BACKOFF_TIME)
+        backoffTime = DataFetcher::MAX_CONGESTION_BACKOFF_TIME;
+      else
+        info.nCongestionRetries++;
+
+      info.state = SegmentState::Backoff;
+      m_scheduler.scheduleEvent(backoffTime, [this, segmentNo] {
+          if (!m_hasError && m_segmentTable[segmentNo].state == SegmentState::Backoff)
+            retransmitSegment(segmentNo);
+        });
+      break;
+    }
+    default: {
+      info.state = SegmentState::Failed;
+      handleSegmentFailure(segmentNo, "Could not retrieve data for " + interest.getName().toUri() +
+                                      ", reason: " + boost::lexical_cast<std::string>(nack.getReason()));
+      break;
+    }
+  }
+}
+
+void
+PipelineInterests::handleSegmentTimeout(const Interest& interest)
+{
+  if (m_hasError)
+    return;
+
+  uint64_t segmentNo = interest.getName()[-1].toSegment();
+  if (segmentNo >= m_segmentTable.size() || m_segmentTable[segmentNo].state != SegmentState::InFlight)
+    return;
+
+  if (m_options.isVerbose)
+    std::cerr << "Timeout for Interest " << interest << std::endl;
+
+  handleSegmentLoss(segmentNo);
+}
+
+void
+PipelineInterests::handleSegmentLoss(uint64_t segmentNo)
+{
+  SegmentInfo& info = m_segmentTable[segmentNo];
+  BOOST_ASSERT(info.state == SegmentState::InFlight);
+
+  // the Interest may still be pending if the loss has been detected before its lifetime expired
+  stopRetxTimer(info);
+  m_face.removePendingInterest(info.interestId);
+
+  tracepoint(chunksLog, interest_timeout, segmentNo);
+  if (m_options.telemetryLog != nullptr)
+    m_options.telemetryLog->record(TelemetryEvent::Timeout, segmentNo, info.nTransmissions);
+
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE)
+    ++info.nTimeouts;
+
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE &&
+      info.nTimeouts > static_cast<uint32_t>(m_options.maxRetriesOnTimeoutOrNack)) {
+    info.state = SegmentState::Failed;
+    handleSegmentFailure(segmentNo, "Reached the maximum number of timeout retries (" +
+                                    to_string(m_options.maxRetriesOnTimeoutOrNack) +
+                                    ") while retrieving data for " +
+                                    Name(m_prefix).appendSegment(segmentNo).toUri());
+    return;
+  }
+
+  handleError("Timeout", 0);
+  retransmitSegment(segmentNo);
+}
+
+void
+PipelineInterests::handleSegmentFailure(uint64_t segmentNo, const std::string& reason)
+{
+  if (m_sharedWindow != nullptr)
+    m_sharedWindow->release(1);
+
+  if (m_segmentAllocator != nullptr)
+    m_segmentAllocator->release(*this, segmentNo);
+
+  if (m_hasError)
+    return;
+
+  if (m_hasFinalBlockId && segmentNo <= m_lastSegmentNo) {
+    fail(reason);
+  }
+  else if (!m_hasFinalBlockId) {
+    // don't fetch the following segments
+    bool areAllSegmentsStopped = true;
+    for (uint64_t i = 0; i < m_segmentTable.size(); ++i) {
+      if (i > segmentNo) {
+        cancelSegment(i);
+      }
+      else if (m_segmentTable[i].state == SegmentState::InFlight ||
+               m_segmentTable[i].state == SegmentState::Backoff ||
+               m_segmentTable[i].state == SegmentState::Waiting) {
+        areAllSegmentsStopped = false;
+      }
+    }
+
+    if (areAllSegmentsStopped) {
+      if (m_onFailure)
+        fail("Fetching terminated but no final segment number has been found");
+    }
+    else {
+      m_hasFailure = true;
+    }
+  }
+}
+
+void
+PipelineInterests::fillWindow()
+{
+  float windowSize = std::min<float>(m_calculatedWindowSize, m_receiveWindow);
+
+  // without a segment left, fetchNextSegment gives back the slot it has been given
+  while (m_currentWindowSize < windowSize && !m_isWaitingForSegments) {
+    if (m_options.useSegmentTable) {
+      scheduleFetchNextSegment(0);
+    }
+    else {
+      if (m_waitingPipes.empty())
+        break;
+      scheduleFetchNextSegment(m_waitingPipes.front());
+      m_waitingPipes.pop();
+    }
+    ++m_currentWindowSize;
+  }
+}
+
+void
+PipelineInterests::startPaths()
+{
+  if (!m_hasFinalBlockId) {
+    fail("Fetching over several paths requires the FinalBlockId of the first segment");
+    return;
+  }
+
+  m_ownedAllocator = make_unique<SegmentAllocator>(m_face.getIoService(), m_lastSegmentNo,
+                                                   m_excludeSegmentNo);
+  m_segmentAllocator = m_ownedAllocator.get();
+  start();
+
+  for (const auto& pathPrefix : m_pathPrefixes) {
+    // the private constructor is not reachable from make_unique
+    unique_ptr<PipelineInterests> path(new PipelineInterests(*pathPrefix.first, nullptr, m_options,
+                                                             m_randomWaitMax, m_startWait));
+    path->m_segmentAllocator = m_segmentAllocator;
+    path->runWithName(Name(pathPrefix.second).append(m_prefix[-1]), m_onData, m_onFailure);
+    m_paths.push_back(std::move(path));
+  }
+}
+
+void
+PipelineInterests::abandonSegment(uint64_t segmentNo)
+{
+  SegmentState state = m_segmentTable[segmentNo].state;
+  cancelSegment(segmentNo);
+
+  // the waiting segments do not hold a slot of the window
+  if (!m_hasError && (state == SegmentState::InFlight || state == SegmentState::Backoff)) {
+    --m_currentWindowSize;
+    fillWindow();
+  }
+}
+
+void
+PipelineInterests::resumeAllocation()
+{
+  m_isWaitingForSegments = false;
+
+  if (!m_hasError)
+    fillWindow();
+}
+
+bool
+PipelineInterests::sendNextSharedInterest()
+{
+  if (m_hasError)
+    return false;
+
+  return fetchNextSegment(0);
+}
+
+time::nanoseconds
+PipelineInterests::getRetxTimeout()
+{
+  if (rttEstimator.getRTO() == -1)
+    return getInterestLifetime();
+
+  time::nanoseconds rto = time::microseconds(static_cast<int64_t>(rttEstimator.getRTO() * 1000));
+  return std::max<time::nanoseconds>(rto, MIN_RETX_TIMEOUT);
+}
+
+void
+PipelineInterests::trackTransmission(uint64_t segmentNo)
+{
+  SegmentInfo& info = m_segmentTable[segmentNo];
+
+  info.retxTimer = m_timerWheel.add(info.lastSendTime + getRetxTimeout(), segmentNo);
+  scheduleTimerWheel();
+
+  if (m_options.reorderThreshold > 0) {
+    info.sendSeq = m_firstSendSeq + m_sentSegments.size();
+    m_sentSegments.push_back({segmentNo, false});
+  }
+}
+
+void
+PipelineInterests::stopRetxTimer(SegmentInfo& info)
+{
+  if (info.retxTimer != TimerWheel::INVALID_TIMER) {
+    m_timerWheel.cancel(info.retxTimer);
+    info.retxTimer = TimerWheel::INVALID_TIMER;
+  }
+}
+
+void
+PipelineInterests::scheduleTimerWheel()
+{
+  if (m_timerWheel.empty())
+    return;
+
+  // a single scheduler event serves the whole wheel, it is moved only if a timer expires earlier
+  auto nextExpiry = m_timerWheel.getNextExpiry();
+  if (m_isTimerWheelEventScheduled && nextExpiry >= m_timerWheelEventTime)
+    return;
+
+  auto now = time::steady_clock::now();
+  time::nanoseconds delay = nextExpiry > now ? nextExpiry - now : time::nanoseconds::zero();
+  m_timerWheelEvent = m_scheduler.scheduleEvent(delay, bind(&PipelineInterests::handleTimerWheelEvent,
+                                                            this));
+  m_timerWheelEventTime = nextExpiry;
+  m_isTimerWheelEventScheduled = true;
+}
+
+void
+PipelineInterests::handleTimerWheelEvent()
+{
+  m_isTimerWheelEventScheduled = false;
+
+  m_timerWheel.advance(time::steady_clock::now(), [this] (uint64_t segmentNo) {
+      m_segmentTable[segmentNo].retxTimer = TimerWheel::INVALID_TIMER;
+      if (!m_hasError && m_segmentTable[segmentNo].state == SegmentState::InFlight) {
+        if (m_options.isVerbose)
+          std::cerr << "Retransmission timeout for segment #" << segmentNo << std::endl;
+        handleSegmentLoss(segmentNo);
+      }
+    });
+
+  scheduleTimerWheel();
+}
+
+void
+PipelineInterests::detectGapLosses()
+{
+  // every transmission before the first in-flight one is either received or stale, so the
+  // received transmissions left in the queue have all been sent after it
+  while (!m_sentSegments.empty() && !m_hasError) {
+    SentSegment sent = m_sentSegments.front();
+    const SegmentInfo& info = m_segmentTable[sent.segmentNo];
+    bool isInFlight = info.sendSeq == m_firstSendSeq && info.state == SegmentState::InFlight;
+
+    if (isInFlight && !sent.isReceived && m_nReceivedSent < m_options.reorderThreshold)
+      break;
+
+    m_sentSegments.pop_front();
+    ++m_firstSendSeq;
+
+    if (sent.isReceived) {
+      --m_nReceivedSent;
+    }
+    else if (isInFlight) {
+      if (m_options.isVerbose)
+        std::cerr << "Segment #" << sent.segmentNo << " lost, " << m_nReceivedSent
+                  << " later segments received" << std::endl;
+      handleSegmentLoss(sent.segmentNo);
+    }
   }
 }
 
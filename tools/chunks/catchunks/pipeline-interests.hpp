@@ -29,14 +29,25 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_HPP
 
 #include "core/common.hpp"
+#include "core/hdr-histogram.hpp"
 #include "options.hpp"
 #include <queue>
 #include "rtt-estimator.hpp"
+#include "delivery-rate-estimator.hpp"
+#include "interest-pacer.hpp"
+#include "timer-wheel.hpp"
+
+#include <deque>
 
 namespace ndn {
 namespace chunks {
 
+class CongestionControl;
 class DataFetcher;
+class InterestTemplate;
+class SegmentAllocator;
+class SharedWindow;
+class TelemetryLog;
 
 class PipelineInterestsOptions : public Options
 {
@@ -50,6 +61,14 @@ public:
     , nTimeoutBeforeReset(3)
     , windowCutMultiplier(0.75)
     , rtoMultiplierReset(false)
+    , useSegmentTable(false)
+    , congestionControl("aimd")
+    , usePacing(false)
+    , useLossDetection(false)
+    , reorderThreshold(3)
+    , telemetryLog(nullptr)
+    , rttWindowSize(RttEstimator::DEFAULT_WINDOW_SIZE)
+    , useKarnAlgorithm(false)
   {
   }
 
@@ -60,6 +79,47 @@ public:
   size_t nTimeoutBeforeReset;
   float windowCutMultiplier;
   bool rtoMultiplierReset;
+  bool useSegmentTable; ///< track segments in a flat state table instead of one DataFetcher per pipe
+  std::string congestionControl; ///< name of the congestion controller, see CongestionControl::create
+  bool usePacing; ///< space the Interests at the estimated bottleneck rate
+  bool useLossDetection; ///< detect the losses with the RTO and the gaps, requires useSegmentTable
+  size_t reorderThreshold; ///< later segments received before a segment is lost, 0 = no gap detection
+  TelemetryLog* telemetryLog; ///< records the events of the segment table mode, if not nullptr
+  size_t rttWindowSize; ///< RTT samples over which the minimum RTT is computed
+  bool useKarnAlgorithm; ///< ignore the RTT of the retransmitted segments
+};
+
+/**
+ * @brief state of a segment tracked by the segment table
+ */
+enum class SegmentState : uint8_t {
+  None,       ///< no Interest has been expressed for the segment
+  InFlight,   ///< an Interest is pending for the segment
+  Backoff,    ///< waiting for the congestion backoff time before retransmitting
+  Waiting,    ///< retransmission deferred until the window allows it
+  Received,   ///< the segment has been received
+  Failed,     ///< the maximum number of retries has been reached or a fatal Nack was received
+  Cancelled   ///< fetching has been stopped without error
+};
+
+/**
+ * @brief per-segment retrieval state, stored by value in a segment-indexed array
+ *
+ * Replaces the DataFetcher object when PipelineInterestsOptions::useSegmentTable is set, so that
+ * fetching a segment does not require any heap allocation by the pipeline.
+ */
+struct SegmentInfo
+{
+  time::steady_clock::TimePoint firstSendTime;
+  time::steady_clock::TimePoint lastSendTime;
+  const PendingInterestId* interestId = nullptr;
+  TimerWheel::TimerId retxTimer = TimerWheel::INVALID_TIMER;
+  uint64_t sendSeq = 0; ///< position of the last transmission in the send order
+  uint32_t nTransmissions = 0;
+  uint32_t nTimeouts = 0;
+  uint32_t nNacks = 0;
+  uint32_t nCongestionRetries = 0;
+  SegmentState state = SegmentState::None;
 };
 
 /**
@@ -80,16 +140,34 @@ public:
 
   typedef function<void(const Interest&, const Data&, const shared_ptr<DataFetcher>&)> DataFetcherDoneCallback;
 
+  /**
+   * @brief lower bound of the retransmission timeout used by the loss detection
+   *
+   * The RTT samples have a millisecond resolution, hence on fast links the RTO can be 0.
+   */
+  static const time::milliseconds MIN_RETX_TIMEOUT;
+
 public:
   /**
    * @brief create a PipelineInterests service
    *
    * Configures the pipelining service without specifying the retrieval namespace. After this
    * configuration the method runWithExcludedSegment must be called to run the Pipeline.
+   *
+   * @throw std::invalid_argument the congestion control in @p options is unknown
    */
   explicit
   PipelineInterests(Face& face, const Options& options = Options(), uint64_t randomWaitMax = 0, bool startWait = false);
 
+  /**
+   * @brief create a PipelineInterests service that sends its Interests in the slots of a window
+   *        shared with other pipelines
+   *
+   * The pipeline uses the RTT estimator of @p sharedWindow, which must outlive the pipeline.
+   * @p options must enable the segment table mode.
+   */
+  PipelineInterests(Face& face, SharedWindow& sharedWindow, const Options& options);
+
   ~PipelineInterests();
 
   /**
@@ -109,6 +187,34 @@ public:
   void
   runWithName(Name nameWithVersion, DataCallback onData, FailureCallback onFailure);
 
+  /**
+   * @brief fetch only @p segments of the specified prefix, e.g. the segments that are missing
+   *        from an interrupted transfer
+   *
+   * @param nameWithVersion the name of the content, without the segment number
+   * @param lastSegmentNo the last segment of the content
+   * @param segments the segments to fetch, in the order they are requested
+   */
+  void
+  runWithSegments(const Name& nameWithVersion, uint64_t lastSegmentNo,
+                  const std::vector<uint64_t>& segments, DataCallback onData,
+                  FailureCallback onFailure);
+
+  /**
+   * @brief fetch the segments also over @p face from @p prefix, e.g. a mirror of the content
+   *
+   * The content is fetched from @p prefix followed by the version of the Data passed to
+   * runWithExcludedSegment, which must carry a FinalBlockId. Each path has its own window and RTT
+   * estimator, and the segments are allocated to the paths as their windows allow, see
+   * SegmentAllocator. A path that fails gives up its segments to the other ones, the fetching
+   * fails only when all the paths have failed.
+   *
+   * Must be called before runWithExcludedSegment, in segment table mode and without a shared
+   * window. @p face must outlive the pipeline.
+   */
+  void
+  addPath(Face& face, const Name& prefix);
+
   /**
    * @brief stop all fetch operations
    */
@@ -121,10 +227,40 @@ public:
   float
   getWindowSize() const;
 
+  /**
+   * @brief start with a window of @p size Interests instead of the start pipeline size, e.g. the
+   *        window reached by a previous retrieval from the same producer
+   *
+   * @p size is limited to the start and max pipeline sizes. Must be called before the pipeline is
+   * run; ignored with a shared window.
+   */
+  void
+  setInitialWindowSize(size_t size);
+
+  /**
+   * @brief do not send new Interests while @p nSegments or more are in flight, e.g. because the
+   *        output cannot store more segments
+   *
+   * The congestion window is not changed and the retransmissions are not limited. Raising the
+   * limit sends the Interests that the window allows right away. Ignored with a shared window;
+   * in multipath mode, only the first path is limited.
+   */
+  void
+  setReceiveWindow(size_t nSegments);
+
   time::milliseconds
   getInterestLifetime();
 
 private:
+  PipelineInterests(Face& face, SharedWindow* sharedWindow, const Options& options,
+                    uint64_t randomWaitMax, bool startWait);
+
+  /**
+   * @brief express the first Interests of the pipeline
+   */
+  void
+  start();
+
   /**
    * @brief fetch the next segment that has not been requested yet
    *
@@ -136,6 +272,26 @@ private:
   void
   deferredFetchNextSegment(size_t pipeNo);
 
+  /**
+   * @brief fetch the next segment after the pacing or the random wait, if any
+   */
+  void
+  scheduleFetchNextSegment(size_t pipeNo);
+
+  /**
+   * @brief record the delivery of @p data and update the pacing rate
+   */
+  void
+  recordDelivery(const Data& data);
+
+  /**
+   * @brief record the round trip and retrieval times of a segment in the histograms
+   *
+   * The round trip time is recorded only if the segment was not retransmitted.
+   */
+  void
+  recordSegmentTimes(const time::steady_clock::TimePoint& firstSendTime, size_t nTransmissions);
+
   void
   fail(const std::string& reason);
 
@@ -154,8 +310,125 @@ private:
   void
   handleWindowEvent();
 
+  void
+  increaseWindow();
+
+  /**
+   * @brief request the next segments while both the congestion and the receive windows have
+   *        room for them
+   */
+  void
+  fillWindow();
+
+private: // segment table mode
+  SegmentInfo&
+  getSegmentInfo(uint64_t segmentNo);
+
+  /**
+   * @brief express the Interest for @p segmentNo and record it in the segment table
+   */
+  void
+  sendInterest(uint64_t segmentNo, bool isRetransmission);
+
+  /**
+   * @brief retransmit @p segmentNo, or queue it if the window has shrunk in the meantime
+   */
+  void
+  retransmitSegment(uint64_t segmentNo);
+
+  void
+  cancelSegment(uint64_t segmentNo);
+
+  void
+  handleSegmentData(const Interest& interest, const Data& data);
+
+  void
+  handleSegmentNack(const Interest& interest, const lp::Nack& nack);
+
+  void
+  handleSegmentTimeout(const Interest& interest);
+
+  void
+  handleSegmentFailure(uint64_t segmentNo, const std::string& reason);
+
+  /**
+   * @brief retransmit an in-flight segment that has been detected as lost
+   */
+  void
+  handleSegmentLoss(uint64_t segmentNo);
+
+  /**
+   * @brief stop the fetch operations of this pipeline only, not of its paths
+   */
+  void
+  stop();
+
+private: // multipath mode
+  friend class SegmentAllocator;
+
+  /**
+   * @brief start a pipeline for each path added with addPath, sharing the segments of the content
+   */
+  void
+  startPaths();
+
+  /**
+   * @brief stop requesting @p segmentNo, which has been received over another path
+   */
+  void
+  abandonSegment(uint64_t segmentNo);
+
+  /**
+   * @brief request segments again after the allocator has run out of them
+   */
+  void
+  resumeAllocation();
+
+private: // shared window mode
+  friend class SharedWindow;
+
+  /**
+   * @brief request the next segment in the slot granted by the shared window
+   *
+   * @return false if there is an error or all the segments have been requested
+   */
+  bool
+  sendNextSharedInterest();
+
+private: // loss detection
+  time::nanoseconds
+  getRetxTimeout();
+
+  /**
+   * @brief start the retransmission timer and record the transmission in the send order
+   */
+  void
+  trackTransmission(uint64_t segmentNo);
+
+  void
+  stopRetxTimer(SegmentInfo& info);
+
+  void
+  scheduleTimerWheel();
+
+  void
+  handleTimerWheelEvent();
+
+  /**
+   * @brief mark as lost the in-flight segments sent before at least reorderThreshold received ones
+   */
+  void
+  detectGapLosses();
+
+  /**
+   * @brief set the name of the segments and build the Interest template for it
+   */
+  void
+  setPrefix(const Name& prefix);
+
 private:
   Name m_prefix;
+  unique_ptr<InterestTemplate> m_interestTemplate;
   Face& m_face;
   uint64_t m_nextSegmentNo;
   uint64_t m_lastSegmentNo;
@@ -164,6 +437,18 @@ private:
   FailureCallback m_onFailure;
   const Options m_options;
   std::vector<std::pair<shared_ptr<DataFetcher>, uint64_t>> m_segmentFetchers;
+  std::vector<SegmentInfo> m_segmentTable; ///< indexed by segment number, used in segment table mode
+
+  struct SentSegment
+  {
+    uint64_t segmentNo;
+    bool isReceived;
+  };
+
+  TimerWheel m_timerWheel; ///< retransmission timers of all the in-flight segments
+  std::deque<SentSegment> m_sentSegments; ///< transmissions in send order
+  uint64_t m_firstSendSeq; ///< send order position of m_sentSegments.front()
+  size_t m_nReceivedSent; ///< received transmissions in m_sentSegments
   bool m_hasFinalBlockId;
   /**
    * true if there's a critical error
@@ -177,15 +462,21 @@ private:
 
   uint64_t m_randomWaitMax;
   Scheduler m_scheduler;
+  InterestPacer m_pacer;
+  scheduler::ScopedEventId m_timerWheelEvent;
+  time::steady_clock::TimePoint m_timerWheelEventTime;
+  bool m_isTimerWheelEventScheduled;
   std::mt19937 m_randomGen;
   bool m_startWait;
 
   // Congestion control
   float m_currentWindowSize;
   float m_calculatedWindowSize;
+  size_t m_initialWindowSize;
   float m_lastWindowSize;
   std::queue<uint64_t/*Pipe number*/>  m_waitingPipes;
   std::queue<uint64_t/*Segment number*/>  m_waitingSegments;
+  size_t m_receiveWindow; ///< limit set by the user of the pipeline, see setReceiveWindow
 
   uint64_t m_nMissingWindowEvents; // TODO better name
   bool m_isWindowCut; // TODO better name
@@ -194,8 +485,23 @@ private:
 
   size_t m_nConsecutiveTimeouts;
 
+  SharedWindow* m_sharedWindow; ///< nullptr unless the window is shared with other pipelines
+  RttEstimator m_rttEstimator; ///< used unless the window is shared
+
+  std::vector<std::pair<Face*, Name>> m_pathPrefixes; ///< paths added with addPath
+  unique_ptr<SegmentAllocator> m_ownedAllocator; ///< allocator of the paths started by this pipeline
+  SegmentAllocator* m_segmentAllocator; ///< nullptr unless the segments are shared among paths
+  std::vector<unique_ptr<PipelineInterests>> m_paths; ///< declared after m_ownedAllocator
+  bool m_isWaitingForSegments; ///< the allocator has no segment left for this path
+
 public:
-  RttEstimator rttEstimator;
+  RttEstimator& rttEstimator;
+  DeliveryRateEstimator deliveryRateEstimator;
+  tools::HdrHistogram rttHistogram; ///< round trip times in microseconds
+  tools::HdrHistogram retrievalTimeHistogram; ///< first request to arrival, in microseconds
+
+private:
+  unique_ptr<CongestionControl> m_congestionControl;
 };
 
 } // namespace chunks
@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "resumable-output.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+static const char MAGIC[8] = {'N', 'D', 'N', 'C', 'H', 'U', 'N', 'K'};
+
+/**
+ * @brief layout of the beginning of the sidecar, followed by the name and the bitmap
+ */
+struct ResumableOutput::Header
+{
+  char magic[8];
+  uint64_t nSegments;
+  uint64_t segmentSize;
+  uint64_t lastSegmentSize; ///< 0 if the last segment has not been written yet
+  uint64_t nameSize; ///< size of the wire encoding of the versioned name
+};
+
+ResumableOutput::ResumableOutput(const std::string& path)
+  : m_bitmapPath(path + ".bitmap")
+  , m_fd(::open(path.c_str(), O_RDWR | O_CREAT, 0644))
+  , m_bitmapFd(-1)
+  , m_map(nullptr)
+  , m_mapSize(0)
+  , m_header(nullptr)
+  , m_bitmap(nullptr)
+  , m_nSegments(0)
+  , m_segmentSize(0)
+  , m_nReceived(0)
+  , m_lastSegmentSize(0)
+{
+  if (m_fd < 0)
+    throw Error("Cannot open " + path + ": " + std::strerror(errno));
+}
+
+ResumableOutput::~ResumableOutput()
+{
+  try {
+    if (m_map != nullptr)
+      sync();
+  }
+  catch (const Error&) {
+  }
+
+  unmapBitmap();
+  ::close(m_fd);
+}
+
+bool
+ResumableOutput::resume(const Name& name)
+{
+  BOOST_ASSERT(!isStarted());
+
+  m_bitmapFd = ::open(m_bitmapPath.c_str(), O_RDWR);
+  if (m_bitmapFd < 0)
+    return false;
+
+  if (!mapBitmap(name.wireEncode(), false)) {
+    unmapBitmap();
+    return false;
+  }
+  return true;
+}
+
+void
+ResumableOutput::start(const Name& name, uint64_t lastSegmentNo)
+{
+  if (isStarted())
+    return;
+
+  if (resume(name) && m_nSegments == lastSegmentNo + 1)
+    return;
+
+  // the sidecar describes another transfer, start over
+  m_nSegments = 0;
+  unmapBitmap();
+
+  m_bitmapFd = ::open(m_bitmapPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_bitmapFd < 0)
+    throw Error("Cannot create " + m_bitmapPath + ": " + std::strerror(errno));
+
+  if (::ftruncate(m_fd, 0) < 0)
+    throw Error(std::string("Cannot truncate the output: ") + std::strerror(errno));
+
+  mapBitmap(name.wireEncode(), true, lastSegmentNo + 1);
+}
+
+bool
+ResumableOutput::mapBitmap(const Block& name, bool isNew, uint64_t nSegments)
+{
+  Header header;
+  if (isNew) {
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.nSegments = nSegments;
+    header.segmentSize = 0;
+    header.lastSegmentSize = 0;
+    header.nameSize = name.size();
+  }
+  else if (::pread(m_bitmapFd, &header, sizeof(header), 0) != sizeof(header) ||
+           std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+           header.nSegments == 0 || header.nameSize != name.size()) {
+    return false;
+  }
+
+  // the bitmap is aligned on 8 bytes after the name
+  size_t bitmapOffset = (sizeof(Header) + header.nameSize + 7) & ~size_t(7);
+  size_t mapSize = bitmapOffset + (header.nSegments + 7) / 8;
+
+  if (isNew && ::ftruncate(m_bitmapFd, static_cast<off_t>(mapSize)) < 0)
+    throw Error("Cannot resize " + m_bitmapPath + ": " + std::strerror(errno));
+
+  struct stat st;
+  if (::fstat(m_bitmapFd, &st) < 0 || static_cast<size_t>(st.st_size) != mapSize)
+    return false;
+
+  void* map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_bitmapFd, 0);
+  if (map == MAP_FAILED)
+    throw Error("Cannot map " + m_bitmapPath + ": " + std::strerror(errno));
+
+  m_map = static_cast<uint8_t*>(map);
+  m_mapSize = mapSize;
+  m_header = reinterpret_cast<Header*>(m_map);
+  m_bitmap = m_map + bitmapOffset;
+
+  if (isNew) {
+    // the bitmap is zero-filled by ftruncate()
+    std::memcpy(m_header, &header, sizeof(header));
+    std::memcpy(m_map + sizeof(Header), name.wire(), name.size());
+  }
+  else if (std::memcmp(m_map + sizeof(Header), name.wire(), name.size()) != 0) {
+    return false;
+  }
+
+  m_nSegments = header.nSegments;
+  m_segmentSize = header.segmentSize;
+  m_lastSegmentSize = header.lastSegmentSize;
+  m_received.assign(m_nSegments, false);
+  m_nReceived = 0;
+  for (uint64_t i = 0; i < m_nSegments; ++i) {
+    if (m_bitmap[i / 8] & (1 << (i % 8))) {
+      m_received[i] = true;
+      ++m_nReceived;
+    }
+  }
+
+  return true;
+}
+
+void
+ResumableOutput::unmapBitmap()
+{
+  if (m_map != nullptr)
+    ::munmap(m_map, m_mapSize);
+  if (m_bitmapFd >= 0)
+    ::close(m_bitmapFd);
+
+  m_bitmapFd = -1;
+  m_map = nullptr;
+  m_mapSize = 0;
+  m_header = nullptr;
+  m_bitmap = nullptr;
+}
+
+std::vector<uint64_t>
+ResumableOutput::getMissingSegments() const
+{
+  std::vector<uint64_t> missing;
+  for (uint64_t i = 0; i < m_nSegments; ++i)
+    if (!m_received[i])
+      missing.push_back(i);
+  return missing;
+}
+
+void
+ResumableOutput::addSegment(const shared_ptr<const Data>& data)
+{
+  BOOST_ASSERT(isStarted());
+
+  uint64_t segmentNo = data->getName()[-1].toSegment();
+  if (segmentNo >= m_nSegments || m_received[segmentNo])
+    return;
+
+  const Block& content = data->getContent();
+  m_received[segmentNo] = true;
+
+  if (segmentNo == m_nSegments - 1) {
+    // the offset of the last segment is known only with the size of the other segments
+    if (m_segmentSize == 0 && m_nSegments > 1) {
+      m_lastSegment = data;
+      return;
+    }
+    m_lastSegmentSize = content.value_size();
+  }
+  else if (m_segmentSize == 0) {
+    m_segmentSize = content.value_size();
+  }
+  else if (content.value_size() != m_segmentSize) {
+    throw Error("Segment #" + to_string(segmentNo) + " has size " +
+                to_string(content.value_size()) + ", expected " + to_string(m_segmentSize));
+  }
+
+  writeSegment(segmentNo, content);
+
+  if (m_lastSegment != nullptr && m_segmentSize != 0) {
+    m_lastSegmentSize = m_lastSegment->getContent().value_size();
+    writeSegment(m_nSegments - 1, m_lastSegment->getContent());
+    m_lastSegment.reset();
+  }
+}
+
+void
+ResumableOutput::writeSegment(uint64_t segmentNo, const Block& content)
+{
+  const uint8_t* buf = content.value();
+  size_t nBytes = content.value_size();
+  off_t offset = static_cast<off_t>(segmentNo * m_segmentSize);
+
+  while (nBytes > 0) {
+    ssize_t n = ::pwrite(m_fd, buf, nBytes, offset);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw Error(std::string("Cannot write the output: ") + std::strerror(errno));
+    }
+
+    buf += n;
+    offset += n;
+    nBytes -= n;
+  }
+
+  ++m_nReceived;
+  m_unsyncedSegments.push_back(segmentNo);
+}
+
+void
+ResumableOutput::sync()
+{
+  if (m_map == nullptr)
+    return;
+
+  if (!m_unsyncedSegments.empty()) {
+    // the segments are marked only once they are on disk
+    if (::fdatasync(m_fd) < 0)
+      throw Error(std::string("Cannot sync the output: ") + std::strerror(errno));
+
+    for (uint64_t segmentNo : m_unsyncedSegments)
+      m_bitmap[segmentNo / 8] |= static_cast<uint8_t>(1 << (segmentNo % 8));
+    m_unsyncedSegments.clear();
+
+    m_header->segmentSize = m_segmentSize;
+    m_header->lastSegmentSize = m_lastSegmentSize;
+
+    if (::msync(m_map, m_mapSize, MS_SYNC) < 0)
+      throw Error("Cannot sync " + m_bitmapPath + ": " + std::strerror(errno));
+  }
+
+  if (isComplete()) {
+    // a previous content may have been longer
+    off_t size = static_cast<off_t>((m_nSegments - 1) * m_segmentSize + m_lastSegmentSize);
+    if (::ftruncate(m_fd, size) < 0)
+      throw Error(std::string("Cannot truncate the output: ") + std::strerror(errno));
+
+    unmapBitmap();
+    ::unlink(m_bitmapPath.c_str());
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
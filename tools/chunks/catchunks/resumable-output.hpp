@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_RESUMABLE_OUTPUT_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_RESUMABLE_OUTPUT_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Output file of a transfer that can be resumed after the process has been stopped
+ *
+ * The content of segment i is written at offset i * segmentSize of a sparse output file. The
+ * received segments are recorded in a bitmap, kept in a memory mapped sidecar file (the output
+ * path followed by ".bitmap") together with the versioned name and the segment size. A segment
+ * is marked in the sidecar only by sync(), after the output has been flushed to disk, so that
+ * every segment marked in the sidecar is on disk. When the transfer is complete, the output is
+ * truncated to the size of the content and the sidecar is removed.
+ */
+class ResumableOutput : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @brief open (or create) the output file at @p path
+   * @throw Error the output cannot be opened
+   */
+  explicit
+  ResumableOutput(const std::string& path);
+
+  /**
+   * @brief sync and close the files
+   */
+  ~ResumableOutput();
+
+  /**
+   * @brief resume the transfer of @p name recorded in the sidecar, if any
+   *
+   * @param name the name of the content, with the version and without the segment number
+   * @return false if the sidecar does not describe a transfer of @p name
+   */
+  bool
+  resume(const Name& name);
+
+  /**
+   * @brief resume the transfer of @p name, or start it over if the sidecar describes another
+   *        transfer or another number of segments
+   *
+   * @throw Error the sidecar cannot be created
+   */
+  void
+  start(const Name& name, uint64_t lastSegmentNo);
+
+  bool
+  isStarted() const
+  {
+    return m_nSegments > 0;
+  }
+
+  uint64_t
+  getLastSegmentNo() const
+  {
+    return m_nSegments - 1;
+  }
+
+  bool
+  hasSegment(uint64_t segmentNo) const
+  {
+    return segmentNo < m_received.size() && m_received[segmentNo];
+  }
+
+  /**
+   * @return the segments that have not been received yet, in increasing order
+   */
+  std::vector<uint64_t>
+  getMissingSegments() const;
+
+  /**
+   * @brief write the content of @p data at its offset, unless it has already been received
+   *
+   * The transfer must have been started. The last segment is kept in memory until the segment size
+   * is known.
+   *
+   * @throw Error the write failed, or a segment that is not the last one has a different size
+   */
+  void
+  addSegment(const shared_ptr<const Data>& data);
+
+  /**
+   * @return true if all the segments have been written
+   */
+  bool
+  isComplete() const
+  {
+    return isStarted() && m_nReceived == m_nSegments;
+  }
+
+  /**
+   * @brief flush the output to disk, then mark the segments written since the last sync in the
+   *        sidecar and flush it
+   *
+   * If the transfer is complete, the output is truncated to the size of the content and the
+   * sidecar is removed.
+   */
+  void
+  sync();
+
+private:
+  struct Header;
+
+  /**
+   * @brief map the sidecar, and initialize it if @p isNew
+   * @return false if the sidecar does not describe a transfer of @p name
+   */
+  bool
+  mapBitmap(const Block& name, bool isNew, uint64_t nSegments = 0);
+
+  void
+  writeSegment(uint64_t segmentNo, const Block& content);
+
+  void
+  unmapBitmap();
+
+private:
+  std::string m_bitmapPath;
+  int m_fd;
+  int m_bitmapFd;
+  uint8_t* m_map; ///< the whole sidecar
+  size_t m_mapSize;
+  Header* m_header;
+  uint8_t* m_bitmap; ///< the bitmap in the sidecar
+
+  uint64_t m_nSegments; ///< 0 until the transfer is started
+  uint64_t m_segmentSize; ///< 0 until a segment that is not the last one has been received
+  std::vector<bool> m_received;
+  uint64_t m_nReceived; ///< segments written to the output
+  std::vector<uint64_t> m_unsyncedSegments;
+  shared_ptr<const Data> m_lastSegment; ///< waiting for the segment size
+  uint64_t m_lastSegmentSize;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_RESUMABLE_OUTPUT_HPP
@@ -33,57 +33,87 @@
 namespace ndn {
 namespace chunks {
 
-RttEstimator::RttEstimator()
-{
-  rttMeanWeight.first = 0.3;  // Old value
-  rttMeanWeight.second = 0.7; // New value
+const size_t RttEstimator::DEFAULT_WINDOW_SIZE;
 
-  rttVarWeight.first = 0.125;  // Old value
-  rttVarWeight.second = 0.875; // New value
+static const float SRTT_GAIN = 0.125; // alpha in RFC 6298
+static const float RTTVAR_GAIN = 0.25; // beta in RFC 6298
 
+RttEstimator::RttEstimator(size_t windowSize, bool useKarnAlgorithm)
+  : m_useKarnAlgorithm(useKarnAlgorithm)
+  , m_samples(std::max<size_t>(windowSize, 1))
+  , m_minQueue(m_samples.size())
+{
   reset();
-
-  m_nSamples = 5;
 }
 
 float
 RttEstimator::addRttMeasurement(const shared_ptr<DataFetcher>& df)
 {
+  if (df->m_transmissionTimes.empty())
+    return -1; // This should not happen
+
+  return addRttMeasurement(df->m_transmissionTimes.front(), df->m_transmissionTimes.back(),
+                           df->m_transmissionTimes.size());
+}
+
+float
+RttEstimator::addRttMeasurement(time::steady_clock::TimePoint firstSendTime,
+                                time::steady_clock::TimePoint lastSendTime, size_t nTransmissions)
+{
+  auto now = time::steady_clock::now();
   float rtt = -1;
-  if (df->m_transmissionTimes.size() == 1) { // No retry
-    rtt = (time::duration_cast<time::milliseconds> (time::steady_clock::now() - df->m_transmissionTimes[0])).count();
-
-    if (m_rttMinCalc == -1) {
-      m_rttMinCalc = rtt;
-      //tracepoint(strategyLog, rtt_min_calc, m_rttMinCalc);
-    }
-    else if (rtt < m_rttMinCalc) {
-      m_rttMinCalc = rtt;
-      //tracepoint(strategyLog, rtt_min_calc, m_rttMinCalc);
-    }
-
-    //NFD_LOG_DEBUG("Rtt min calc: " << m_rttMinCalc);
+  if (nTransmissions == 1) { // No retry
+    rtt = (time::duration_cast<time::milliseconds> (now - firstSendTime)).count();
+    addMinSample(rtt);
   }
-  else if (df->m_transmissionTimes.size() > 1) { // At least 1 retry
-    for (int i = df->m_transmissionTimes.size(); i > 0; i--) {
-      rtt = (time::duration_cast<time::milliseconds> (time::steady_clock::now() - df->m_transmissionTimes[i - 1])).count();
-      if (m_rttMinCalc != -1 && rtt >= m_rttMinCalc)
-        break;
-      else if (m_rttMinCalc == -1 && rtt >= m_rttMin)
-        break;
-    }
+  else if (nTransmissions > 1) { // At least 1 retry
+    if (m_useKarnAlgorithm)
+      return -1;
+
+    rtt = (time::duration_cast<time::milliseconds> (now - lastSendTime)).count();
+
+    float rttMin = getRttMin() != -1 ? getRttMin() : m_rttMin;
+    if (rtt < rttMin)
+      rtt = (time::duration_cast<time::milliseconds> (now - firstSendTime)).count();
   }
   else
     return -1; // This should not happen
-  float rttOriginal = rtt;
 
-  if (m_rttMinCalc == -1 && rtt < m_rttMin) {
-    //tracepoint(strategyLog, rtt_min, rtt);
-    rtt = m_rttMin;
+  return addRttSample(rtt);
+}
+
+void
+RttEstimator::addMinSample(float rtt)
+{
+  uint64_t sampleNo = m_nSamples++;
+  size_t capacity = m_samples.size();
+
+  // the oldest sample leaves the window
+  if (m_minQueueSize > 0 && m_minQueue[m_minQueueBegin] + capacity <= sampleNo) {
+    m_minQueueBegin = (m_minQueueBegin + 1) % capacity;
+    --m_minQueueSize;
   }
-  else if (m_rttMinCalc != -1 && rtt < m_rttMinCalc) {
+
+  m_samples[sampleNo % capacity] = rtt;
+
+  // the samples that are not smaller than the new one can no longer be the minimum
+  while (m_minQueueSize > 0 &&
+         m_samples[m_minQueue[(m_minQueueBegin + m_minQueueSize - 1) % capacity] % capacity] >= rtt)
+    --m_minQueueSize;
+
+  m_minQueue[(m_minQueueBegin + m_minQueueSize) % capacity] = sampleNo;
+  ++m_minQueueSize;
+}
+
+float
+RttEstimator::addRttSample(float rtt)
+{
+  float rttOriginal = rtt;
+
+  float rttMin = getRttMin() != -1 ? getRttMin() : m_rttMin;
+  if (rtt < rttMin) {
     //tracepoint(strategyLog, rtt_min, rtt);
-    rtt = m_rttMinCalc;
+    rtt = rttMin;
   }
 
   if (rtt > m_rttMax) {
@@ -91,26 +121,31 @@ RttEstimator::addRttMeasurement(const shared_ptr<DataFetcher>& df)
     rtt = m_rttMax;
   }
 
-  while (m_oldRtt.size() > m_nSamples) {
-    m_oldRtt.erase(m_oldRtt.begin());
+  // RFC 6298 section 2
+  if (m_rttMean == -1) {
+    m_rttMean = rtt;
+    m_rttVar = rtt / 2;
   }
-  m_oldRtt.push_back(rtt);
-
-  float newMean = m_oldRtt[0];
-  float newVar = m_oldRtt[0] / 2;
-  for(uint32_t i = 1; i < m_oldRtt.size(); i++) {
-    newVar = (newVar * rttVarWeight.first) + (std::abs(m_oldRtt[i] - newMean) * rttVarWeight.second);
-    newMean = (newMean * rttMeanWeight.first) + (m_oldRtt[i] * rttMeanWeight.second);
+  else {
+    m_rttVar = (1 - RTTVAR_GAIN) * m_rttVar + RTTVAR_GAIN * std::abs(m_rttMean - rtt);
+    m_rttMean = (1 - SRTT_GAIN) * m_rttMean + SRTT_GAIN * rtt;
   }
 
   m_lastRtt = rtt;
-  m_rttMean = newMean;
-  m_rttVar = newVar;
-  //m_rtoMulti = 1;
 
   return rttOriginal;
 }
 
+void
+RttEstimator::seed(float rttMean, float rttVar)
+{
+  if (m_rttMean != -1 || rttMean <= 0)
+    return;
+
+  m_rttMean = std::min(std::max(rttMean, m_rttMin), m_rttMax);
+  m_rttVar = rttVar >= 0 ? rttVar : m_rttMean / 2;
+}
+
 float
 RttEstimator::getRTO() const
 {
@@ -132,6 +167,15 @@ RttEstimator::getRttVar() const
   return m_rttVar;
 }
 
+float
+RttEstimator::getRttMin() const
+{
+  if (m_minQueueSize == 0)
+    return -1;
+
+  return m_samples[m_minQueue[m_minQueueBegin] % m_samples.size()];
+}
+
 float
 RttEstimator::incrementRtoMultiplier()
 {
@@ -170,12 +214,12 @@ RttEstimator::reset()
   m_rttMean = -1;
   m_rttVar = -1;
   m_lastRtt = -1;
-  m_rttMulti = 2;
   m_rttMin = 10;
   m_rttMax = 2000;
-  m_rtt0 = 250;
-  m_rttMinCalc = -1;
   m_rtoMulti = 1;
+  m_nSamples = 0;
+  m_minQueueBegin = 0;
+  m_minQueueSize = 0;
 }
 
 
@@ -36,19 +36,66 @@ namespace chunks {
 
 class DataFetcher;
 
+/**
+ * @brief RTT and RTO estimation in the style of RFC 6298
+ *
+ * The smoothed RTT and the RTT variation are updated incrementally with every sample. The last
+ * samples are kept in a ring of fixed capacity, which gives the minimum RTT over a sliding window
+ * in amortized constant time.
+ *
+ * The RTT of a retransmitted segment is ambiguous. In Karn's mode these samples are ignored,
+ * otherwise the last transmission is used unless it would produce a sample below the minimum RTT.
+ */
 class RttEstimator
 {
 public:
-  RttEstimator();
-
+  static const size_t DEFAULT_WINDOW_SIZE = 64;
+
+  /**
+   * @param windowSize number of samples over which the minimum RTT is computed
+   * @param useKarnAlgorithm ignore the samples of the retransmitted segments
+   */
+  explicit
+  RttEstimator(size_t windowSize = DEFAULT_WINDOW_SIZE, bool useKarnAlgorithm = false);
+
+  /**
+   * @return the RTT sample, or -1 if the sample has been ignored
+   */
   float addRttMeasurement(const shared_ptr<DataFetcher>& df);
 
+  /**
+   * @brief add an RTT sample for a segment tracked without a DataFetcher
+   * @return the RTT sample, or -1 if the sample has been ignored
+   */
+  float addRttMeasurement(time::steady_clock::TimePoint firstSendTime,
+                          time::steady_clock::TimePoint lastSendTime, size_t nTransmissions);
+
+  /**
+   * @brief start from the smoothed RTT and RTT variation of a previous retrieval, e.g. from the
+   *        same producer, instead of from the first sample
+   *
+   * Ignored if a sample has already been added or if @p rttMean is not positive. The minimum RTT
+   * is not seeded.
+   */
+  void seed(float rttMean, float rttVar);
+
   float getRTO() const;
 
   float getRttMean() const;
 
   float getRttVar() const;
 
+  /**
+   * @return the minimum RTT among the last samples of the segments that were not retransmitted,
+   *         or -1 if there is no such sample since the last reset
+   */
+  float getRttMin() const;
+
+  size_t getWindowSize() const
+  {
+    return m_samples.size();
+  }
+
   float incrementRtoMultiplier();
 
   float decrementRtoMultiplier();
@@ -57,21 +104,28 @@ public:
 
   void reset();
 
+private:
+  float addRttSample(float rtt);
+
+  /**
+   * @brief add a sample to the ring and to the minimum filter
+   */
+  void addMinSample(float rtt);
+
 private :
   float m_rttMean;
   float m_rttVar;
-  float m_rtt0;
-  float m_rttMulti;
-  float m_rttMax;
-  float m_rttMin;
+  float m_rttMax; ///< upper bound of the samples
+  float m_rttMin; ///< lower bound of the samples while the minimum RTT is unknown
   float m_lastRtt;
-  float m_rttMinCalc;
   float m_rtoMulti;
+  bool m_useKarnAlgorithm;
 
-  std::vector<float> m_oldRtt;
-  uint32_t m_nSamples;
-  std::pair<float /*old*/, float /*new*/> rttMeanWeight;
-  std::pair<float /*old*/, float /*new*/> rttVarWeight;
+  std::vector<float> m_samples; ///< ring of the last samples, sample i is at i % size
+  uint64_t m_nSamples; ///< samples added since the last reset
+  std::vector<uint64_t> m_minQueue; ///< ring of samples with increasing RTT, the first is the minimum
+  size_t m_minQueueBegin;
+  size_t m_minQueueSize;
 };
 
 
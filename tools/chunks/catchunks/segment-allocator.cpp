@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "segment-allocator.hpp"
+#include "pipeline-interests.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace chunks {
+
+SegmentAllocator::SegmentAllocator(boost::asio::io_service& ioService, uint64_t lastSegmentNo,
+                                   uint64_t excludeSegmentNo)
+  : m_ioService(ioService)
+  , m_lastSegmentNo(lastSegmentNo)
+  , m_allocations(lastSegmentNo + 1)
+  , m_nextSegmentNo(0)
+  , m_firstDuplicateCandidate(0)
+  , m_nDuplicated(0)
+  , m_isResumeScheduled(false)
+{
+  if (excludeSegmentNo <= lastSegmentNo)
+    m_allocations[excludeSegmentNo].isReceived = true;
+}
+
+void
+SegmentAllocator::addPipeline(PipelineInterests& pipeline)
+{
+  m_pipelines.push_back(&pipeline);
+}
+
+void
+SegmentAllocator::removePipeline(PipelineInterests& pipeline)
+{
+  m_pipelines.erase(std::remove(m_pipelines.begin(), m_pipelines.end(), &pipeline),
+                    m_pipelines.end());
+  m_idlePipelines.erase(std::remove(m_idlePipelines.begin(), m_idlePipelines.end(), &pipeline),
+                        m_idlePipelines.end());
+}
+
+bool
+SegmentAllocator::allocate(PipelineInterests& pipeline, uint64_t& segmentNo)
+{
+  while (!m_released.empty()) {
+    uint64_t released = m_released.front();
+    m_released.pop_front();
+
+    // the segment may have been received or allocated again in the meantime
+    Allocation& allocation = m_allocations[released];
+    if (!allocation.isReceived && allocation.owner == nullptr) {
+      allocation.owner = &pipeline;
+      segmentNo = released;
+      return true;
+    }
+  }
+
+  while (m_nextSegmentNo <= m_lastSegmentNo) {
+    Allocation& allocation = m_allocations[m_nextSegmentNo++];
+    if (!allocation.isReceived) {
+      allocation.owner = &pipeline;
+      segmentNo = m_nextSegmentNo - 1;
+      return true;
+    }
+  }
+
+  if (duplicate(pipeline, segmentNo))
+    return true;
+
+  if (std::find(m_idlePipelines.begin(), m_idlePipelines.end(), &pipeline) == m_idlePipelines.end())
+    m_idlePipelines.push_back(&pipeline);
+  return false;
+}
+
+bool
+SegmentAllocator::duplicate(PipelineInterests& pipeline, uint64_t& segmentNo)
+{
+  while (m_firstDuplicateCandidate < m_nextSegmentNo) {
+    const Allocation& allocation = m_allocations[m_firstDuplicateCandidate];
+    if (!allocation.isReceived && allocation.duplicate == nullptr)
+      break;
+    ++m_firstDuplicateCandidate;
+  }
+
+  // the segments in flight on the requesting path are skipped, they are at most a window
+  for (uint64_t i = m_firstDuplicateCandidate; i < m_nextSegmentNo; ++i) {
+    Allocation& allocation = m_allocations[i];
+    if (!allocation.isReceived && allocation.duplicate == nullptr &&
+        allocation.owner != nullptr && allocation.owner != &pipeline) {
+      allocation.duplicate = &pipeline;
+      ++m_nDuplicated;
+      segmentNo = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+SegmentAllocator::onReceived(PipelineInterests& pipeline, uint64_t segmentNo)
+{
+  BOOST_ASSERT(segmentNo <= m_lastSegmentNo);
+
+  Allocation& allocation = m_allocations[segmentNo];
+  if (allocation.isReceived)
+    return false;
+
+  PipelineInterests* owner = allocation.owner;
+  PipelineInterests* duplicate = allocation.duplicate;
+  allocation.isReceived = true;
+  allocation.owner = nullptr;
+  allocation.duplicate = nullptr;
+
+  // the allocation is up to date before the other path requests its next segment
+  for (PipelineInterests* other : {owner, duplicate}) {
+    if (other != nullptr && other != &pipeline)
+      other->abandonSegment(segmentNo);
+  }
+
+  return true;
+}
+
+void
+SegmentAllocator::release(PipelineInterests& pipeline, uint64_t segmentNo)
+{
+  BOOST_ASSERT(segmentNo <= m_lastSegmentNo);
+
+  Allocation& allocation = m_allocations[segmentNo];
+  if (allocation.isReceived)
+    return;
+
+  if (allocation.owner == &pipeline) {
+    allocation.owner = allocation.duplicate;
+    allocation.duplicate = nullptr;
+  }
+  else if (allocation.duplicate == &pipeline) {
+    allocation.duplicate = nullptr;
+  }
+  else {
+    return;
+  }
+
+  if (allocation.owner == nullptr)
+    m_released.push_back(segmentNo);
+  else
+    // the segment can be duplicated again
+    m_firstDuplicateCandidate = std::min(m_firstDuplicateCandidate, segmentNo);
+
+  scheduleResume();
+}
+
+void
+SegmentAllocator::scheduleResume()
+{
+  if (m_isResumeScheduled || m_idlePipelines.empty())
+    return;
+
+  m_isResumeScheduled = true;
+  m_ioService.post([this] {
+      m_isResumeScheduled = false;
+
+      std::vector<PipelineInterests*> idlePipelines;
+      idlePipelines.swap(m_idlePipelines);
+      for (PipelineInterests* pipeline : idlePipelines) {
+        // a pipeline resumed before may have been removed
+        if (std::find(m_pipelines.begin(), m_pipelines.end(), pipeline) != m_pipelines.end())
+          pipeline->resumeAllocation();
+      }
+    });
+}
+
+} // namespace chunks
+} // namespace ndn
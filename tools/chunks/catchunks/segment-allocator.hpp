@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_ALLOCATOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_ALLOCATOR_HPP
+
+#include "core/common.hpp"
+
+#include <deque>
+
+namespace ndn {
+namespace chunks {
+
+class PipelineInterests;
+
+/**
+ * @brief Segment space of one object shared by the pipelines that fetch it over several paths
+ *
+ * Each path, i.e. a pipeline bound to its own prefix or Face, keeps its own window and RTT
+ * estimator, and asks the allocator for a segment whenever its window has room. The faster paths
+ * thus request more segments than the slower ones, and the aggregate throughput is the sum of the
+ * throughputs of the paths.
+ *
+ * The segments given up by a path, e.g. because it has failed, are allocated again to the other
+ * paths. Once all the segments have been allocated, an idle path requests again the oldest
+ * segment still in flight on another path: the first copy received is kept and the other one is
+ * abandoned, so that the end of the transfer does not wait for the slowest path.
+ */
+class SegmentAllocator : noncopyable
+{
+public:
+  /**
+   * @param lastSegmentNo the last segment of the object
+   * @param excludeSegmentNo a segment that has already been received, or a value greater than
+   *        @p lastSegmentNo
+   */
+  SegmentAllocator(boost::asio::io_service& ioService, uint64_t lastSegmentNo,
+                   uint64_t excludeSegmentNo);
+
+  void
+  addPipeline(PipelineInterests& pipeline);
+
+  /**
+   * @brief stop allocating segments to @p pipeline
+   *
+   * The segments in flight on @p pipeline must be released by the pipeline.
+   */
+  void
+  removePipeline(PipelineInterests& pipeline);
+
+  /**
+   * @brief allocate a segment to @p pipeline
+   *
+   * @return false if there is no segment left for @p pipeline, the pipeline is then resumed
+   *         with PipelineInterests::resumeAllocation when another path releases a segment
+   */
+  bool
+  allocate(PipelineInterests& pipeline, uint64_t& segmentNo);
+
+  /**
+   * @brief @p pipeline has received @p segmentNo, the copy requested by another path if any is
+   *        abandoned
+   *
+   * @return false if the segment had already been received over another path
+   */
+  bool
+  onReceived(PipelineInterests& pipeline, uint64_t segmentNo);
+
+  /**
+   * @brief @p pipeline has given up @p segmentNo, which is allocated again unless it is still
+   *        requested by another path
+   */
+  void
+  release(PipelineInterests& pipeline, uint64_t segmentNo);
+
+  uint64_t
+  getLastSegmentNo() const
+  {
+    return m_lastSegmentNo;
+  }
+
+  size_t
+  getNPipelines() const
+  {
+    return m_pipelines.size();
+  }
+
+  /**
+   * @brief number of segments that have been requested over a second path
+   */
+  uint64_t
+  getNDuplicated() const
+  {
+    return m_nDuplicated;
+  }
+
+private:
+  /**
+   * @brief allocate to @p pipeline the oldest segment in flight on a single other path
+   */
+  bool
+  duplicate(PipelineInterests& pipeline, uint64_t& segmentNo);
+
+  /**
+   * @brief resume the idle pipelines once the caller has returned
+   */
+  void
+  scheduleResume();
+
+private:
+  struct Allocation
+  {
+    PipelineInterests* owner = nullptr;
+    PipelineInterests* duplicate = nullptr; ///< second path requesting the segment, if any
+    bool isReceived = false;
+  };
+
+  boost::asio::io_service& m_ioService;
+  const uint64_t m_lastSegmentNo;
+  std::vector<Allocation> m_allocations; ///< indexed by segment number
+  uint64_t m_nextSegmentNo; ///< first segment that has never been allocated
+  uint64_t m_firstDuplicateCandidate; ///< the segments before it are received or duplicated
+  std::deque<uint64_t> m_released; ///< segments to allocate again, in release order
+  std::vector<PipelineInterests*> m_pipelines;
+  std::vector<PipelineInterests*> m_idlePipelines;
+  uint64_t m_nDuplicated;
+  bool m_isResumeScheduled;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_ALLOCATOR_HPP
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+
+#include "segment-writer.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief maximum number of segments flushed with a single writev() call
+ */
+static const int MAX_IOVECS = 64;
+
+SegmentWriter::SegmentWriter(int fd, size_t capacity)
+  : m_fd(fd)
+  , m_isRegularFile(false)
+  , m_nextSegmentNo(0)
+  , m_nextOffset(0)
+  , m_segmentSize(0)
+  , m_nWrittenBytes(0)
+{
+  size_t ringSize = 1;
+  while (ringSize < capacity)
+    ringSize <<= 1;
+  m_ring.resize(ringSize);
+
+  // positional writes are not possible on pipes and terminals, and are ignored by files opened
+  // in append mode
+  struct stat st;
+  if (::fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode) && (::fcntl(m_fd, F_GETFL) & O_APPEND) == 0) {
+    off_t offset = ::lseek(m_fd, 0, SEEK_CUR);
+    if (offset >= 0) {
+      m_isRegularFile = true;
+      m_nextOffset = static_cast<uint64_t>(offset);
+    }
+  }
+}
+
+void
+SegmentWriter::addSegment(const shared_ptr<const Data>& data)
+{
+  uint64_t segmentNo = data->getName()[-1].toSegment();
+  if (segmentNo < m_nextSegmentNo)
+    return;
+
+  if (segmentNo >= m_nextSegmentNo + m_ring.size())
+    grow(segmentNo);
+
+  Slot& slot = getSlot(segmentNo);
+  if (slot.data != nullptr)
+    return;
+
+  slot.data = data;
+  slot.isWritten = false;
+
+  const Block& content = data->getContent();
+
+  if (m_segmentSize == 0 && !isLastSegment(*data, segmentNo) && content.value_size() > 0) {
+    m_segmentSize = content.value_size();
+
+    // the segments buffered so far can now be written at their offset
+    for (uint64_t i = m_nextSegmentNo + 1; m_isRegularFile && i < m_nextSegmentNo + m_ring.size(); ++i) {
+      Slot& buffered = getSlot(i);
+      if (buffered.data != nullptr && i != segmentNo) {
+        checkSegmentSize(*buffered.data, i);
+        writeAt(buffered.data->getContent(), m_nextOffset + (i - m_nextSegmentNo) * m_segmentSize);
+        buffered.isWritten = true;
+      }
+    }
+  }
+  else if (m_isRegularFile && m_segmentSize != 0) {
+    checkSegmentSize(*data, segmentNo);
+  }
+
+  if (segmentNo == m_nextSegmentNo) {
+    flushInOrder();
+  }
+  else if (m_isRegularFile && m_segmentSize != 0) {
+    writeAt(content, m_nextOffset + (segmentNo - m_nextSegmentNo) * m_segmentSize);
+    slot.isWritten = true;
+  }
+}
+
+bool
+SegmentWriter::isLastSegment(const Data& data, uint64_t segmentNo)
+{
+  return !data.getFinalBlockId().empty() && data.getFinalBlockId().toSegment() == segmentNo;
+}
+
+void
+SegmentWriter::checkSegmentSize(const Data& data, uint64_t segmentNo) const
+{
+  // the offset of a segment is computed from the segment size, which is only correct if all the
+  // segments before the last one have exactly that size
+  size_t size = data.getContent().value_size();
+  if (size != m_segmentSize && !isLastSegment(data, segmentNo)) {
+    throw Error("Segment #" + to_string(segmentNo) + " has size " +
+                to_string(size) + ", expected " + to_string(m_segmentSize));
+  }
+}
+
+void
+SegmentWriter::grow(uint64_t segmentNo)
+{
+  size_t newSize = m_ring.size();
+  while (segmentNo >= m_nextSegmentNo + newSize)
+    newSize <<= 1;
+
+  std::vector<Slot> newRing(newSize);
+  for (uint64_t i = m_nextSegmentNo; i < m_nextSegmentNo + m_ring.size(); ++i)
+    newRing[i & (newSize - 1)] = std::move(getSlot(i));
+
+  m_ring.swap(newRing);
+}
+
+void
+SegmentWriter::flushInOrder()
+{
+  struct iovec iov[MAX_IOVECS];
+
+  while (getSlot(m_nextSegmentNo).data != nullptr) {
+    uint64_t runStart = m_nextSegmentNo;
+    int iovcnt = 0;
+    size_t nBytes = 0;
+
+    // the run must not wrap around the ring, the slots of the run are released only after the
+    // write, hence the slot following the run would still hold its first segment
+    for (; iovcnt < MAX_IOVECS && m_nextSegmentNo - runStart < m_ring.size(); ++m_nextSegmentNo) {
+      Slot& slot = getSlot(m_nextSegmentNo);
+      if (slot.data == nullptr || slot.isWritten)
+        break;
+
+      const Block& content = slot.data->getContent();
+      iov[iovcnt].iov_base = const_cast<uint8_t*>(content.value());
+      iov[iovcnt].iov_len = content.value_size();
+      nBytes += content.value_size();
+      ++iovcnt;
+    }
+
+    if (nBytes > 0) {
+      if (m_isRegularFile && ::lseek(m_fd, static_cast<off_t>(m_nextOffset), SEEK_SET) < 0)
+        throw Error(std::string("Cannot seek the output: ") + std::strerror(errno));
+
+      writeAll(iov, iovcnt, nBytes);
+    }
+    m_nextOffset += nBytes;
+
+    // the iovecs point to the content of the segments, release them only after the write
+    for (uint64_t i = runStart; i < m_nextSegmentNo; ++i)
+      getSlot(i).data.reset();
+
+    // skip the segments that have already been written at their offset
+    for (Slot* slot = &getSlot(m_nextSegmentNo); slot->data != nullptr && slot->isWritten;
+         slot = &getSlot(++m_nextSegmentNo)) {
+      m_nextOffset += slot->data->getContent().value_size();
+      slot->data.reset();
+      slot->isWritten = false;
+    }
+  }
+}
+
+void
+SegmentWriter::writeAll(struct iovec* iov, int iovcnt, size_t nBytes)
+{
+  while (nBytes > 0) {
+    ssize_t n = ::writev(m_fd, iov, iovcnt);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw Error(std::string("Cannot write the output: ") + std::strerror(errno));
+    }
+
+    nBytes -= n;
+    m_nWrittenBytes += n;
+
+    // partial write, skip what has been written
+    size_t written = static_cast<size_t>(n);
+    while (iovcnt > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      ++iov;
+      --iovcnt;
+    }
+    if (written > 0) {
+      iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+}
+
+void
+SegmentWriter::writeAt(const Block& content, uint64_t offset)
+{
+  const uint8_t* buf = content.value();
+  size_t nBytes = content.value_size();
+
+  while (nBytes > 0) {
+    ssize_t n = ::pwrite(m_fd, buf, nBytes, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw Error(std::string("Cannot write the output: ") + std::strerror(errno));
+    }
+
+    buf += n;
+    offset += n;
+    nBytes -= n;
+    m_nWrittenBytes += n;
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
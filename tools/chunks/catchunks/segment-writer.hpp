@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_WRITER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_WRITER_HPP
+
+#include "core/common.hpp"
+
+struct iovec;
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Writes the content of the retrieved segments to a file descriptor without copying it
+ *
+ * The segments are kept in a ring indexed by segment number. Every contiguous run of segments
+ * starting from the next segment to write is flushed with writev(), using iovecs that point
+ * directly to the value of each Content TLV.
+ *
+ * When the output is a regular file and the segment size is known (i.e. a segment that is not the
+ * last one has been received), the segments received out of order are written immediately at
+ * their final offset with pwrite().
+ */
+class SegmentWriter : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @param fd the output file descriptor, it is not closed by the SegmentWriter
+   * @param capacity the initial number of slots in the ring, it grows when a segment is too far
+   *        ahead of the next segment to write
+   */
+  explicit
+  SegmentWriter(int fd, size_t capacity = 1024);
+
+  /**
+   * @brief add a segment and write every segment that can be written
+   *
+   * Segments that have already been added are ignored.
+   *
+   * @throw Error the write failed, or the output is a regular file and a segment that is not the
+   *        last one has a different size than the others (including an empty segment)
+   */
+  void
+  addSegment(const shared_ptr<const Data>& data);
+
+  /**
+   * @return the number of segments that have been written in order
+   */
+  uint64_t
+  getNextSegmentNo() const
+  {
+    return m_nextSegmentNo;
+  }
+
+  /**
+   * @return the number of bytes written to the output
+   */
+  uint64_t
+  getWrittenBytes() const
+  {
+    return m_nWrittenBytes;
+  }
+
+  bool
+  isRegularFile() const
+  {
+    return m_isRegularFile;
+  }
+
+private:
+  struct Slot
+  {
+    shared_ptr<const Data> data;
+    bool isWritten = false; ///< the content has already been written at its final offset
+  };
+
+  Slot&
+  getSlot(uint64_t segmentNo)
+  {
+    return m_ring[segmentNo & (m_ring.size() - 1)];
+  }
+
+  static bool
+  isLastSegment(const Data& data, uint64_t segmentNo);
+
+  /**
+   * @throw Error the segment is not the last one and its size differs from m_segmentSize
+   */
+  void
+  checkSegmentSize(const Data& data, uint64_t segmentNo) const;
+
+  void
+  grow(uint64_t segmentNo);
+
+  /**
+   * @brief write the contiguous run of segments starting from m_nextSegmentNo
+   */
+  void
+  flushInOrder();
+
+  void
+  writeAll(struct iovec* iov, int iovcnt, size_t nBytes);
+
+  void
+  writeAt(const Block& content, uint64_t offset);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::vector<Slot> m_ring;
+
+private:
+  int m_fd;
+  bool m_isRegularFile;
+  uint64_t m_nextSegmentNo;
+  uint64_t m_nextOffset;
+  uint64_t m_segmentSize; ///< 0 until a segment that is not the last one has been received
+  uint64_t m_nWrittenBytes;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_WRITER_HPP
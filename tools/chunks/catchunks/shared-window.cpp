@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "shared-window.hpp"
+#include "congestion-control.hpp"
+#include "telemetry-log.hpp"
+
+#include "../chunks-tracepoint.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace chunks {
+
+SharedWindow::SharedWindow(boost::asio::io_service& ioService,
+                           const PipelineInterestsOptions& options)
+  : rttEstimator(options.rttWindowSize, options.useKarnAlgorithm)
+  , m_ioService(ioService)
+  , m_options(options)
+  , m_nInFlight(0)
+  , m_windowSize(m_options.startPipelineSize)
+  , m_lastWindowSize(m_options.startPipelineSize)
+  , m_nMissingWindowEvents(m_options.startPipelineSize)
+  , m_isWindowCut(false)
+  , m_hasMultiplierChanged(false)
+  , m_isDispatchScheduled(false)
+  , m_congestionControl(CongestionControl::create(m_options.congestionControl, m_options, rttEstimator))
+{
+  BOOST_ASSERT(m_options.maxPipelineSize >= m_options.startPipelineSize);
+
+  if (m_congestionControl == nullptr)
+    throw std::invalid_argument("Unknown congestion control: " + m_options.congestionControl);
+}
+
+SharedWindow::~SharedWindow() = default;
+
+void
+SharedWindow::addPipeline(PipelineInterests& pipeline)
+{
+  m_pipelines.push_back(&pipeline);
+  dispatch();
+}
+
+void
+SharedWindow::removePipeline(PipelineInterests& pipeline)
+{
+  m_pipelines.erase(std::remove(m_pipelines.begin(), m_pipelines.end(), &pipeline),
+                    m_pipelines.end());
+}
+
+void
+SharedWindow::onData()
+{
+  BOOST_ASSERT(m_nInFlight > 0);
+  --m_nInFlight;
+
+  if (!m_hasMultiplierChanged && m_options.rtoMultiplierReset) {
+    rttEstimator.decrementRtoMultiplier();
+    m_hasMultiplierChanged = true;
+  }
+
+  setWindowSize(m_congestionControl->onData(m_windowSize, m_lastWindowSize));
+  handleWindowEvent();
+  dispatch();
+}
+
+void
+SharedWindow::onLoss()
+{
+  if (!m_hasMultiplierChanged) {
+    rttEstimator.incrementRtoMultiplier();
+    m_hasMultiplierChanged = true;
+  }
+
+  if (!m_isWindowCut) {
+    float lastWindowSize = m_lastWindowSize;
+
+    setWindowSize(m_congestionControl->onLoss(m_windowSize, m_lastWindowSize));
+    m_isWindowCut = true;
+
+    rttEstimator.incrementRtoMultiplier();
+    tracepoint(chunksLog, window_decrease, lastWindowSize, rttEstimator.getRtoMultiplier());
+  }
+
+  handleWindowEvent();
+}
+
+void
+SharedWindow::release(size_t nSlots)
+{
+  BOOST_ASSERT(m_nInFlight >= nSlots);
+  m_nInFlight -= nSlots;
+  scheduleDispatch();
+}
+
+void
+SharedWindow::dispatch()
+{
+  while (m_nInFlight < m_windowSize && !m_pipelines.empty()) {
+    PipelineInterests* pipeline = m_pipelines.front();
+    m_pipelines.pop_front();
+
+    // a pipeline that has requested all its segments leaves the rotation
+    if (pipeline->sendNextSharedInterest()) {
+      ++m_nInFlight;
+      m_pipelines.push_back(pipeline);
+    }
+  }
+}
+
+void
+SharedWindow::scheduleDispatch()
+{
+  if (m_isDispatchScheduled)
+    return;
+
+  m_isDispatchScheduled = true;
+  m_ioService.post([this] {
+      m_isDispatchScheduled = false;
+      dispatch();
+    });
+}
+
+void
+SharedWindow::setWindowSize(float size)
+{
+  m_windowSize = std::min<float>(std::max<float>(size, m_options.startPipelineSize),
+                                 m_options.maxPipelineSize);
+
+  tracepoint(chunksLog, window, m_windowSize);
+  if (m_options.telemetryLog != nullptr)
+    m_options.telemetryLog->record(TelemetryEvent::WindowChange, 0, m_windowSize);
+}
+
+void
+SharedWindow::handleWindowEvent()
+{
+  if (--m_nMissingWindowEvents > 0)
+    return;
+
+  m_hasMultiplierChanged = false;
+  m_isWindowCut = false;
+  m_nMissingWindowEvents = std::max<size_t>(m_windowSize, 1);
+  m_lastWindowSize = m_windowSize;
+
+  m_congestionControl->onRoundEnd(m_windowSize);
+}
+
+} // namespace chunks
+} // namespace ndn
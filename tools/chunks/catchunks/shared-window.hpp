@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_SHARED_WINDOW_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_SHARED_WINDOW_HPP
+
+#include "pipeline-interests.hpp"
+
+#include <deque>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Interest window shared by the pipelines that fetch several objects over one Face
+ *
+ * The congestion window, the congestion control and the RTT estimation are global: the pipelines
+ * of the objects do not have a window of their own, a pipeline sends an Interest only when the
+ * shared window grants it a slot. The free slots are granted to the pipelines in round robin, so
+ * that the objects share the bandwidth fairly. A slot is held from the first transmission of a
+ * segment until the segment is received, cancelled or fails, the retransmissions do not need a
+ * new slot.
+ *
+ * The pipelines must be in segment table mode.
+ */
+class SharedWindow : noncopyable
+{
+public:
+  /**
+   * @throw std::invalid_argument the congestion control in @p options is unknown
+   */
+  SharedWindow(boost::asio::io_service& ioService, const PipelineInterestsOptions& options);
+
+  ~SharedWindow();
+
+  /**
+   * @brief add @p pipeline to the pipelines that are granted the free slots
+   */
+  void
+  addPipeline(PipelineInterests& pipeline);
+
+  /**
+   * @brief stop granting slots to @p pipeline
+   */
+  void
+  removePipeline(PipelineInterests& pipeline);
+
+  /**
+   * @brief a segment has been received, its slot is free
+   */
+  void
+  onData();
+
+  /**
+   * @brief a segment has been lost, it keeps its slot for the retransmission
+   */
+  void
+  onLoss();
+
+  /**
+   * @brief free the slots of @p nSlots segments that have been cancelled or have failed
+   *
+   * The slots are granted again after the caller returns, as the caller may be iterating over
+   * its segments.
+   */
+  void
+  release(size_t nSlots);
+
+  float
+  getWindowSize() const
+  {
+    return m_windowSize;
+  }
+
+  size_t
+  getNInFlight() const
+  {
+    return m_nInFlight;
+  }
+
+private:
+  /**
+   * @brief grant the free slots to the pipelines that have segments to request
+   */
+  void
+  dispatch();
+
+  void
+  scheduleDispatch();
+
+  void
+  setWindowSize(float size);
+
+  void
+  handleWindowEvent();
+
+public:
+  RttEstimator rttEstimator;
+
+private:
+  boost::asio::io_service& m_ioService;
+  const PipelineInterestsOptions m_options;
+  std::deque<PipelineInterests*> m_pipelines; ///< in round robin order
+  size_t m_nInFlight;
+  float m_windowSize;
+  float m_lastWindowSize;
+  size_t m_nMissingWindowEvents;
+  bool m_isWindowCut;
+  bool m_hasMultiplierChanged;
+  bool m_isDispatchScheduled;
+  unique_ptr<CongestionControl> m_congestionControl;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_SHARED_WINDOW_HPP
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "telemetry-log.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+static const char MAGIC[8] = {'N', 'D', 'N', 'C', 'T', 'L', 'O', 'G'};
+static const uint32_t VERSION = 1;
+
+const size_t TelemetryLog::DEFAULT_CAPACITY = 1 << 20;
+
+std::ostream&
+operator<<(std::ostream& os, TelemetryEvent event)
+{
+  switch (event) {
+    case TelemetryEvent::InterestSent:
+      return os << "interest_sent";
+    case TelemetryEvent::DataReceived:
+      return os << "data_received";
+    case TelemetryEvent::Timeout:
+      return os << "timeout";
+    case TelemetryEvent::Nack:
+      return os << "nack";
+    case TelemetryEvent::WindowChange:
+      return os << "window";
+  }
+  return os << static_cast<int>(event);
+}
+
+TelemetryLog::TelemetryLog(const std::string& path, size_t capacity)
+  : m_fd(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644))
+  , m_map(nullptr)
+  , m_mapSize(0)
+  , m_mask(0)
+  , m_nRecords(0)
+  , m_startTime(time::steady_clock::now())
+{
+  if (m_fd < 0)
+    throw Error("Cannot create " + path + ": " + std::strerror(errno));
+
+  size_t roundedCapacity = 1;
+  while (roundedCapacity < capacity)
+    roundedCapacity <<= 1;
+  m_mask = roundedCapacity - 1;
+
+  m_mapSize = sizeof(Header) + roundedCapacity * sizeof(TelemetryRecord);
+  if (::ftruncate(m_fd, m_mapSize) < 0) {
+    ::close(m_fd);
+    throw Error("Cannot resize " + path + ": " + std::strerror(errno));
+  }
+
+  void* map = ::mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (map == MAP_FAILED) {
+    ::close(m_fd);
+    throw Error("Cannot map " + path + ": " + std::strerror(errno));
+  }
+  m_map = static_cast<uint8_t*>(map);
+  m_header = reinterpret_cast<Header*>(m_map);
+  m_records = reinterpret_cast<TelemetryRecord*>(m_map + sizeof(Header));
+
+  std::memset(m_header, 0, sizeof(Header));
+  std::memcpy(m_header->magic, MAGIC, sizeof(MAGIC));
+  m_header->version = VERSION;
+  m_header->recordSize = sizeof(TelemetryRecord);
+  m_header->capacity = roundedCapacity;
+  m_header->startTime = time::duration_cast<time::nanoseconds>(
+                          time::system_clock::now().time_since_epoch()).count();
+}
+
+TelemetryLog::~TelemetryLog()
+{
+  // the kernel writes back the dirty pages of the mapping after it is removed
+  ::munmap(m_map, m_mapSize);
+  ::close(m_fd);
+}
+
+void
+TelemetryLog::decode(const std::string& path, std::ostream& os)
+{
+  std::ifstream is(path, std::ios::binary);
+  if (!is)
+    throw Error("Cannot open " + path);
+
+  Header header;
+  if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    throw Error(path + " is not a telemetry log");
+
+  if (header.version != VERSION || header.recordSize != sizeof(TelemetryRecord) ||
+      header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0)
+    throw Error(path + " has an unsupported format");
+
+  // once the ring has wrapped around, the oldest record follows the newest one
+  uint64_t nRecords = std::min(header.nRecords, header.capacity);
+  uint64_t first = header.nRecords - nRecords;
+
+  std::vector<TelemetryRecord> records(header.capacity);
+  if (!is.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TelemetryRecord)))
+    throw Error(path + " is truncated");
+
+  os << "time,event,segment,value\n";
+  os << std::fixed;
+  for (uint64_t i = first; i < first + nRecords; ++i) {
+    const TelemetryRecord& record = records[i & (header.capacity - 1)];
+    auto event = static_cast<TelemetryEvent>(record.event);
+
+    os << std::setprecision(9) << record.time / 1e9 << ',' << event << ',';
+    if (event != TelemetryEvent::WindowChange)
+      os << record.segmentNo;
+    os << ',';
+
+    if (event == TelemetryEvent::Nack)
+      os << static_cast<lp::NackReason>(static_cast<int>(record.value));
+    else
+      os << std::setprecision(3) << record.value;
+    os << '\n';
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_LOG_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_LOG_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief event recorded in the telemetry log
+ */
+enum class TelemetryEvent : uint8_t {
+  InterestSent = 1, ///< value: Interest lifetime in milliseconds
+  DataReceived,     ///< value: RTT in milliseconds, measured from the last transmission
+  Timeout,          ///< value: number of transmissions of the segment
+  Nack,             ///< value: Nack reason
+  WindowChange      ///< value: window size, no segment number
+};
+
+std::ostream&
+operator<<(std::ostream& os, TelemetryEvent event);
+
+/**
+ * @brief fixed-size record of the telemetry log
+ */
+struct TelemetryRecord
+{
+  uint64_t time; ///< nanoseconds since the creation of the log
+  uint64_t segmentNo;
+  float value; ///< depends on the event
+  uint8_t event; ///< TelemetryEvent
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(TelemetryRecord) == 24, "TelemetryRecord must not be padded");
+
+/**
+ * @brief Binary log of the pipeline events, always on
+ *
+ * The records are appended to a ring in a memory mapped file: recording an event is a few stores
+ * into the mapping, without any system call or formatting, and the kernel writes the pages back
+ * to the file. When the ring is full, the oldest records are overwritten. The file can be
+ * converted to CSV with decode(), also while it is being written.
+ *
+ * The log is not thread-safe, the events must be recorded from a single thread.
+ */
+class TelemetryLog : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  static const size_t DEFAULT_CAPACITY;
+
+  /**
+   * @brief create the log file at @p path, replacing any existing file
+   *
+   * @param capacity the number of records in the ring, rounded up to a power of 2
+   * @throw Error the file cannot be created or mapped
+   */
+  explicit
+  TelemetryLog(const std::string& path, size_t capacity = DEFAULT_CAPACITY);
+
+  ~TelemetryLog();
+
+  void
+  record(TelemetryEvent event, uint64_t segmentNo, float value,
+         const time::steady_clock::TimePoint& now)
+  {
+    TelemetryRecord& record = m_records[m_nRecords & m_mask];
+    record.time = time::duration_cast<time::nanoseconds>(now - m_startTime).count();
+    record.segmentNo = segmentNo;
+    record.value = value;
+    record.event = static_cast<uint8_t>(event);
+
+    // a reader sees the record once the counter includes it
+    m_header->nRecords = ++m_nRecords;
+  }
+
+  void
+  record(TelemetryEvent event, uint64_t segmentNo, float value)
+  {
+    record(event, segmentNo, value, time::steady_clock::now());
+  }
+
+  /**
+   * @return the number of records appended since the creation of the log, including the
+   *         overwritten ones
+   */
+  uint64_t
+  getNRecords() const
+  {
+    return m_nRecords;
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_mask + 1;
+  }
+
+  /**
+   * @brief write the records of the log file at @p path to @p os as CSV, oldest first
+   *
+   * @throw Error the file cannot be read or is not a telemetry log
+   */
+  static void
+  decode(const std::string& path, std::ostream& os);
+
+private:
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    uint64_t startTime; ///< system time at the creation of the log, in nanoseconds since the epoch
+    uint64_t nRecords;
+    uint64_t reserved[3];
+  };
+
+  int m_fd;
+  uint8_t* m_map;
+  size_t m_mapSize;
+  Header* m_header;
+  TelemetryRecord* m_records;
+  uint64_t m_mask;
+  uint64_t m_nRecords;
+  time::steady_clock::TimePoint m_startTime;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_LOG_HPP
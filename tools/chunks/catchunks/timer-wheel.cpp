@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "timer-wheel.hpp"
+
+namespace ndn {
+namespace chunks {
+
+const TimerWheel::TimerId TimerWheel::INVALID_TIMER = std::numeric_limits<TimerId>::max();
+
+TimerWheel::TimerWheel(const time::nanoseconds& tick)
+  : m_tick(tick)
+  , m_start(time::steady_clock::now())
+  , m_currentTick(0)
+  , m_freeList(INVALID_TIMER)
+  , m_slots(2 * N_SLOTS_PER_LEVEL, INVALID_TIMER)
+  , m_nTimers(0)
+{
+  BOOST_ASSERT(tick > time::nanoseconds::zero());
+}
+
+uint64_t
+TimerWheel::toTick(const time::steady_clock::TimePoint& t, bool roundUp) const
+{
+  if (t <= m_start)
+    return 0;
+
+  if (roundUp)
+    return (t - m_start + m_tick - time::nanoseconds(1)) / m_tick;
+  else
+    return (t - m_start) / m_tick;
+}
+
+TimerWheel::TimerId
+TimerWheel::add(const time::steady_clock::TimePoint& expiry, uint64_t key)
+{
+  TimerId id = m_freeList;
+  if (id != INVALID_TIMER) {
+    m_freeList = m_nodes[id].next;
+  }
+  else {
+    id = static_cast<TimerId>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+
+  // the wheel does not move while it is empty
+  if (m_nTimers == 0)
+    m_currentTick = std::max(m_currentTick, toTick(time::steady_clock::now(), false));
+
+  Node& node = m_nodes[id];
+  node.key = key;
+  // a timer never expires before its expiry
+  node.expiryTick = toTick(expiry, true);
+  node.isActive = true;
+  insert(id);
+
+  ++m_nTimers;
+  return id;
+}
+
+void
+TimerWheel::cancel(TimerId id)
+{
+  if (id >= m_nodes.size() || !m_nodes[id].isActive)
+    return;
+
+  unlink(id);
+  release(id);
+}
+
+void
+TimerWheel::insert(TimerId id)
+{
+  Node& node = m_nodes[id];
+  uint64_t expiryTick = std::max(node.expiryTick, m_currentTick + 1);
+  uint64_t delta = expiryTick - m_currentTick;
+
+  // a first level slot is visited again N_SLOTS_PER_LEVEL ticks after the current tick
+  if (delta <= N_SLOTS_PER_LEVEL) {
+    node.slot = expiryTick % N_SLOTS_PER_LEVEL;
+  }
+  else {
+    uint64_t high = expiryTick >> LEVEL_SHIFT;
+    uint64_t currentHigh = m_currentTick >> LEVEL_SHIFT;
+    if (high - currentHigh >= N_SLOTS_PER_LEVEL)
+      high = currentHigh + N_SLOTS_PER_LEVEL - 1; // out of range, moved again later
+    node.slot = N_SLOTS_PER_LEVEL + high % N_SLOTS_PER_LEVEL;
+  }
+
+  TimerId& head = m_slots[node.slot];
+  node.prev = INVALID_TIMER;
+  node.next = head;
+  if (head != INVALID_TIMER)
+    m_nodes[head].prev = id;
+  head = id;
+}
+
+void
+TimerWheel::unlink(TimerId id)
+{
+  Node& node = m_nodes[id];
+  if (node.prev != INVALID_TIMER)
+    m_nodes[node.prev].next = node.next;
+  else
+    m_slots[node.slot] = node.next;
+
+  if (node.next != INVALID_TIMER)
+    m_nodes[node.next].prev = node.prev;
+}
+
+TimerWheel::TimerId
+TimerWheel::detachSlot(size_t slot)
+{
+  TimerId first = m_slots[slot];
+  m_slots[slot] = INVALID_TIMER;
+  return first;
+}
+
+void
+TimerWheel::release(TimerId id)
+{
+  Node& node = m_nodes[id];
+  node.isActive = false;
+  node.next = m_freeList;
+  m_freeList = id;
+  --m_nTimers;
+}
+
+void
+TimerWheel::advance(const time::steady_clock::TimePoint& now, const ExpireCallback& expire)
+{
+  uint64_t nowTick = toTick(now, false);
+
+  while (m_currentTick < nowTick && m_nTimers > 0) {
+    uint64_t tick = m_currentTick + 1;
+
+    // move the timers of the second level slot that starts at this tick, while the current tick
+    // is still the previous one so that the timers of this tick go to the first level
+    if (tick % N_SLOTS_PER_LEVEL == 0) {
+      TimerId id = detachSlot(N_SLOTS_PER_LEVEL + (tick >> LEVEL_SHIFT) % N_SLOTS_PER_LEVEL);
+      while (id != INVALID_TIMER) {
+        TimerId next = m_nodes[id].next;
+        insert(id);
+        id = next;
+      }
+    }
+
+    m_currentTick = tick;
+
+    // release all the expired nodes before invoking the callbacks, which can add timers
+    std::vector<uint64_t> expired;
+    TimerId id = detachSlot(m_currentTick % N_SLOTS_PER_LEVEL);
+    while (id != INVALID_TIMER) {
+      TimerId next = m_nodes[id].next;
+      expired.push_back(m_nodes[id].key);
+      release(id);
+      id = next;
+    }
+
+    for (uint64_t key : expired)
+      expire(key);
+  }
+
+  if (m_nTimers == 0 && m_currentTick < nowTick)
+    m_currentTick = nowTick;
+}
+
+time::steady_clock::TimePoint
+TimerWheel::getNextExpiry() const
+{
+  BOOST_ASSERT(!empty());
+
+  // the first level covers the ticks up to the next move of a second level slot
+  uint64_t tick = m_currentTick + 1;
+  while (tick % N_SLOTS_PER_LEVEL != 0 && m_slots[tick % N_SLOTS_PER_LEVEL] == INVALID_TIMER)
+    ++tick;
+
+  return m_start + m_tick * tick;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_TIMER_WHEEL_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_TIMER_WHEEL_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Hierarchical timer wheel holding the retransmission timers of all the segments
+ *
+ * The first level has one slot per tick for the next 256 ticks, the second level has one slot
+ * per 256 ticks for the next 65536 ticks. The timers of a second level slot are moved to the
+ * first level when the wheel reaches the slot. Timers further than the second level are kept
+ * in its farthest slot and moved again until they are within range.
+ *
+ * Adding and cancelling a timer is O(1) and does not allocate once the node pool is large
+ * enough for all the outstanding timers. The wheel is not bound to a scheduler: its owner calls
+ * advance() when the next expiry (see getNextExpiry()) is reached.
+ */
+class TimerWheel : noncopyable
+{
+public:
+  typedef uint32_t TimerId;
+  typedef function<void(uint64_t key)> ExpireCallback;
+
+  static const TimerId INVALID_TIMER;
+
+  explicit
+  TimerWheel(const time::nanoseconds& tick = time::milliseconds(1));
+
+  /**
+   * @brief add a timer that expires at @p expiry
+   * @param key the value passed to the expire callback
+   */
+  TimerId
+  add(const time::steady_clock::TimePoint& expiry, uint64_t key);
+
+  /**
+   * @brief cancel a timer that has not expired yet
+   */
+  void
+  cancel(TimerId id);
+
+  /**
+   * @brief expire all the timers up to @p now
+   *
+   * A timer added by @p expire with an expiry up to @p now expires at the next advance().
+   */
+  void
+  advance(const time::steady_clock::TimePoint& now, const ExpireCallback& expire);
+
+  /**
+   * @return the time at which advance() must be called next
+   * @pre !empty()
+   */
+  time::steady_clock::TimePoint
+  getNextExpiry() const;
+
+  bool
+  empty() const
+  {
+    return m_nTimers == 0;
+  }
+
+  size_t
+  size() const
+  {
+    return m_nTimers;
+  }
+
+private:
+  struct Node
+  {
+    uint64_t key;
+    uint64_t expiryTick;
+    TimerId prev;
+    TimerId next;
+    uint16_t slot; ///< index in m_slots
+    bool isActive;
+  };
+
+  uint64_t
+  toTick(const time::steady_clock::TimePoint& t, bool roundUp) const;
+
+  void
+  insert(TimerId id);
+
+  void
+  unlink(TimerId id);
+
+  /**
+   * @brief detach the list of @p slot
+   * @return the first node of the list
+   */
+  TimerId
+  detachSlot(size_t slot);
+
+  void
+  release(TimerId id);
+
+private:
+  static const size_t N_SLOTS_PER_LEVEL = 256;
+  static const size_t LEVEL_SHIFT = 8;
+
+  time::nanoseconds m_tick;
+  time::steady_clock::TimePoint m_start;
+  uint64_t m_currentTick;
+
+  std::vector<Node> m_nodes;
+  TimerId m_freeList;
+  std::vector<TimerId> m_slots; ///< heads of the slot lists, first level then second level
+  size_t m_nTimers;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_TIMER_WHEEL_HPP
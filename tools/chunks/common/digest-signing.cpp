@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "digest-signing.hpp"
+
+namespace ndn {
+namespace chunks {
+
+std::vector<Sha256Digest>
+signWithSha256(const std::vector<shared_ptr<Data>>& packets)
+{
+  std::vector<EncodingBuffer> encoders(packets.size());
+  std::vector<std::pair<const uint8_t*, size_t>> signedPortions;
+  signedPortions.reserve(packets.size());
+
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i]->setSignature(DigestSha256());
+    packets[i]->wireEncode(encoders[i], true);
+    signedPortions.emplace_back(encoders[i].buf(), encoders[i].size());
+  }
+
+  auto digests = computeSha256Digests(signedPortions);
+
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i]->wireEncode(encoders[i], makeBinaryBlock(tlv::SignatureValue, digests[i].data(),
+                                                        digests[i].size()));
+  }
+
+  return digests;
+}
+
+} // namespace chunks
+} // namespace ndn
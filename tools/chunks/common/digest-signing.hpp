@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_COMMON_DIGEST_SIGNING_HPP
+#define NDN_TOOLS_CHUNKS_COMMON_DIGEST_SIGNING_HPP
+
+#include "core/common.hpp"
+#include "multi-buffer-sha256.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Sign @p packets with DigestSha256
+ *
+ * The signed portions of all the packets are encoded first, and their digests are computed
+ * together by computeSha256Digests, instead of one packet at a time as KeyChain::sign does.
+ *
+ * @return the signature value of each packet, in the same order
+ */
+std::vector<Sha256Digest>
+signWithSha256(const std::vector<shared_ptr<Data>>& packets);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_COMMON_DIGEST_SIGNING_HPP
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "merkle-manifest.hpp"
+
+namespace ndn {
+namespace chunks {
+
+const name::Component MerkleManifest::KEYWORD("_manifest");
+
+Name
+MerkleManifest::getPrefix(const Name& versionedPrefix)
+{
+  return Name(versionedPrefix).append(KEYWORD);
+}
+
+size_t
+MerkleManifest::getNLeavesPerSegment(size_t maxSegmentSize)
+{
+  return maxSegmentSize / std::tuple_size<Sha256Digest>::value;
+}
+
+Sha256Digest
+MerkleManifest::computeRoot(std::vector<Sha256Digest> leaves)
+{
+  BOOST_ASSERT(!leaves.empty());
+
+  std::vector<std::array<uint8_t, 2 * std::tuple_size<Sha256Digest>::value>> pairs;
+  std::vector<std::pair<const uint8_t*, size_t>> buffers;
+
+  while (leaves.size() > 1) {
+    pairs.resize(leaves.size() / 2);
+    buffers.clear();
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      std::copy(leaves[2 * i].begin(), leaves[2 * i].end(), pairs[i].begin());
+      std::copy(leaves[2 * i + 1].begin(), leaves[2 * i + 1].end(),
+                pairs[i].begin() + leaves[2 * i].size());
+      buffers.emplace_back(pairs[i].data(), pairs[i].size());
+    }
+
+    auto parents = computeSha256Digests(buffers);
+    if (leaves.size() % 2 == 1)
+      parents.push_back(leaves.back());
+    leaves.swap(parents);
+  }
+
+  return leaves.front();
+}
+
+std::vector<shared_ptr<Data>>
+MerkleManifest::makeSegments(const Name& versionedPrefix, const std::vector<Sha256Digest>& leaves,
+                             size_t maxSegmentSize, time::milliseconds freshnessPeriod)
+{
+  BOOST_ASSERT(!leaves.empty());
+  const size_t nLeavesPerSegment = getNLeavesPerSegment(maxSegmentSize);
+  BOOST_ASSERT(nLeavesPerSegment > 0);
+
+  Name prefix = getPrefix(versionedPrefix);
+  std::vector<shared_ptr<Data>> segments;
+
+  auto root = computeRoot(leaves);
+  segments.push_back(make_shared<Data>(Name(prefix).appendSegment(0)));
+  segments.back()->setContent(root.data(), root.size());
+
+  for (size_t first = 0; first < leaves.size(); first += nLeavesPerSegment) {
+    size_t last = std::min(first + nLeavesPerSegment, leaves.size());
+    Buffer content;
+    content.reserve((last - first) * root.size());
+    for (size_t i = first; i < last; ++i)
+      content.insert(content.end(), leaves[i].begin(), leaves[i].end());
+
+    segments.push_back(make_shared<Data>(Name(prefix).appendSegment(segments.size())));
+    segments.back()->setContent(content.data(), content.size());
+  }
+
+  auto finalBlockId = name::Component::fromSegment(segments.size() - 1);
+  for (const auto& segment : segments) {
+    segment->setFreshnessPeriod(freshnessPeriod);
+    segment->setFinalBlockId(finalBlockId);
+  }
+
+  return segments;
+}
+
+} // namespace chunks
+} // namespace ndn
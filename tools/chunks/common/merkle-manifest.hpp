@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_COMMON_MERKLE_MANIFEST_HPP
+#define NDN_TOOLS_CHUNKS_COMMON_MERKLE_MANIFEST_HPP
+
+#include "core/common.hpp"
+#include "multi-buffer-sha256.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Merkle manifest of a segmented object signed with DigestSha256
+ *
+ * The manifest of the object /prefix/<version> is itself a segmented object, published under
+ * /prefix/<version>/_manifest/<segment number>. Its segment 0 contains the root of a Merkle tree
+ * whose leaves are the signature values (i.e. the digests) of the segments of the object, and is
+ * the only packet that has to be signed with a key. The following segments contain the leaves,
+ * in the order of the segments of the object, and are signed with DigestSha256.
+ *
+ * A consumer verifies the signature of the manifest segment 0 and the Merkle root of the leaves,
+ * then each segment of the object only by comparing its digest with its leaf.
+ */
+class MerkleManifest
+{
+public:
+  /**
+   * @brief the name component after the version that identifies the manifest
+   */
+  static const name::Component KEYWORD;
+
+  /**
+   * @return the prefix of the manifest of the object @p versionedPrefix
+   */
+  static Name
+  getPrefix(const Name& versionedPrefix);
+
+  /**
+   * @return the number of leaves contained in a manifest segment, which is at least 1 if
+   *         @p maxSegmentSize is at least the size of a digest
+   */
+  static size_t
+  getNLeavesPerSegment(size_t maxSegmentSize);
+
+  /**
+   * @brief compute the root of the Merkle tree of @p leaves
+   *
+   * Each node is the digest of the concatenation of its two children, a node without sibling is
+   * moved up unchanged. The nodes of each level are computed together by computeSha256Digests.
+   *
+   * @pre @p leaves is not empty
+   */
+  static Sha256Digest
+  computeRoot(std::vector<Sha256Digest> leaves);
+
+  /**
+   * @brief create the segments of the manifest of @p versionedPrefix, which are not signed
+   *
+   * @param leaves the signature values of the segments of the object, not empty
+   * @param maxSegmentSize the maximum content size of a manifest segment, at least the size of
+   *        a digest
+   */
+  static std::vector<shared_ptr<Data>>
+  makeSegments(const Name& versionedPrefix, const std::vector<Sha256Digest>& leaves,
+               size_t maxSegmentSize, time::milliseconds freshnessPeriod);
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_COMMON_MERKLE_MANIFEST_HPP
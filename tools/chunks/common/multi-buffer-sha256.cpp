@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "multi-buffer-sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ndn {
+namespace chunks {
+
+namespace {
+
+/**
+ * @brief a 32-bit word of each lane, the vector extensions of GCC and Clang map the operations
+ *        on it to the SIMD instructions of the target (SSE2 on x86-64, NEON on ARMv8)
+ */
+typedef uint32_t Words __attribute__((vector_size(SHA256_N_LANES * sizeof(uint32_t))));
+
+const size_t BLOCK_SIZE = 64;
+
+const uint32_t K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+const uint32_t H0[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+inline Words
+rotr(Words x, int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t
+loadBigEndian(const uint8_t* p)
+{
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/**
+ * @brief a buffer hashed in a lane, with its padded last one or two blocks
+ */
+struct Lane
+{
+  const uint8_t* data;
+  size_t nFullBlocks; ///< the blocks read from data
+  size_t nBlocks;     ///< including the padded blocks in tail
+  uint8_t tail[2 * BLOCK_SIZE];
+
+  void
+  assign(const uint8_t* buffer, size_t size)
+  {
+    data = buffer;
+    nFullBlocks = size / BLOCK_SIZE;
+    size_t remainder = size % BLOCK_SIZE;
+    // 0x80 and the 64-bit length must fit after the remainder
+    size_t nTailBlocks = remainder + 9 > BLOCK_SIZE ? 2 : 1;
+    nBlocks = nFullBlocks + nTailBlocks;
+
+    std::memset(tail, 0, sizeof(tail));
+    if (remainder > 0)
+      std::memcpy(tail, buffer + nFullBlocks * BLOCK_SIZE, remainder);
+    tail[remainder] = 0x80;
+
+    uint64_t nBits = static_cast<uint64_t>(size) * 8;
+    uint8_t* end = tail + nTailBlocks * BLOCK_SIZE;
+    for (int i = 1; i <= 8; ++i) {
+      end[-i] = static_cast<uint8_t>(nBits);
+      nBits >>= 8;
+    }
+  }
+
+  const uint8_t*
+  getBlock(size_t i) const
+  {
+    return i < nFullBlocks ? data + i * BLOCK_SIZE : tail + (i - nFullBlocks) * BLOCK_SIZE;
+  }
+};
+
+void
+hashGroup(const Lane* lanes, size_t nLanes, Sha256Digest* digests)
+{
+  Words state[8];
+  for (size_t i = 0; i < 8; ++i) {
+    for (size_t lane = 0; lane < SHA256_N_LANES; ++lane)
+      state[i][lane] = H0[i];
+  }
+
+  size_t nBlocks = 0;
+  for (size_t lane = 0; lane < nLanes; ++lane)
+    nBlocks = std::max(nBlocks, lanes[lane].nBlocks);
+
+  Words w[64];
+  for (size_t block = 0; block < nBlocks; ++block) {
+    // all ones in the lanes that have not been completely hashed yet
+    Words isActive = {};
+    for (size_t lane = 0; lane < nLanes; ++lane) {
+      if (block < lanes[lane].nBlocks) {
+        isActive[lane] = 0xffffffff;
+        const uint8_t* p = lanes[lane].getBlock(block);
+        for (size_t t = 0; t < 16; ++t)
+          w[t][lane] = loadBigEndian(p + 4 * t);
+      }
+      else {
+        for (size_t t = 0; t < 16; ++t)
+          w[t][lane] = 0;
+      }
+    }
+
+    for (size_t t = 16; t < 64; ++t) {
+      Words s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+      Words s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    Words a = state[0], b = state[1], c = state[2], d = state[3];
+    Words e = state[4], f = state[5], g = state[6], h = state[7];
+    for (size_t t = 0; t < 64; ++t) {
+      Words s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+      Words ch = (e & f) ^ (~e & g);
+      Words t1 = h + s1 + ch + K[t] + w[t];
+      Words s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+      Words maj = (a & b) ^ (a & c) ^ (b & c);
+      Words t2 = s0 + maj;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+    Words result[8] = {a, b, c, d, e, f, g, h};
+    for (size_t i = 0; i < 8; ++i)
+      state[i] += result[i] & isActive;
+  }
+
+  for (size_t lane = 0; lane < nLanes; ++lane) {
+    for (size_t i = 0; i < 8; ++i) {
+      uint32_t word = state[i][lane];
+      digests[lane][4 * i] = static_cast<uint8_t>(word >> 24);
+      digests[lane][4 * i + 1] = static_cast<uint8_t>(word >> 16);
+      digests[lane][4 * i + 2] = static_cast<uint8_t>(word >> 8);
+      digests[lane][4 * i + 3] = static_cast<uint8_t>(word);
+    }
+  }
+}
+
+} // namespace
+
+std::vector<Sha256Digest>
+computeSha256Digests(const std::vector<std::pair<const uint8_t*, size_t>>& buffers)
+{
+  std::vector<Sha256Digest> digests(buffers.size());
+  Lane lanes[SHA256_N_LANES];
+
+  for (size_t first = 0; first < buffers.size(); first += SHA256_N_LANES) {
+    size_t nLanes = std::min(SHA256_N_LANES, buffers.size() - first);
+    for (size_t lane = 0; lane < nLanes; ++lane)
+      lanes[lane].assign(buffers[first + lane].first, buffers[first + lane].second);
+    hashGroup(lanes, nLanes, &digests[first]);
+  }
+
+  return digests;
+}
+
+} // namespace chunks
+} // namespace ndn
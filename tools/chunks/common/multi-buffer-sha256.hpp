@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_COMMON_MULTI_BUFFER_SHA256_HPP
+#define NDN_TOOLS_CHUNKS_COMMON_MULTI_BUFFER_SHA256_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ndn {
+namespace chunks {
+
+typedef std::array<uint8_t, 32> Sha256Digest;
+
+/**
+ * @brief the number of buffers hashed in parallel by computeSha256Digests
+ *
+ * Four 32-bit lanes fill the 128-bit vectors available on all x86-64 and ARMv8 targets without
+ * specific compiler flags.
+ */
+const size_t SHA256_N_LANES = 4;
+
+/**
+ * @brief Compute the SHA-256 digests of many buffers at once
+ *
+ * The buffers are hashed in groups of SHA256_N_LANES, each one in a lane of vectors of 32-bit
+ * words, so that each step of the compression function is applied to the whole group with SIMD
+ * instructions. The buffers of a group can have different sizes, the lanes of the buffers that
+ * have been completely hashed are masked out until the longest buffer of the group is done.
+ *
+ * @param buffers the pointer and size of each buffer
+ * @return the digest of each buffer, in the same order
+ */
+std::vector<Sha256Digest>
+computeSha256Digests(const std::vector<std::pair<const uint8_t*, size_t>>& buffers);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_COMMON_MULTI_BUFFER_SHA256_HPP
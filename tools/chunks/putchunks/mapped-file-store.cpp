@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "mapped-file-store.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+MappedFileStore::MappedFileStore(const std::string& path, const Name& versionedPrefix,
+                                 KeyChain& keyChain, const security::SigningInfo& signingInfo,
+                                 time::milliseconds freshnessPeriod, size_t maxSegmentSize,
+                                 size_t cacheSize)
+  : m_versionedPrefix(versionedPrefix)
+  , m_keyChain(keyChain)
+  , m_signingInfo(signingInfo)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_maxSegmentSize(maxSegmentSize)
+  , m_fd(::open(path.c_str(), O_RDONLY))
+  , m_map(nullptr)
+  , m_fileSize(0)
+  , m_modificationTime(0)
+  , m_cacheSize(cacheSize)
+  , m_nSignedSegments(0)
+{
+  BOOST_ASSERT(m_maxSegmentSize > 0);
+  BOOST_ASSERT(m_cacheSize > 0);
+
+  if (m_fd < 0)
+    throw Error("Cannot open " + path + ": " + std::strerror(errno));
+
+  struct stat st;
+  if (::fstat(m_fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+    ::close(m_fd);
+    throw Error(path + " is not a regular file");
+  }
+  m_fileSize = static_cast<size_t>(st.st_size);
+  m_modificationTime = st.st_mtime;
+
+  // an empty file cannot be mapped, it is published as a single empty segment
+  if (m_fileSize > 0) {
+    void* map = ::mmap(nullptr, m_fileSize, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+      ::close(m_fd);
+      throw Error("Cannot map " + path + ": " + std::strerror(errno));
+    }
+    m_map = static_cast<const uint8_t*>(map);
+
+    // the consumers usually fetch the segments in order
+    ::madvise(map, m_fileSize, MADV_SEQUENTIAL);
+  }
+
+  m_nSegments = std::max<uint64_t>((m_fileSize + m_maxSegmentSize - 1) / m_maxSegmentSize, 1);
+  m_finalBlockId = name::Component::fromSegment(m_nSegments - 1);
+}
+
+MappedFileStore::~MappedFileStore()
+{
+  if (m_map != nullptr)
+    ::munmap(const_cast<uint8_t*>(m_map), m_fileSize);
+  ::close(m_fd);
+}
+
+shared_ptr<Data>
+MappedFileStore::getSegment(uint64_t segmentNo)
+{
+  if (segmentNo >= m_nSegments)
+    return nullptr;
+
+  auto it = m_cache.find(segmentNo);
+  if (it != m_cache.end()) {
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+  }
+
+  auto data = makeSegment(segmentNo);
+  if (data == nullptr)
+    return nullptr;
+
+  if (m_cache.size() >= m_cacheSize) {
+    m_cache.erase(m_lru.back().first);
+    m_lru.pop_back();
+  }
+  m_lru.emplace_front(segmentNo, data);
+  m_cache[segmentNo] = m_lru.begin();
+
+  return data;
+}
+
+bool
+MappedFileStore::isModified() const
+{
+  struct stat st;
+  return ::fstat(m_fd, &st) < 0 || static_cast<size_t>(st.st_size) != m_fileSize ||
+         st.st_mtime != m_modificationTime;
+}
+
+shared_ptr<Data>
+MappedFileStore::makeSegment(uint64_t segmentNo)
+{
+  // the mapped range may no longer be the content of this version, or even exist
+  if (isModified())
+    return nullptr;
+
+  auto data = make_shared<Data>(Name(m_versionedPrefix).appendSegment(segmentNo));
+  data->setFreshnessPeriod(m_freshnessPeriod);
+
+  if (m_map != nullptr) {
+    size_t offset = static_cast<size_t>(segmentNo * m_maxSegmentSize);
+    data->setContent(m_map + offset, std::min(m_maxSegmentSize, m_fileSize - offset));
+  }
+
+  data->setFinalBlockId(m_finalBlockId);
+  m_keyChain.sign(*data, m_signingInfo);
+  ++m_nSignedSegments;
+
+  return data;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_MAPPED_FILE_STORE_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_MAPPED_FILE_STORE_HPP
+
+#include "core/common.hpp"
+
+#include <list>
+#include <unordered_map>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Segments of a memory mapped file, packetized and signed on demand
+ *
+ * The file is mapped when the store is created, which does not read it. A Data packet is built
+ * from the mapped range of a segment and signed only when the segment is requested. The most
+ * recently requested segments are kept in a bounded LRU cache, so the memory used by the store
+ * does not depend on the size of the file.
+ *
+ * The file should be replaced (e.g. by renaming a new file over it) rather than modified in place
+ * while it is published. A file modified in place would expose its new content through the
+ * mapping, and a file truncated would fault when accessed past its new end, hence the store stops
+ * signing new segments once the size or the modification time of the file has changed.
+ */
+class MappedFileStore : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @param path the file to publish
+   * @param versionedPrefix the name of the content, the segments are published under it
+   * @param cacheSize the maximum number of signed segments kept in memory, at least 1
+   * @throw Error the file cannot be opened or mapped
+   */
+  MappedFileStore(const std::string& path, const Name& versionedPrefix, KeyChain& keyChain,
+                  const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+                  size_t maxSegmentSize, size_t cacheSize);
+
+  ~MappedFileStore();
+
+  /**
+   * @return the number of segments, at least 1 (also with an empty file)
+   */
+  uint64_t
+  getNSegments() const
+  {
+    return m_nSegments;
+  }
+
+  /**
+   * @return the signed Data of @p segmentNo, or nullptr if there is no such segment, or if it is
+   *         not cached and the file has been modified
+   */
+  shared_ptr<Data>
+  getSegment(uint64_t segmentNo);
+
+  /**
+   * @return the number of segments that have been signed, including the ones evicted from the
+   *         cache and signed again
+   */
+  uint64_t
+  getNSignedSegments() const
+  {
+    return m_nSignedSegments;
+  }
+
+  size_t
+  getNCachedSegments() const
+  {
+    return m_cache.size();
+  }
+
+  /**
+   * @return whether the file has been modified in place since the store was created
+   */
+  bool
+  isModified() const;
+
+private:
+  shared_ptr<Data>
+  makeSegment(uint64_t segmentNo);
+
+private:
+  Name m_versionedPrefix;
+  KeyChain& m_keyChain;
+  security::SigningInfo m_signingInfo;
+  time::milliseconds m_freshnessPeriod;
+  size_t m_maxSegmentSize;
+
+  int m_fd;
+  const uint8_t* m_map; ///< nullptr if the file is empty
+  size_t m_fileSize;
+  time_t m_modificationTime;
+  uint64_t m_nSegments;
+  name::Component m_finalBlockId;
+
+  typedef std::list<std::pair<uint64_t, shared_ptr<Data>>> LruList;
+  LruList m_lru; ///< the most recently used segment first
+  std::unordered_map<uint64_t, LruList::iterator> m_cache;
+  size_t m_cacheSize;
+  uint64_t m_nSignedSegments;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_MAPPED_FILE_STORE_HPP
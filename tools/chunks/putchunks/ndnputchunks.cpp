@@ -26,11 +26,35 @@
  */
 
 #include "core/version.hpp"
+#include "object-server.hpp"
 #include "producer.hpp"
+#include "streaming-producer.hpp"
 
 namespace ndn {
 namespace chunks {
 
+static void
+handleSIGHUP(const boost::system::error_code& errorCode, boost::asio::signal_set& signalSet,
+             ObjectServer& server, const std::string& directory)
+{
+  if (errorCode == boost::asio::error::operation_aborted) {
+    return;
+  }
+
+  try {
+    size_t nAdded = server.addDirectory(directory);
+    std::cerr << "Rescanned " << directory << ": " << nAdded << " new versions, "
+              << server.getNObjects() << " objects, " << server.getNVersions() << " versions"
+              << std::endl;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+  }
+
+  signalSet.async_wait(bind(handleSIGHUP, _1, std::ref(signalSet), std::ref(server),
+                            directory));
+}
+
 static int
 main(int argc, char** argv)
 {
@@ -41,6 +65,13 @@ main(int argc, char** argv)
   std::string signingStr;
   bool isVerbose = false;
   std::string prefix;
+  std::string inputFile;
+  size_t cacheSize = 4096;
+  size_t nSigningThreads = 1;
+  bool isStreaming = false;
+  bool wantManifest = false;
+  std::string directory;
+  size_t maxVersions = 1;
 
   namespace po = boost::program_options;
   po::options_description visibleDesc("Options");
@@ -53,6 +84,25 @@ main(int argc, char** argv)
                         "maximum chunk size, in bytes")
     ("signing-info,S",  po::value<std::string>(&signingStr)->default_value(signingStr),
                         "set signing information")
+    ("file",            po::value<std::string>(&inputFile),
+                        "publish the content of this file, mapped in memory and signed on demand, "
+                        "instead of the standard input")
+    ("cache-size",      po::value<size_t>(&cacheSize)->default_value(cacheSize),
+                        "maximum number of signed chunks kept in memory when publishing a file")
+    ("signing-threads", po::value<size_t>(&nSigningThreads)->default_value(nSigningThreads),
+                        "number of threads signing the chunks of the standard input")
+    ("manifest",        po::bool_switch(&wantManifest),
+                        "sign the chunks of the standard input with DigestSha256 and publish a "
+                        "Merkle manifest of their digests, signed with the signing information")
+    ("streaming",       po::bool_switch(&isStreaming),
+                        "publish the chunks of the standard input while reading it, the last chunk "
+                        "is known only when the end of the input is reached")
+    ("directory",       po::value<std::string>(&directory),
+                        "serve the files under this directory, each one under the prefix followed "
+                        "by its relative path, and rescan the directory on SIGHUP; the files should "
+                        "be replaced rather than modified in place")
+    ("max-versions",    po::value<size_t>(&maxVersions)->default_value(maxVersions),
+                        "maximum number of versions served for each file of the directory")
     ("verbose,v",       po::bool_switch(&isVerbose), "turn on verbose output")
     ("version,V",       "print program version and exit")
     ;
@@ -103,6 +153,50 @@ main(int argc, char** argv)
     return 2;
   }
 
+  if (cacheSize < 1) {
+    std::cerr << "ERROR: Cache size must be at least 1" << std::endl;
+    return 2;
+  }
+
+  if (nSigningThreads < 1) {
+    std::cerr << "ERROR: The number of signing threads must be at least 1" << std::endl;
+    return 2;
+  }
+
+  if (isStreaming && !inputFile.empty()) {
+    std::cerr << "ERROR: Streaming is not compatible with publishing a file" << std::endl;
+    return 2;
+  }
+
+  if (wantManifest && (isStreaming || !inputFile.empty())) {
+    std::cerr << "ERROR: The manifest can only be published with the standard input, "
+              << "without streaming" << std::endl;
+    return 2;
+  }
+
+  if (wantManifest && maxChunkSize < std::tuple_size<Sha256Digest>::value) {
+    std::cerr << "ERROR: The manifest needs chunks of at least "
+              << std::tuple_size<Sha256Digest>::value << " bytes" << std::endl;
+    return 2;
+  }
+
+  if (isStreaming && nSigningThreads > 1) {
+    std::cerr << "ERROR: Streaming is not compatible with multiple signing threads" << std::endl;
+    return 2;
+  }
+
+  if (!directory.empty() && (!inputFile.empty() || isStreaming || nSigningThreads > 1 ||
+                             wantManifest || printVersion)) {
+    std::cerr << "ERROR: Serving a directory is not compatible with publishing a file or the "
+              << "standard input, or printing the version" << std::endl;
+    return 2;
+  }
+
+  if (maxVersions < 1) {
+    std::cerr << "ERROR: The maximum number of versions must be at least 1" << std::endl;
+    return 2;
+  }
+
   security::SigningInfo signingInfo;
   try {
     signingInfo = security::SigningInfo(signingStr);
@@ -115,9 +209,46 @@ main(int argc, char** argv)
   try {
     Face face;
     KeyChain keyChain;
-    Producer producer(prefix, face, keyChain, signingInfo, time::milliseconds(freshnessPeriod),
-                      maxChunkSize, isVerbose, printVersion, std::cin);
-    producer.run();
+    if (!directory.empty()) {
+      ObjectServer server(prefix, face, keyChain, signingInfo,
+                          time::milliseconds(freshnessPeriod), maxChunkSize, cacheSize,
+                          maxVersions, isVerbose);
+      server.addDirectory(directory);
+      std::cerr << "Serving " << server.getNObjects() << " objects from " << directory
+                << " under " << Name(prefix) << std::endl;
+
+      boost::asio::signal_set signalSetHup(face.getIoService(), SIGHUP);
+      signalSetHup.async_wait(bind(handleSIGHUP, _1, std::ref(signalSetHup), std::ref(server),
+                                   directory));
+
+      server.run();
+      return 0;
+    }
+
+    if (isStreaming) {
+      // the reading thread signs with a KeyChain of its own, it may outlive this one
+      StreamingProducer producer(prefix, face, [] { return make_unique<KeyChain>(); },
+                                 signingInfo, time::milliseconds(freshnessPeriod), maxChunkSize,
+                                 isVerbose, printVersion, std::cin);
+      producer.run();
+      return 0;
+    }
+
+    unique_ptr<Producer> producer;
+    if (inputFile.empty()) {
+      Producer::SigningOptions signingOptions;
+      signingOptions.nThreads = nSigningThreads;
+      signingOptions.makeKeyChain = [] { return make_unique<KeyChain>(); };
+      signingOptions.wantManifest = wantManifest;
+      producer = make_unique<Producer>(prefix, face, keyChain, signingInfo,
+                                       time::milliseconds(freshnessPeriod), maxChunkSize,
+                                       signingOptions, isVerbose, printVersion, std::cin);
+    }
+    else
+      producer = make_unique<Producer>(prefix, face, keyChain, signingInfo,
+                                       time::milliseconds(freshnessPeriod), maxChunkSize,
+                                       inputFile, cacheSize, isVerbose, printVersion);
+    producer->run();
   }
   catch (const std::exception& e) {
     std::cerr << "ERROR: " << e.what() << std::endl;
@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "object-server.hpp"
+
+#include "../chunks-tracepoint.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace chunks {
+
+ObjectServer::ObjectServer(const Name& prefix,
+                           Face& face,
+                           KeyChain& keyChain,
+                           const security::SigningInfo& signingInfo,
+                           time::milliseconds freshnessPeriod,
+                           size_t maxSegmentSize,
+                           size_t cacheSize,
+                           size_t maxVersions,
+                           bool isVerbose)
+  : m_prefix(prefix)
+  , m_face(face)
+  , m_keyChain(keyChain)
+  , m_signingInfo(signingInfo)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_maxSegmentSize(maxSegmentSize)
+  , m_cacheSize(cacheSize)
+  , m_maxVersions(maxVersions)
+  , m_isVerbose(isVerbose)
+  , m_nObjects(0)
+  , m_nVersions(0)
+{
+  BOOST_ASSERT(m_maxVersions >= 1);
+
+  m_registeredPrefixId = m_face.setInterestFilter(m_prefix,
+                                                  bind(&ObjectServer::onInterest, this, _2),
+                                                  RegisterPrefixSuccessCallback(),
+                                                  bind(&ObjectServer::onRegisterFailed, this,
+                                                       _1, _2));
+}
+
+ObjectServer::~ObjectServer()
+{
+  m_face.unsetInterestFilter(m_registeredPrefixId);
+}
+
+bool
+ObjectServer::addObject(const Name& name, uint64_t version, const std::string& path)
+{
+  const Node* existing = findNode(name);
+  if (existing != nullptr && existing->versions.count(version) > 0)
+    return false;
+
+  // the file is mapped before creating the nodes, which are not left empty if it fails
+  Name versionedPrefix = Name(m_prefix).append(name).appendVersion(version);
+  auto store = make_unique<MappedFileStore>(path, versionedPrefix, m_keyChain, m_signingInfo,
+                                            m_freshnessPeriod, m_maxSegmentSize, m_cacheSize);
+
+  Node* node = &m_root;
+  for (const auto& component : name) {
+    auto& child = node->children[component];
+    if (child == nullptr)
+      child = make_unique<Node>();
+    node = child.get();
+  }
+
+  if (node->versions.empty())
+    ++m_nObjects;
+  node->versions.emplace(version, std::move(store));
+  ++m_nVersions;
+
+  if (node->versions.size() > m_maxVersions) {
+    node->versions.erase(node->versions.begin());
+    --m_nVersions;
+  }
+
+  if (m_isVerbose)
+    std::cerr << "Added " << versionedPrefix << " (" << path << ")" << std::endl;
+
+  return true;
+}
+
+bool
+ObjectServer::removeObject(const Name& name)
+{
+  // the nodes from the root to the object, to prune the ones left empty
+  std::vector<Node*> path{&m_root};
+  for (const auto& component : name) {
+    auto child = path.back()->children.find(component);
+    if (child == path.back()->children.end())
+      return false;
+    path.push_back(child->second.get());
+  }
+
+  if (path.back()->versions.empty())
+    return false;
+
+  --m_nObjects;
+  m_nVersions -= path.back()->versions.size();
+  path.back()->versions.clear();
+
+  for (size_t i = name.size(); i > 0; --i) {
+    const Node* node = path[i];
+    if (!node->children.empty() || !node->versions.empty())
+      break;
+    path[i - 1]->children.erase(name[i - 1]);
+  }
+
+  if (m_isVerbose)
+    std::cerr << "Removed " << Name(m_prefix).append(name) << std::endl;
+
+  return true;
+}
+
+const ObjectServer::Node*
+ObjectServer::findNode(const Name& name) const
+{
+  const Node* node = &m_root;
+  for (const auto& component : name) {
+    auto child = node->children.find(component);
+    if (child == node->children.end())
+      return nullptr;
+    node = child->second.get();
+  }
+  return node;
+}
+
+void
+ObjectServer::removeModifiedVersions(const Name& name)
+{
+  // the node is found again from the root, findNode only gives read access
+  Node* node = &m_root;
+  for (const auto& component : name) {
+    auto child = node->children.find(component);
+    if (child == node->children.end())
+      return;
+    node = child->second.get();
+  }
+
+  size_t nModified = 0;
+  for (const auto& version : node->versions)
+    if (version.second->isModified())
+      ++nModified;
+
+  if (nModified == 0)
+    return;
+
+  if (nModified == node->versions.size()) {
+    removeObject(name);
+    return;
+  }
+
+  for (auto it = node->versions.begin(); it != node->versions.end();) {
+    if (it->second->isModified()) {
+      if (m_isVerbose)
+        std::cerr << "Removed " << Name(m_prefix).append(name).appendVersion(it->first)
+                  << std::endl;
+      it = node->versions.erase(it);
+      --m_nVersions;
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+size_t
+ObjectServer::addDirectory(const std::string& directory)
+{
+  namespace fs = boost::filesystem;
+
+  fs::path base = fs::canonical(directory);
+  const auto baseDepth = std::distance(base.begin(), base.end());
+
+  size_t nAdded = 0;
+  std::set<Name> names;
+  for (fs::recursive_directory_iterator it(base), end; it != end; ++it) {
+    if (!fs::is_regular_file(it->status()))
+      continue;
+
+    Name name;
+    auto component = it->path().begin();
+    std::advance(component, baseDepth);
+    for (; component != it->path().end(); ++component)
+      name.append(component->string());
+
+    removeModifiedVersions(name);
+
+    uint64_t version = static_cast<uint64_t>(fs::last_write_time(it->path())) * 1000;
+    try {
+      if (addObject(name, version, it->path().string()))
+        ++nAdded;
+      names.insert(name);
+    }
+    catch (const MappedFileStore::Error& e) {
+      std::cerr << "ERROR: Skipping '" << it->path().string() << "' (" << e.what() << ")"
+                << std::endl;
+    }
+  }
+
+  // the files that have been deleted since the previous scan
+  auto& previousNames = m_directoryObjects[base.string()];
+  for (const auto& name : previousNames)
+    if (names.count(name) == 0)
+      removeObject(name);
+  previousNames.swap(names);
+
+  return nAdded;
+}
+
+void
+ObjectServer::run()
+{
+  m_face.processEvents();
+}
+
+void
+ObjectServer::onInterest(const Interest& interest)
+{
+  if (m_isVerbose)
+    std::cerr << "Interest: " << interest << std::endl;
+
+  auto data = findData(interest);
+  if (data == nullptr)
+    return;
+
+  if (m_isVerbose)
+    std::cerr << "Data: " << *data << std::endl;
+
+  m_face.put(*data);
+
+  tracepoint(chunksLog, data_sent, data->getName()[-1].toSegment(), data->getContent().size());
+}
+
+shared_ptr<Data>
+ObjectServer::findData(const Interest& interest)
+{
+  const Name& name = interest.getName();
+  if (!m_prefix.isPrefixOf(name))
+    return nullptr;
+
+  // the longest object name that is a prefix of the Interest name
+  const Node* node = &m_root;
+  const Node* object = nullptr;
+  size_t objectEnd = 0;
+  for (size_t i = m_prefix.size(); ; ++i) {
+    if (!node->versions.empty()) {
+      object = node;
+      objectEnd = i;
+    }
+    if (i == name.size())
+      break;
+
+    auto child = node->children.find(name[i]);
+    if (child == node->children.end())
+      break;
+    node = child->second.get();
+  }
+
+  if (object == nullptr)
+    return nullptr;
+
+  // the components after the object name: [<version> [<segment number>]]
+  const size_t nRemaining = name.size() - objectEnd;
+  if (nRemaining == 0) {
+    // discovery Interest, the latest version that satisfies it
+    for (auto it = object->versions.rbegin(); it != object->versions.rend(); ++it) {
+      auto data = it->second->getSegment(0);
+      if (data != nullptr && interest.matchesData(*data))
+        return data;
+    }
+    return nullptr;
+  }
+
+  if (nRemaining > 2 || !name[objectEnd].isVersion())
+    return nullptr;
+
+  auto version = object->versions.find(name[objectEnd].toVersion());
+  if (version == object->versions.end())
+    return nullptr;
+
+  if (nRemaining == 2) {
+    if (!name[-1].isSegment())
+      return nullptr;
+    return version->second->getSegment(name[-1].toSegment());
+  }
+
+  auto data = version->second->getSegment(0);
+  return data != nullptr && interest.matchesData(*data) ? data : nullptr;
+}
+
+void
+ObjectServer::onRegisterFailed(const Name& prefix, const std::string& reason)
+{
+  std::cerr << "ERROR: Failed to register prefix '"
+            << prefix << "' (" << reason << ")" << std::endl;
+  m_face.shutdown();
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_OBJECT_SERVER_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_OBJECT_SERVER_HPP
+
+#include "core/common.hpp"
+#include "mapped-file-store.hpp"
+
+#include <map>
+#include <set>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Producer that serves many objects, each one in one or more versions, under a single
+ *        registered prefix
+ *
+ * The objects are published under /prefix/<object name>/<version>/<segment number>. They are
+ * indexed by a tree over the components of their names, so an Interest is dispatched to its
+ * object in a time that depends on the length of the name and logarithmically on the number of
+ * objects. The content of each version is a file, mapped in memory and signed on demand by a
+ * MappedFileStore.
+ *
+ * An Interest without version is answered with the first segment of the latest version of the
+ * object that satisfies the Interest.
+ */
+class ObjectServer : noncopyable
+{
+public:
+  /**
+   * @param prefix the registered prefix, under which all the objects are published
+   * @param cacheSize the maximum number of signed segments kept in memory for each version
+   * @param maxVersions the maximum number of versions of each object, adding a version beyond
+   *        it removes the oldest one
+   */
+  ObjectServer(const Name& prefix, Face& face, KeyChain& keyChain,
+               const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+               size_t maxSegmentSize, size_t cacheSize, size_t maxVersions,
+               bool isVerbose = false);
+
+  ~ObjectServer();
+
+  /**
+   * @brief publish the file at @p path as @p version of the object @p name
+   *
+   * @param name the name of the object, relative to the registered prefix
+   * @return false if the object already has @p version, which is not replaced
+   * @throw MappedFileStore::Error the file cannot be mapped
+   */
+  bool
+  addObject(const Name& name, uint64_t version, const std::string& path);
+
+  /**
+   * @brief stop publishing all the versions of the object @p name
+   *
+   * @return false if there is no such object
+   */
+  bool
+  removeObject(const Name& name);
+
+  /**
+   * @brief publish the regular files under @p directory, recursively
+   *
+   * Each file is published as an object named after its path relative to @p directory, with
+   * its modification time (in milliseconds since the epoch) as version. Scanning the same
+   * directory again adds the new versions of the files that have been modified since, and
+   * removes the objects whose file has been deleted since the previous scan.
+   *
+   * The previous versions of a file that has been replaced (e.g. by renaming a new file over it)
+   * are still served, up to maxVersions. The previous versions of a file that has been modified
+   * in place are removed, since their mapping now shows the new content (see MappedFileStore).
+   *
+   * The files that cannot be mapped are skipped.
+   *
+   * @return the number of versions added
+   */
+  size_t
+  addDirectory(const std::string& directory);
+
+  /**
+   * @return the number of objects
+   */
+  size_t
+  getNObjects() const
+  {
+    return m_nObjects;
+  }
+
+  /**
+   * @return the number of versions of all objects
+   */
+  size_t
+  getNVersions() const
+  {
+    return m_nVersions;
+  }
+
+  /**
+   * @brief Run the server
+   */
+  void
+  run();
+
+private:
+  /**
+   * @brief node of the tree over the name components of the objects
+   */
+  struct Node
+  {
+    std::map<name::Component, unique_ptr<Node>> children;
+    std::map<uint64_t, unique_ptr<MappedFileStore>> versions; ///< empty if not an object
+  };
+
+  /**
+   * @return the node of @p name, or nullptr if there is none
+   */
+  const Node*
+  findNode(const Name& name) const;
+
+  /**
+   * @brief stop publishing the versions of the object @p name whose file has been modified in
+   *        place, and the object itself if no version is left
+   */
+  void
+  removeModifiedVersions(const Name& name);
+
+  void
+  onInterest(const Interest& interest);
+
+  /**
+   * @return the Data answering @p interest, or nullptr if there is none
+   */
+  shared_ptr<Data>
+  findData(const Interest& interest);
+
+  void
+  onRegisterFailed(const Name& prefix, const std::string& reason);
+
+private:
+  Name m_prefix;
+  Face& m_face;
+  KeyChain& m_keyChain;
+  security::SigningInfo m_signingInfo;
+  time::milliseconds m_freshnessPeriod;
+  size_t m_maxSegmentSize;
+  size_t m_cacheSize;
+  size_t m_maxVersions;
+  bool m_isVerbose;
+
+  Node m_root; ///< corresponds to m_prefix
+  size_t m_nObjects;
+  size_t m_nVersions;
+  const RegisteredPrefixId* m_registeredPrefixId;
+
+  /// the objects published by the last scan of each directory, indexed by canonical path
+  std::map<std::string, std::set<Name>> m_directoryObjects;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_OBJECT_SERVER_HPP
@@ -28,6 +28,10 @@
 #include "producer.hpp"
 
 #include "../chunks-tracepoint.hpp"
+#include "../common/digest-signing.hpp"
+
+#include <exception>
+#include <thread>
 
 namespace ndn {
 namespace chunks {
@@ -41,12 +45,72 @@ Producer::Producer(const Name& prefix,
                    bool isVerbose,
                    bool needToPrintVersion,
                    std::istream& is)
+  : Producer(prefix, face, keyChain, signingInfo, freshnessPeriod, maxSegmentSize,
+             SigningOptions(), isVerbose, needToPrintVersion, is)
+{
+}
+
+Producer::Producer(const Name& prefix,
+                   Face& face,
+                   KeyChain& keyChain,
+                   const security::SigningInfo& signingInfo,
+                   time::milliseconds freshnessPeriod,
+                   size_t maxSegmentSize,
+                   const SigningOptions& signingOptions,
+                   bool isVerbose,
+                   bool needToPrintVersion,
+                   std::istream& is)
   : m_face(face)
   , m_keyChain(keyChain)
   , m_signingInfo(signingInfo)
   , m_freshnessPeriod(freshnessPeriod)
   , m_maxSegmentSize(maxSegmentSize)
   , m_isVerbose(isVerbose)
+{
+  BOOST_ASSERT(signingOptions.nThreads >= 1);
+
+  setPrefix(prefix);
+  populateStore(is, signingOptions);
+  publish(prefix, needToPrintVersion);
+}
+
+Producer::Producer(const Name& prefix,
+                   Face& face,
+                   KeyChain& keyChain,
+                   const security::SigningInfo& signingInfo,
+                   time::milliseconds freshnessPeriod,
+                   size_t maxSegmentSize,
+                   const std::string& inputFile,
+                   size_t cacheSize,
+                   bool isVerbose,
+                   bool needToPrintVersion)
+  : m_face(face)
+  , m_keyChain(keyChain)
+  , m_signingInfo(signingInfo)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_maxSegmentSize(maxSegmentSize)
+  , m_isVerbose(isVerbose)
+{
+  setPrefix(prefix);
+  m_mappedStore = make_unique<MappedFileStore>(inputFile, m_versionedPrefix, m_keyChain,
+                                               m_signingInfo, m_freshnessPeriod, m_maxSegmentSize,
+                                               cacheSize);
+
+  if (m_isVerbose)
+    std::cerr << "Mapped " << m_mappedStore->getNSegments() << " chunks for prefix "
+              << m_prefix << std::endl;
+
+  publish(prefix, needToPrintVersion);
+}
+
+Producer::SigningOptions::SigningOptions()
+  : nThreads(1)
+  , wantManifest(false)
+{
+}
+
+void
+Producer::setPrefix(const Name& prefix)
 {
   if (prefix.size() > 0 && prefix[-1].isVersion()) {
     m_prefix = prefix.getPrefix(-1);
@@ -56,9 +120,11 @@ Producer::Producer(const Name& prefix,
     m_prefix = prefix;
     m_versionedPrefix = Name(m_prefix).appendVersion();
   }
+}
 
-  populateStore(is);
-
+void
+Producer::publish(const Name& prefix, bool needToPrintVersion)
+{
   if (needToPrintVersion)
     std::cout << m_versionedPrefix[-1] << std::endl;
 
@@ -68,10 +134,10 @@ Producer::Producer(const Name& prefix,
                            bind(&Producer::onRegisterFailed, this, _1, _2));
 
   std::ostringstream sign;
-  sign << signingInfo;
+  sign << m_signingInfo;
 
   tracepoint(chunksLog, put_started, prefix.toUri().c_str(), sign.str().c_str(),
-             freshnessPeriod.count(), maxSegmentSize, m_store.size());
+             m_freshnessPeriod.count(), m_maxSegmentSize, getNSegments());
 
   if (m_isVerbose)
     std::cerr << "Data published with name: " << m_versionedPrefix << std::endl;
@@ -86,7 +152,7 @@ Producer::run()
 void
 Producer::onInterest(const Interest& interest)
 {
-  BOOST_ASSERT(m_store.size() > 0);
+  BOOST_ASSERT(getNSegments() > 0);
 
   if (m_isVerbose)
     std::cerr << "Interest: " << interest << std::endl;
@@ -95,33 +161,77 @@ Producer::onInterest(const Interest& interest)
   shared_ptr<Data> data;
   size_t segmentNo = 0;
 
+  // is this an Interest for the manifest?
+  if (!m_manifest.empty() && name.size() == m_versionedPrefix.size() + 2 &&
+      m_versionedPrefix.isPrefixOf(name) && name[-2] == MerkleManifest::KEYWORD &&
+      name[-1].isSegment()) {
+    segmentNo = static_cast<size_t>(name[-1].toSegment());
+    if (segmentNo < m_manifest.size()) {
+      if (m_isVerbose)
+        std::cerr << "Data: " << *m_manifest[segmentNo] << std::endl;
+      m_face.getTransport()->send(m_manifestWire[segmentNo]);
+    }
+    return;
+  }
+
   // is this a discovery Interest or a sequence retrieval?
   if (name.size() == m_versionedPrefix.size() + 1 && m_versionedPrefix.isPrefixOf(name) &&
       name[-1].isSegment()) {
     segmentNo = static_cast<size_t>(interest.getName()[-1].toSegment());
     // specific segment retrieval
-    if (segmentNo < m_store.size()) {
-      data = m_store[segmentNo];
-    }
+    data = getSegment(segmentNo);
   }
-  else if (interest.matchesData(*m_store[0])) {
-    segmentNo = 0;
+  else {
     // Interest has version and is looking for the first segment or has no version
-    data = m_store[segmentNo];
+    data = getSegment(0);
+    if (data != nullptr && !interest.matchesData(*data))
+      data = nullptr;
   }
 
-  if (data != nullptr) {
-    if (m_isVerbose)
-      std::cerr << "Data: " << *data << std::endl;
+  if (data != nullptr)
+    sendSegment(segmentNo, *data);
+}
+
+void
+Producer::sendSegment(uint64_t segmentNo, const Data& data)
+{
+  if (m_isVerbose)
+    std::cerr << "Data: " << data << std::endl;
 
-    m_face.put(*data);
+  if (m_mappedStore != nullptr) {
+    m_face.put(data);
+  }
+  else {
+    // the Data carries no tags, so its wire is sent as is, as Face::put would do;
+    // onInterest is invoked by the Face, whose Transport is already connected
+    BOOST_ASSERT(segmentNo < m_wireStore.size());
+    const Block& wire = m_wireStore[segmentNo];
+    if (wire.size() > MAX_NDN_PACKET_SIZE)
+      throw Face::Error("Data size exceeds maximum limit");
 
-    tracepoint(chunksLog, data_sent, segmentNo, data->getContent().size());
+    m_face.getTransport()->send(wire);
   }
+
+  tracepoint(chunksLog, data_sent, segmentNo, data.getContent().size());
+}
+
+uint64_t
+Producer::getNSegments() const
+{
+  return m_mappedStore != nullptr ? m_mappedStore->getNSegments() : m_store.size();
+}
+
+shared_ptr<Data>
+Producer::getSegment(uint64_t segmentNo)
+{
+  if (m_mappedStore != nullptr)
+    return m_mappedStore->getSegment(segmentNo);
+
+  return segmentNo < m_store.size() ? m_store[segmentNo] : nullptr;
 }
 
 void
-Producer::populateStore(std::istream& is)
+Producer::populateStore(std::istream& is, const SigningOptions& signingOptions)
 {
   BOOST_ASSERT(m_store.size() == 0);
 
@@ -150,11 +260,102 @@ Producer::populateStore(std::istream& is)
   auto finalBlockId = name::Component::fromSegment(m_store.size() - 1);
   for (const auto& data : m_store) {
     data->setFinalBlockId(finalBlockId);
-    m_keyChain.sign(*data, m_signingInfo);
   }
 
-  if (m_isVerbose)
+  bool isDigestSigning = signingOptions.wantManifest ||
+                         m_signingInfo.getSignerType() == security::SigningInfo::SIGNER_TYPE_SHA256;
+  size_t nSigningThreads = isDigestSigning ? 1 : std::min(signingOptions.nThreads, m_store.size());
+  auto startTime = time::steady_clock::now();
+
+  if (isDigestSigning) {
+    signStoreWithSha256(signingOptions.wantManifest);
+  }
+  else if (nSigningThreads > 1) {
+    signStore(nSigningThreads, signingOptions.makeKeyChain);
+  }
+  else {
+    for (const auto& data : m_store) {
+      m_keyChain.sign(*data, m_signingInfo);
+    }
+  }
+
+  // the wire of each Data has been encoded when it was signed, the Blocks share its buffer
+  m_wireStore.reserve(m_store.size());
+  for (const auto& data : m_store) {
+    m_wireStore.push_back(data->wireEncode());
+  }
+
+  if (m_isVerbose) {
+    auto signingTime = time::duration_cast<time::microseconds>(time::steady_clock::now() -
+                                                                startTime);
+    double seconds = static_cast<double>(signingTime.count()) / 1000000;
     std::cerr << "Created " << m_store.size() << " chunks for prefix " << m_prefix << std::endl;
+    if (!m_manifest.empty())
+      std::cerr << "Created " << m_manifest.size() << " manifest chunks" << std::endl;
+    std::cerr << "Signed in " << signingTime.count() / 1000.0 << " ms with " << nSigningThreads
+              << (nSigningThreads > 1 ? " threads" : " thread");
+    if (seconds > 0)
+      std::cerr << " (" << m_store.size() / seconds << " chunks/s)";
+    std::cerr << std::endl;
+  }
+}
+
+void
+Producer::signStoreWithSha256(bool wantManifest)
+{
+  auto leaves = signWithSha256(m_store);
+  if (!wantManifest)
+    return;
+
+  m_manifest = MerkleManifest::makeSegments(m_versionedPrefix, leaves, m_maxSegmentSize,
+                                            m_freshnessPeriod);
+  // only the segment with the Merkle root needs a signature from the key
+  m_keyChain.sign(*m_manifest.front(), m_signingInfo);
+  signWithSha256(std::vector<shared_ptr<Data>>(m_manifest.begin() + 1, m_manifest.end()));
+
+  m_manifestWire.reserve(m_manifest.size());
+  for (const auto& data : m_manifest) {
+    m_manifestWire.push_back(data->wireEncode());
+  }
+}
+
+void
+Producer::signStore(size_t nThreads, const KeyChainFactory& makeKeyChain)
+{
+  BOOST_ASSERT(nThreads > 1 && nThreads <= m_store.size());
+  BOOST_ASSERT(makeKeyChain != nullptr);
+
+  // the KeyChains are created on this thread, the factory does not need to be thread-safe
+  std::vector<unique_ptr<KeyChain>> keyChains;
+  for (size_t i = 0; i < nThreads; ++i)
+    keyChains.push_back(makeKeyChain());
+
+  std::vector<std::exception_ptr> errors(nThreads);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i < nThreads; ++i) {
+    // the first (size % nThreads) ranges have one more segment
+    size_t end = begin + m_store.size() / nThreads + (i < m_store.size() % nThreads ? 1 : 0);
+    threads.emplace_back([this, &keyChains, &errors, i, begin, end] {
+      try {
+        for (size_t segNo = begin; segNo < end; ++segNo)
+          keyChains[i]->sign(*m_store[segNo], m_signingInfo);
+      }
+      catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+    begin = end;
+  }
+  BOOST_ASSERT(begin == m_store.size());
+
+  for (auto& thread : threads)
+    thread.join();
+
+  for (const auto& error : errors) {
+    if (error != nullptr)
+      std::rethrow_exception(error);
+  }
 }
 
 void
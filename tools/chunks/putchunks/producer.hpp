@@ -29,6 +29,8 @@
 #define NDN_TOOLS_CHUNKS_PUTCHUNKS_PRODUCER_HPP
 
 #include "core/common.hpp"
+#include "mapped-file-store.hpp"
+#include "../common/merkle-manifest.hpp"
 
 namespace ndn {
 namespace chunks {
@@ -39,10 +41,18 @@ namespace chunks {
  * Packetizes and publishes data from an input stream under /prefix/<version>/<segment number>.
  * The current time is used as the version number. The store has always at least one element (also
  * with empty input stream).
+ *
+ * The input can also be a file, which is mapped in memory and packetized on demand by a
+ * MappedFileStore instead of being loaded and signed before publishing it.
+ *
+ * The segments of the input stream can be signed with DigestSha256 and authenticated by a
+ * MerkleManifest, published under /prefix/<version>/_manifest/<segment number>.
  */
 class Producer : noncopyable
 {
 public:
+  typedef function<unique_ptr<KeyChain>()> KeyChainFactory;
+
   /**
    * @brief Create the Producer
    *
@@ -54,6 +64,45 @@ public:
            size_t maxSegmentSize, bool isVerbose = false, bool needToPrintVersion = false,
            std::istream& is = std::cin);
 
+  /**
+   * @brief how the segments read from the input stream are signed
+   */
+  class SigningOptions
+  {
+  public:
+    SigningOptions();
+
+  public:
+    size_t nThreads;              ///< number of signing threads, at least 1
+    KeyChainFactory makeKeyChain; ///< creates the KeyChain of each signing thread, if more than 1
+    bool wantManifest;            ///< sign with DigestSha256 and publish a Merkle manifest
+  };
+
+  /**
+   * @brief Create the Producer, signing the segments of the input stream as in @p signingOptions
+   *
+   * With more than one signing thread, @p signingOptions.makeKeyChain is called once for each
+   * thread, otherwise the segments are signed with @p keyChain. If the segments are signed with
+   * DigestSha256, either because of @p signingInfo or because a manifest is wanted, the digests
+   * are computed together by the multi-buffer SHA-256 on the calling thread. The manifest
+   * segment 0 is signed with @p keyChain and @p signingInfo.
+   */
+  Producer(const Name& prefix, Face& face, KeyChain& keyChain,
+           const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+           size_t maxSegmentSize, const SigningOptions& signingOptions,
+           bool isVerbose = false, bool needToPrintVersion = false, std::istream& is = std::cin);
+
+  /**
+   * @brief Create the Producer of the content of the file at @p inputFile
+   *
+   * @param cacheSize the maximum number of signed segments kept in memory
+   * @throw MappedFileStore::Error the file cannot be mapped
+   */
+  Producer(const Name& prefix, Face& face, KeyChain& keyChain,
+           const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+           size_t maxSegmentSize, const std::string& inputFile, size_t cacheSize,
+           bool isVerbose = false, bool needToPrintVersion = false);
+
   /**
    * @brief Run the Producer
    */
@@ -61,27 +110,77 @@ public:
   run();
 
 private:
+  void
+  setPrefix(const Name& prefix);
+
+  /**
+   * @brief register the prefix and start answering the Interests
+   */
+  void
+  publish(const Name& prefix, bool needToPrintVersion);
+
   void
   onInterest(const Interest& interest);
 
+  uint64_t
+  getNSegments() const;
+
+  /**
+   * @return the Data of @p segmentNo, or nullptr if there is no such segment
+   */
+  shared_ptr<Data>
+  getSegment(uint64_t segmentNo);
+
+  /**
+   * @brief send the segment @p segmentNo, which must exist
+   *
+   * The segments of the store are sent directly on the Transport from their pre-encoded wire.
+   * Face::put would reuse the cached wire as well, but it copies the Data into a shared_ptr
+   * and defers the send to a handler posted on the io_service for each request.
+   *
+   * @throw Face::Error the Data is larger than MAX_NDN_PACKET_SIZE, as Face::put would do
+   */
+  void
+  sendSegment(uint64_t segmentNo, const Data& data);
+
   /**
    * @brief Split the input stream in data packets and save them to the store
    *
    * Create data packets reading all the characters from the input stream until EOF, or an
    * error occurs. Each data packet has a maximum payload size of m_maxSegmentSize value and is
    * stored inside the vector m_store. An empty data packet is created and stored if the input
-   * stream is empty.
+   * stream is empty. The data packets are then signed as requested by @p signingOptions.
    *
    * @return Number of data packets contained in the store after the operation
    */
   void
-  populateStore(std::istream& is);
+  populateStore(std::istream& is, const SigningOptions& signingOptions);
+
+  /**
+   * @brief Sign the segments in the store, splitting them in contiguous ranges among
+   *        @p nThreads threads that sign with a KeyChain of their own
+   *
+   * @throw the first exception thrown by a signing thread, after all threads have been joined
+   */
+  void
+  signStore(size_t nThreads, const KeyChainFactory& makeKeyChain);
+
+  /**
+   * @brief Sign the segments in the store with DigestSha256 and create their manifest if
+   *        @p wantManifest
+   */
+  void
+  signStoreWithSha256(bool wantManifest);
 
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::vector<shared_ptr<Data>> m_store;
+  std::vector<Block> m_wireStore; ///< encoded and signed wire of each Data in m_store
+  unique_ptr<MappedFileStore> m_mappedStore; ///< replaces m_store when publishing a file
+  std::vector<shared_ptr<Data>> m_manifest; ///< the Merkle manifest of m_store, if wanted
+  std::vector<Block> m_manifestWire;
 
 private:
   Name m_prefix;
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#include "streaming-producer.hpp"
+
+#include "../chunks-tracepoint.hpp"
+
+namespace ndn {
+namespace chunks {
+
+StreamingProducer::StreamingProducer(const Name& prefix,
+                                     Face& face,
+                                     const KeyChainFactory& makeKeyChain,
+                                     const security::SigningInfo& signingInfo,
+                                     time::milliseconds freshnessPeriod,
+                                     size_t maxSegmentSize,
+                                     bool isVerbose,
+                                     bool needToPrintVersion,
+                                     std::istream& is)
+  : m_isEof(false)
+  , m_face(face)
+  , m_isVerbose(isVerbose)
+{
+  if (prefix.size() > 0 && prefix[-1].isVersion()) {
+    m_prefix = prefix.getPrefix(-1);
+    m_versionedPrefix = prefix;
+  }
+  else {
+    m_prefix = prefix;
+    m_versionedPrefix = Name(m_prefix).appendVersion();
+  }
+
+  if (needToPrintVersion)
+    std::cout << m_versionedPrefix[-1] << std::endl;
+
+  m_face.setInterestFilter(m_prefix,
+                           bind(&StreamingProducer::onInterest, this, _2),
+                           RegisterPrefixSuccessCallback(),
+                           bind(&StreamingProducer::onRegisterFailed, this, _1, _2));
+
+  std::ostringstream sign;
+  sign << signingInfo;
+
+  // the number of segments is not known yet
+  tracepoint(chunksLog, put_started, prefix.toUri().c_str(), sign.str().c_str(),
+             freshnessPeriod.count(), maxSegmentSize, 0);
+
+  if (m_isVerbose)
+    std::cerr << "Streaming data with name: " << m_versionedPrefix << std::endl;
+
+  m_readerState.reset(new ReaderState{this, m_face.getIoService(), m_versionedPrefix, signingInfo,
+                                      freshnessPeriod, maxSegmentSize, makeKeyChain(),
+                                      {}, false});
+  m_reader = std::thread(&StreamingProducer::readStream, m_readerState, std::ref(is));
+}
+
+StreamingProducer::~StreamingProducer()
+{
+  std::lock_guard<std::mutex> lock(m_readerState->mutex);
+  m_readerState->producer = nullptr;
+
+  // a thread blocked reading the stream cannot be interrupted
+  if (m_readerState->isFinished)
+    m_reader.join();
+  else
+    m_reader.detach();
+}
+
+void
+StreamingProducer::run()
+{
+  m_face.processEvents();
+}
+
+void
+StreamingProducer::readStream(const shared_ptr<ReaderState>& state, std::istream& is)
+{
+  std::vector<uint8_t> buffer(state->maxSegmentSize);
+  uint64_t segmentNo = 0;
+  bool isLast = false;
+
+  while (!isLast) {
+    is.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    const auto nCharsRead = is.gcount();
+
+    // the segment is published when the next character is available, or the stream ends,
+    // so that the last segment is known before signing it
+    isLast = !is.good() || is.peek() == std::istream::traits_type::eof();
+
+    if (nCharsRead == 0 && !(isLast && segmentNo == 0))
+      break;
+
+    {
+      // do not sign a segment that will never be published
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->producer == nullptr)
+        return;
+    }
+
+    auto data = make_shared<Data>(Name(state->versionedPrefix).appendSegment(segmentNo));
+    data->setFreshnessPeriod(state->freshnessPeriod);
+    data->setContent(buffer.data(), nCharsRead);
+    if (isLast)
+      data->setFinalBlockId(name::Component::fromSegment(segmentNo));
+
+    state->keyChain->sign(*data, state->signingInfo);
+    data->wireEncode();
+    ++segmentNo;
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->producer == nullptr)
+      return;
+
+    state->io.post([state, data, isLast] {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->producer != nullptr)
+        state->producer->onSegmentRead(data, isLast);
+    });
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->isFinished = true;
+}
+
+void
+StreamingProducer::onSegmentRead(const shared_ptr<Data>& data, bool isLast)
+{
+  uint64_t segmentNo = m_store.size();
+  BOOST_ASSERT(data->getName()[-1].toSegment() == segmentNo);
+
+  m_store.push_back(data);
+  m_wireStore.push_back(data->wireEncode());
+  m_isEof = isLast;
+
+  auto now = time::steady_clock::now();
+  auto range = m_pendingInterests.equal_range(segmentNo);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.expiry > now && it->second.interest.matchesData(*data)) {
+      sendSegment(segmentNo);
+      // the forwarder satisfies all the Interests pending for this Data with a single copy
+      break;
+    }
+  }
+  m_pendingInterests.erase(range.first, range.second);
+
+  if (m_isEof) {
+    // these segments will never exist
+    m_pendingInterests.clear();
+
+    if (m_isVerbose)
+      std::cerr << "Created " << m_store.size() << " chunks for prefix " << m_prefix << std::endl;
+  }
+}
+
+void
+StreamingProducer::onInterest(const Interest& interest)
+{
+  if (m_isVerbose)
+    std::cerr << "Interest: " << interest << std::endl;
+
+  const Name& name = interest.getName();
+  uint64_t segmentNo = 0;
+
+  // is this a discovery Interest or a sequence retrieval?
+  if (name.size() == m_versionedPrefix.size() + 1 && m_versionedPrefix.isPrefixOf(name) &&
+      name[-1].isSegment()) {
+    segmentNo = name[-1].toSegment();
+  }
+  // otherwise the Interest has version and is looking for the first segment or has no version
+
+  if (segmentNo < m_store.size()) {
+    if (interest.matchesData(*m_store[segmentNo]))
+      sendSegment(segmentNo);
+    return;
+  }
+
+  if (m_isEof)
+    return;
+
+  auto now = time::steady_clock::now();
+  auto range = m_pendingInterests.equal_range(segmentNo);
+  for (auto it = range.first; it != range.second;) {
+    // drop the retransmitted Interests that have expired
+    if (it->second.expiry <= now)
+      it = m_pendingInterests.erase(it);
+    else
+      ++it;
+  }
+  m_pendingInterests.emplace(segmentNo,
+                             PendingInterest{interest, now + interest.getInterestLifetime()});
+}
+
+void
+StreamingProducer::sendSegment(uint64_t segmentNo)
+{
+  const Data& data = *m_store[segmentNo];
+  if (m_isVerbose)
+    std::cerr << "Data: " << data << std::endl;
+
+  // the Data carries no tags, so its wire is sent as is, as Face::put would do
+  m_face.getTransport()->send(m_wireStore[segmentNo]);
+
+  tracepoint(chunksLog, data_sent, segmentNo, data.getContent().size());
+}
+
+void
+StreamingProducer::onRegisterFailed(const Name& prefix, const std::string& reason)
+{
+  std::cerr << "ERROR: Failed to register prefix '"
+            << prefix << "' (" << reason << ")" << std::endl;
+  m_face.shutdown();
+}
+
+} // namespace chunks
+} // namespace ndn
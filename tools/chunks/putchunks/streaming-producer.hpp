@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Andrea Tosatto
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_STREAMING_PRODUCER_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_STREAMING_PRODUCER_HPP
+
+#include "core/common.hpp"
+
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Segmented version Producer that publishes the input stream while reading it
+ *
+ * The input stream is read and signed on a separate thread, and each segment is published under
+ * /prefix/<version>/<segment number> as soon as it has been signed. The Interests for the
+ * segments that have not been read yet are kept in a pending Interest table, and answered when
+ * the segments become available. Only the last segment, which is known when the end of the
+ * stream is reached, has the FinalBlockId.
+ *
+ * Every segment is kept in memory until the producer is destroyed, so that the whole stream can
+ * be retrieved: the memory used grows with the length of the stream.
+ */
+class StreamingProducer : noncopyable
+{
+public:
+  typedef function<unique_ptr<KeyChain>()> KeyChainFactory;
+
+  /**
+   * @brief Create the Producer and start reading @p is
+   *
+   * The segments are signed on the reading thread with a KeyChain created by @p makeKeyChain,
+   * which is owned by the reading thread. The reading thread is detached if it is still blocked
+   * reading the stream when the producer is destroyed, in that case @p is must remain valid
+   * until the process exits.
+   */
+  StreamingProducer(const Name& prefix, Face& face, const KeyChainFactory& makeKeyChain,
+                    const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+                    size_t maxSegmentSize, bool isVerbose = false, bool needToPrintVersion = false,
+                    std::istream& is = std::cin);
+
+  ~StreamingProducer();
+
+  /**
+   * @brief Run the Producer
+   */
+  void
+  run();
+
+private:
+  struct ReaderState;
+
+  /**
+   * @brief read, packetize and sign the input stream, on the reading thread
+   *
+   * The segments are passed to onSegmentRead on the thread of the Face, unless the producer
+   * has been destroyed in the meantime.
+   */
+  static void
+  readStream(const shared_ptr<ReaderState>& state, std::istream& is);
+
+  /**
+   * @brief publish a segment that has been read, and answer its pending Interests
+   */
+  void
+  onSegmentRead(const shared_ptr<Data>& data, bool isLast);
+
+  void
+  onInterest(const Interest& interest);
+
+  void
+  sendSegment(uint64_t segmentNo);
+
+  void
+  onRegisterFailed(const Name& prefix, const std::string& reason);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  struct PendingInterest
+  {
+    Interest interest;
+    time::steady_clock::TimePoint expiry;
+  };
+
+  std::vector<shared_ptr<Data>> m_store;
+  std::vector<Block> m_wireStore; ///< encoded and signed wire of each Data in m_store
+  std::multimap<uint64_t, PendingInterest> m_pendingInterests; ///< indexed by segment number
+  bool m_isEof;
+
+private:
+  /**
+   * @brief the state shared with the reading thread, which can outlive the producer
+   */
+  struct ReaderState
+  {
+    StreamingProducer* producer; ///< nullptr after the producer has been destroyed
+    boost::asio::io_service& io;
+    Name versionedPrefix;
+    security::SigningInfo signingInfo;
+    time::milliseconds freshnessPeriod;
+    size_t maxSegmentSize;
+    unique_ptr<KeyChain> keyChain;
+
+    std::mutex mutex; ///< protects producer and isFinished
+    bool isFinished;
+  };
+
+  Name m_prefix;
+  Name m_versionedPrefix;
+  Face& m_face;
+  bool m_isVerbose;
+
+  shared_ptr<ReaderState> m_readerState;
+  std::thread m_reader;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_STREAMING_PRODUCER_HPP
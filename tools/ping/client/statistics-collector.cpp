@@ -36,6 +36,7 @@ StatisticsCollector::StatisticsCollector(Ping& ping, const Options& options)
   , m_maxRtt(0.0)
   , m_sumRtt(0.0)
   , m_sumRttSquared(0.0)
+  , m_rttHistogram(3600000000) // one hour
 {
   m_ping.afterResponse.connect(bind(&StatisticsCollector::recordResponse, this, _2));
   m_ping.afterTimeout.connect(bind(&StatisticsCollector::recordTimeout, this));
@@ -55,6 +56,8 @@ StatisticsCollector::recordResponse(Rtt rtt)
 
   m_sumRtt += rttMs;
   m_sumRttSquared += rttMs * rttMs;
+
+  m_rttHistogram.record(static_cast<uint64_t>(rttMs * 1000));
 }
 
 void
@@ -78,6 +81,9 @@ StatisticsCollector::computeStatistics()
   statistics.sumRtt = m_sumRtt;
   statistics.avgRtt = m_sumRtt / m_nReceived;
   statistics.stdDevRtt = std::sqrt((m_sumRttSquared / m_nReceived) - (statistics.avgRtt * statistics.avgRtt));
+  statistics.p50Rtt = m_rttHistogram.getValueAtPercentile(50) / 1000.0;
+  statistics.p99Rtt = m_rttHistogram.getValueAtPercentile(99) / 1000.0;
+  statistics.p999Rtt = m_rttHistogram.getValueAtPercentile(99.9) / 1000.0;
 
   return statistics;
 }
@@ -87,7 +93,8 @@ Statistics::printSummary(std::ostream& os) const
 {
   os << nReceived << "/" << nSent << " packets, " << packetLossRate * 100.0
      << "% loss, min/avg/max/mdev = " << minRtt << "/" << avgRtt << "/" << maxRtt << "/"
-     << stdDevRtt << " ms" << std::endl;
+     << stdDevRtt << " ms, p50/p99/p99.9 = " << p50Rtt << "/" << p99Rtt << "/" << p999Rtt
+     << " ms" << std::endl;
 
   return os;
 }
@@ -108,6 +115,11 @@ operator<<(std::ostream& os, const Statistics& statistics)
     os << statistics.avgRtt << "/";
     os << statistics.maxRtt << "/";
     os << statistics.stdDevRtt << " ms";
+    os << "\n";
+    os << "rtt p50/p99/p99.9 = ";
+    os << statistics.p50Rtt << "/";
+    os << statistics.p99Rtt << "/";
+    os << statistics.p999Rtt << " ms";
   }
 
   return os;
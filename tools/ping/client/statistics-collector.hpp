@@ -24,6 +24,7 @@
 #define NDN_TOOLS_PING_CLIENT_STATISTICS_COLLECTOR_HPP
 
 #include "core/common.hpp"
+#include "core/hdr-histogram.hpp"
 
 #include "ping.hpp"
 
@@ -46,6 +47,9 @@ struct Statistics
   double sumRtt;                                //!< sum of round trip times
   double avgRtt;                                //!< average round trip time
   double stdDevRtt;                             //!< std dev of round trip time
+  double p50Rtt;                                //!< median round trip time
+  double p99Rtt;                                //!< 99th percentile of round trip time
+  double p999Rtt;                               //!< 99.9th percentile of round trip time
 
   std::ostream&
   printSummary(std::ostream& os) const;
@@ -94,6 +98,7 @@ private:
   double m_maxRtt;
   double m_sumRtt;
   double m_sumRttSquared;
+  tools::HdrHistogram m_rttHistogram; ///< round trip times in microseconds
 };
 
 std::ostream&